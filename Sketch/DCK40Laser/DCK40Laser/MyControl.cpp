@@ -134,9 +134,17 @@ void CMyControl::IOControl(uint8_t tool, uint16_t level)
 		case SpindleCCW:
 		case SpindleCW:
 
+			// M4 => dynamic laser power: scaled with speed in OnSpeedEvent (idle poll) => no darker corners while decelerating
+			_laserDynamic = tool == SpindleCCW;
+			CStepper::GetInstance()->SetSpeedEvent(_laserDynamic);
+
 			if (level != 0)
 			{
 				_laserPWM.On(uint8_t(level));
+				if (_laserDynamic)
+				{
+					_laserPWM.OnScaled(CStepper::GetInstance()->GetSpeedLevel()); // OnSpeedEvent is called on the next change only
+				}
 				_laserOnOff.On();
 			}
 			else
@@ -266,11 +274,19 @@ bool CMyControl::OnEvent(EnumAsByte(EStepperControlEvent) eventType, uintptr_t a
 				const bool newIsCutMove = addInfo != 0;
 				if (CGCodeParserBase::IsCutMove() != newIsCutMove)
 				{
-					CStepper::GetInstance()->IoControl(CControl::SpindleCW, newIsCutMove ? CGCodeParserBase::GetSpindleSpeed() : 0);
+					CStepper::GetInstance()->MoveIoControl(CGCodeParserBase::IsSpindleOnCW() ? CControl::SpindleCW : CControl::SpindleCCW, newIsCutMove ? CGCodeParserBase::GetSpindleSpeed() : 0);
 				}
 			}
 			break;
 		}
+		case OnSpeedEvent:
+		{
+			if (_laserDynamic)
+			{
+				_laserPWM.OnScaled(uint8_t(addInfo));
+			}
+			break;
+		}
 		case OnStartEvent:
 		{
 			_laserWater.On();
@@ -76,6 +76,8 @@ private:
 	ControlData _data;
 
 
+	bool _laserDynamic = false;		// M4: laser power relative to speed (OnSpeedEvent)
+
 	CAnalog8IOControl<LASER_PWM_PIN>                                             _laserPWM;
 	COnOffIOControl<LASER_ENABLE_PIN, LASER_ENABLE_PIN_ON, LASER_ENABLE_PIN_OFF> _laserOnOff;
 
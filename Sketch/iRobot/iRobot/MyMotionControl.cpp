@@ -63,13 +63,20 @@
 
 #define ANGLE3OFFSET DEFAULTANGLE
 
-#define SPLITMOVEDIST	10000
+// split where the servo path (linear in ms) leaves the line by more than SPLITMOVETOLERANCE, see CKinematics
+
+#define SPLITMOVETOLERANCE	400			// mm1000, resolution of servo (1/1400 PI) is ~0.35mm at max reach
+#define SPLITMOVEMAXDIST	80000		// midpoint test only: S-shaped deviation is not detected
 
 #define MY_PI	float(M_PI)
 
 /////////////////////////////////////////////////////////
 
-CMyMotionControl::CMyMotionControl() {}
+CMyMotionControl::CMyMotionControl()
+{
+	_myKinematics.SetSplit(SPLITMOVETOLERANCE, SPLITMOVEMAXDIST, 0);
+	SetKinematics(&_myKinematics);
+}
 
 /////////////////////////////////////////////////////////
 
@@ -134,42 +141,34 @@ void CMyMotionControl::AdjustFromAngle(float angle[NUM_AXIS])
 
 /////////////////////////////////////////////////////////
 
-void CMyMotionControl::TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+bool CMyMotionControl::CMyKinematics::ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const
 {
-	super::TransformFromMachinePosition(src, dest);
-
 	float angle[NUM_AXIS];
 
+	if (!ToAngle(pos, angle))
+		return false;
+
+	AdjustToAngle(angle);
+
 	for (axis_t i = 0; i < SEGMENTCOUNT; i++)
-		angle[i]  = FromMs(dest[i], i);
+	{
+		joint[i] = ToMs(angle[i], X_AXIS);
+	}
 
-	AdjustFromAngle(angle);
-	FromAngle(angle, dest);
+	return true;
 }
 
 /////////////////////////////////////////////////////////
 
-bool CMyMotionControl::TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+void CMyMotionControl::CMyKinematics::FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const
 {
 	float angle[NUM_AXIS];
 
-	if (!super::TransformPosition(src, dest))
-		return false;
-
-	if (!ToAngle(dest, angle))
-	{
-		Error(F("TransformPosition: geometry"));
-		return false;
-	}
-
-	AdjustToAngle(angle);
-
 	for (axis_t i = 0; i < SEGMENTCOUNT; i++)
-	{
-		dest[i] = ToMs(angle[i], X_AXIS);
-	}
+		angle[i]  = FromMs(joint[i], i);
 
-	return true;
+	AdjustFromAngle(angle);
+	FromAngle(angle, pos);
 }
 
 /////////////////////////////////////////////////////////
@@ -264,51 +263,6 @@ bool CMyMotionControl::FromAngle(const float angle[NUM_AXIS], mm1000_t dest[NUM_
 
 /////////////////////////////////////////////////////////
 
-void CMyMotionControl::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedRate)
-{
-	uint16_t moveCount = 1;
-	mm1000_t nextTo[NUM_AXIS];
-	mm1000_t totalDist[NUM_AXIS];
-
-	mm1000_t       maxDist   = 0;
-	const mm1000_t splitDist = SPLITMOVEDIST;
-
-	axis_t i;
-
-	for (i = 0; i < NUM_AXIS; i++)
-	{
-		mm1000_t dist = to[i] - _current[i];
-		totalDist[i]  = dist;
-
-		if (dist < 0) dist = -dist;
-		if (dist > maxDist)
-			maxDist = dist;
-	}
-
-	if (maxDist > splitDist)
-	{
-		moveCount = uint16_t(maxDist / splitDist);
-		if ((maxDist % splitDist) != 0)
-			moveCount++;
-	}
-
-	for (uint16_t j = moveCount - 1; j > 0; j--)
-	{
-		for (i = 0; i < NUM_AXIS; i++)
-		{
-			mm1000_t nextPos = RoundMulDivI32(totalDist[i], j, moveCount);
-			nextTo[i]        = to[i] - nextPos;
-		}
-
-		super::MoveAbs(nextTo, feedRate);
-		if (IsError()) return;
-	}
-
-	super::MoveAbs(to, feedRate);
-}
-
-/////////////////////////////////////////////////////////
-
 void CMyMotionControl::MoveAngle(const mm1000_t dest[NUM_AXIS])
 {
 	udist_t to[NUM_AXIS] = { 0 };
@@ -36,17 +36,25 @@ public:
 
 	void         MoveAngle(const mm1000_t    dest[NUM_AXIS]);
 	void         MoveAngleLog(const mm1000_t dest[NUM_AXIS]);
-	virtual void MoveAbs(const mm1000_t      to[NUM_AXIS], feedrate_t feedRate) override;
 
 protected:
 
-	virtual void TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
-	virtual bool TransformPosition(const mm1000_t           src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
-
 	steprate_t GetStepRate(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], feedrate_t feedrate) const override;
 
 private:
 
+	// xyz <=> servo position (ms), moves are split by CMotionControlBase
+
+	class CMyKinematics : public CKinematics
+	{
+	public:
+
+		virtual bool ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const override;
+		virtual void FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const override;
+	};
+
+	CMyKinematics _myKinematics;
+
 	static bool ToAngle(const mm1000_t pos[NUM_AXIS], float      angle[NUM_AXIS]);
 	static bool FromAngle(const float  angle[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
 
@@ -199,7 +199,7 @@ public:
 		uint32_t MoveAwayFromReference;
 
 		uint16_t StepperOffTimeout;
-		uint16_t Dummy16_2;
+		uint16_t ArcChordError;		// max deviation (mm1000) of a chord from the arc (G2/G3), 0 => ARC_CHORDERROR
 
 		uint16_t Dummy16_3;
 		uint16_t Dummy16_4;
@@ -48,13 +48,21 @@ typedef int32_t inch100000_t; // 1/100000 inch
 // GCode Parser
 
 #define NUM_MAXPARAMNAMELENGTH 16
-#define NUM_PARAMETERRANGE	255
+#define NUM_PARAMETERRANGE	5000		// user parameter #1 .. #5000
+#define CUTTERRADIUS_QUEUESIZE	4		// look ahead of cutter radius compensation (G41/G42), see CCutterRadiusCompensation
 
-#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(_MSC_VER) || defined(ESP32)
+#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(_MSC_VER) || defined(__linux__) || defined(ESP32)
 
-#define NUM_PARAMETER	16		// slotCount, map from uint8_t to < NUM_PARAMETER
+#define NUM_PARAMETER	64		// slotCount of hash table for user parameter (2^x, max 128)
 #define G54ARRAYSIZE	6
 
+#define EXPRPARSER_CACHESIZE	8		// compiled expressions (bytecode) of the gcode parser, see CExpressionParser
+
+#define OWORD_PROGRAMSIZE	4096	// memory for lines of O-word subs and blocks (loops, if), see CGCodeParser
+#define OWORD_MAXSUB		16		// number of O-word subs
+#define OWORD_MAXDEPTH		8		// nesting of O-word blocks and calls
+#define OWORD_MAXARG		32		// arguments of all active O-word calls (the values of #1, #2, ... of the caller are saved)
+
 #else
 
 #define NUM_PARAMETER	8
@@ -62,12 +70,46 @@ typedef int32_t inch100000_t; // 1/100000 inch
 
 #endif
 
+////////////////////////////////////////////////////////
+// MotionControl
+
+#define ARC_CHORDERROR		2			// default max deviation (mm1000) of a chord from the arc (G2/G3), see CConfigEeprom::SCNCEeprom::ArcChordError
+
+// ARC_BACKGROUND: G2/G3 is one pending arc, the chords are added while the movement queue can take them (see CMotionControlBase::ArcPoll)
+//                 the parser returns before the arc is queued, but each chord still uses one entry of the movement queue
+//                 => a small radius with a high feed still limits the look ahead, not enabled by default
+
+//#define ARC_BACKGROUND
+
+#ifndef REDUCED_SIZE
+
+#define KINEMATICS						// non-cartesian machines (delta, SCARA), see CKinematics and CMotionControlBase::SetKinematics
+
+#endif
+
+#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(__AVR_ARCH__)
+
+#define KINEMATICS_FIXEDPOINT			// no FPU: inverse kinematics in fixed point (if possible), see CDeltaKinematics
+
+#endif
+
+#define KINEMATICS_SPLITTOLERANCE	20		// default max deviation (mm1000) of a split move from the line, see CKinematics::SetSplit
+#define KINEMATICS_SPLITMAXDIST		50000	// default max length (mm1000) of a segment
+#define KINEMATICS_SPLITMAXDEPTH	6		// midpoint test: min length of a segment is 1/64 of a piece (max KINEMATICS_SPLITMAXDIST or time)
+
 ////////////////////////////////////////////////////////
 //
 // Control
 
 #define SERIALBUFFERSIZE	128			// even size 
 
+#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(_MSC_VER) || defined(__linux__) || defined(ESP32)
+
+#define SERIALRXBUFFERSIZE	256			// 2^n, receive ring buffer for streaming (lines are read while a command waits), see CControl::FillRxBuffer and M113
+#define SERIALRXHEADROOM	16			// not reported as free ("ok RX:n"), the buffer is never full of lines => real-time commands are read while a command waits
+
+#endif
+
 #define TIMEOUTCALLIDLE		333			// time in ms after move completed to call Idle
 #define TIMEOUTCALLPOLL		500			// time in ms to call Poll() next if not idle => ASSERT( TIMEOUTCALLPOLL > TIMEOUTCALLIDLE)
 
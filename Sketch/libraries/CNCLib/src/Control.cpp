@@ -35,6 +35,10 @@ template <> CControl* CSingleton<CControl>::_instance = nullptr;
 CControl::CControl()
 {
 	_bufferIdx = 0;
+#ifdef SERIALRXBUFFERSIZE
+	_charCounting = false;
+	_serialPoll   = false;
+#endif
 }
 
 ////////////////////////////////////////////////////////////
@@ -90,6 +94,12 @@ void CControl::InitFromEeprom()
 
 	CStepper::GetInstance()->SetEnableTimeout(CConfigEeprom::GetConfigU16(offsetof(CConfigEeprom::SCNCEeprom, StepperOffTimeout)));
 
+	uint16_t arcChordError = CConfigEeprom::GetConfigU16(offsetof(CConfigEeprom::SCNCEeprom, ArcChordError));
+	if (arcChordError != 0)
+	{
+		CMotionControlBase::GetInstance()->SetArcChordError(arcChordError);
+	}
+
 	uint16_t jerkspeed = CConfigEeprom::GetConfigU16(offsetof(CConfigEeprom::SCNCEeprom, JerkSpeed));
 	if (jerkspeed == 0)
 	{
@@ -215,6 +225,10 @@ void CControl::Resurrect()
 	CStepper::GetInstance()->EmergencyStopResurrect();
 	CMotionControlBase::GetInstance()->SetPositionFromMachine();
 
+#ifndef REDUCED_SIZE
+	CGCodeParser::Abort();
+#endif
+
 #ifdef _USE_LCD
 
 	if (CLcd::GetInstance())
@@ -290,7 +304,7 @@ bool CControl::ParseAndPrintResult(CParser* parser, Stream* output)
 			PrintError(output);
 			output->print(parser->GetError());
 			output->print(MESSAGE_CONTROL_RESULTS);
-			output->print(_buffer);
+			output->print(parser->GetErrorLine() != nullptr ? parser->GetErrorLine() : _buffer);
 			//			output->print(millis());
 		}
 		ret = false;
@@ -298,7 +312,13 @@ bool CControl::ParseAndPrintResult(CParser* parser, Stream* output)
 	else
 	{
 		// => not in "else" if "OK" should be sent after "Error:"
-		if (output) output->print(MESSAGE_OK);
+		if (output)
+		{
+			output->print(MESSAGE_OK);
+#ifdef SERIALRXBUFFERSIZE
+			PrintRxFree(output);
+#endif
+		}
 		if (parser->GetOkMessage() != nullptr)
 		{
 			if (output)
@@ -368,7 +388,11 @@ bool CControl::Command(char* buffer, Stream* output)
 	else if (output)
 	{
 		// send OK on empty line (command)
-		output->println(MESSAGE_OK_EMPTYLINE);
+		output->print(MESSAGE_OK_EMPTYLINE);
+#ifdef SERIALRXBUFFERSIZE
+		PrintRxFree(output);
+#endif
+		output->println();
 	}
 
 	return ret;
@@ -384,6 +408,36 @@ bool CControl::IsEndOfCommandChar(char ch)
 
 ////////////////////////////////////////////////////////////
 
+bool CControl::AddCommandChar(char ch, Stream* output)
+{
+	_buffer[_bufferIdx] = ch;
+
+	if (IsEndOfCommandChar(ch))
+	{
+		_buffer[_bufferIdx] = 0;			// remove from buffer 
+		Command(_buffer, output);
+		_bufferIdx = 0;
+
+		_lastTime = millis();
+
+		return true;
+	}
+
+	_bufferIdx++;
+	if (_bufferIdx >= sizeof(_buffer))
+	{
+		if (output)
+		{
+			PrintError(output);
+			output->println(MESSAGE_CONTROL_FLUSHBUFFER);
+		}
+		_bufferIdx = 0;
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////
+
 void CControl::ReadAndExecuteCommand(Stream* stream, Stream* output, bool fileStream)
 {
 	// call this method if ch is available in stream
@@ -392,36 +446,10 @@ void CControl::ReadAndExecuteCommand(Stream* stream, Stream* output, bool fileSt
 	{
 		while (stream->available() > 0)
 		{
-			char ch = _buffer[_bufferIdx] = stream->read();
-
-			if (IsEndOfCommandChar(ch))
+			if (AddCommandChar(stream->read(), output))
 			{
-				_buffer[_bufferIdx] = 0;			// remove from buffer 
-				Command(_buffer, output);
-				_bufferIdx = 0;
-
-				_lastTime = millis();
-
 				return;
 			}
-
-			_bufferIdx++;
-			if (_bufferIdx >= sizeof(_buffer))
-			{
-				if (output)
-				{
-					PrintError(output);
-					output->println(MESSAGE_CONTROL_FLUSHBUFFER);
-				}
-				_bufferIdx = 0;
-			}
-			/*
-						if (ch == '\x18')
-						{
-							StepperSerial.println(MESSAGE_CTRLX);
-							_bufferIdx = 0;
-						}
-			*/
 		}
 
 		if (fileStream)						// e.g. SD card => execute last line without "EndOfLine"
@@ -441,16 +469,171 @@ void CControl::ReadAndExecuteCommand(Stream* stream, Stream* output, bool fileSt
 
 bool CControl::SerialReadAndExecuteCommand()
 {
+#ifdef SERIALRXBUFFERSIZE
+
+	// execute (max) one command from _rxBuffer, the next lines are received while the command is waiting for the stepper
+
+	FillRxBuffer();
+
+	while (!_rxBuffer.IsEmpty())
+	{
+		char ch = _rxBuffer.Head();
+		_rxBuffer.Dequeue();
+
+		if (AddCommandChar(ch, &StepperSerial))
+		{
+			break;
+		}
+	}
+
+	return _bufferIdx > 0 || !_rxBuffer.IsEmpty();		// command pending, buffer not empty
+
+#else
+
 	if (StepperSerial.available() > 0)
 	{
 		ReadAndExecuteCommand(&StepperSerial, &StepperSerial, false);
 	}
 
 	return _bufferIdx > 0;		// command pending, buffer not empty
+
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+#ifdef SERIALRXBUFFERSIZE
+
+void CControl::FillRxBuffer()
+{
+	if (!_rxBuffer.IsFull() && StepperSerial.available() > 0)
+	{
+		do
+		{
+			char ch = StepperSerial.read();
+			if (!RealtimeCommand(ch))
+			{
+				_rxBuffer.Enqueue(ch);
+			}
+		}
+		while (!_rxBuffer.IsFull() && StepperSerial.available() > 0);
+
+		_lastTime = millis();
+	}
+}
+
+////////////////////////////////////////////////////////
+
+uint16_t CControl::GetRxFree() const
+{
+	// chars in the hardware buffer of serial are already sent by the host
+	// SERIALRXHEADROOM is kept free: FillRxBuffer stops reading if _rxBuffer is full (real-time commands would stay in the hardware buffer)
+
+	int      available = StepperSerial.available();
+	uint16_t rxFree    = _rxBuffer.FreeCount() > SERIALRXHEADROOM ? _rxBuffer.FreeCount() - SERIALRXHEADROOM : 0;
+
+	return available > 0 ? (uint16_t(available) < rxFree ? rxFree - uint16_t(available) : 0) : rxFree;
 }
 
 ////////////////////////////////////////////////////////
 
+void CControl::PrintRxFree(Stream* output)
+{
+	// character counting: host sends lines as long as the sum of unacknowledged chars fit into the receive buffer
+
+	// no FillRxBuffer here: the output of a real-time '?' would be inside the "ok" line
+
+	if (_charCounting && output == &StepperSerial)
+	{
+		output->print(F(" RX:"));
+		output->print(GetRxFree());
+	}
+}
+
+////////////////////////////////////////////////////////
+
+bool CControl::RealtimeCommand(char ch)
+{
+	switch (uint8_t(ch))
+	{
+		case RealtimeReset:
+		{
+			// discard all received lines
+			Kill();
+			_rxBuffer.Clear();
+			_bufferIdx = 0;
+			return true;
+		}
+		case RealtimeSpeedOverride100: CStepper::GetInstance()->SetSpeedOverride(CStepper::SpeedOverride100P);
+			return true;
+		case RealtimeSpeedOverridePlus10: AddSpeedOverride(10);
+			return true;
+		case RealtimeSpeedOverrideMinus10: AddSpeedOverride(-10);
+			return true;
+		case RealtimeSpeedOverridePlus1: AddSpeedOverride(1);
+			return true;
+		case RealtimeSpeedOverrideMinus1: AddSpeedOverride(-1);
+			return true;
+		default: break;
+	}
+
+	if (!_charCounting)
+	{
+		// '?' and '!' are part of commands, e.g. "?" or "!!!" (resurrect)
+		return false;
+	}
+
+	switch (ch)
+	{
+		case RealtimeStatus:
+		{
+#ifdef STEPPER_STATUS
+			CGCodeParserBase::PrintStatus();
+#else
+			CGCodeParserBase::PrintInfo();
+#endif
+			StepperSerial.println();
+			return true;
+		}
+		case RealtimeHold:
+		{
+			if (IsKilled())
+			{
+				return false;			// "!!!"
+			}
+			Hold();
+			return true;
+		}
+		case RealtimeResume: Resume();
+			return true;
+		default: break;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////
+
+void CControl::AddSpeedOverride(int8_t speedP)
+{
+	int16_t newSpeedP = int16_t(CStepper::SpeedOverrideToP(CStepper::GetInstance()->GetSpeedOverride())) + speedP;
+
+	if (newSpeedP < 1)
+	{
+		newSpeedP = 1;
+	}
+	else if (newSpeedP > 199)
+	{
+		newSpeedP = 199;				// SpeedOverrideMax
+	}
+
+	CStepper::GetInstance()->SetSpeedOverride(CStepper::PToSpeedOverride(uint8_t(newSpeedP)));
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 void CControl::FileReadAndExecuteCommand(Stream* stream, Stream* output)
 {
 	ReadAndExecuteCommand(stream, output, true);
@@ -463,6 +646,10 @@ void CControl::Run()
 	_bufferIdx = 0;
 	_lastTime  = _timeBlink = _timePoll = 0;
 
+#ifdef SERIALRXBUFFERSIZE
+	_serialPoll = true;
+#endif
+
 	PrintVersion();
 	StepperSerial.println();
 	Init();
@@ -498,6 +685,24 @@ void CControl::Run()
 
 void CControl::CheckIdlePoll(bool isIdle)
 {
+	if (isIdle)
+	{
+		// waiting for input => keep the movement queue filled, do not hold back the io of MoveIoControl on an idle stepper
+		CMotionControlBase::GetInstance()->ArcPoll();
+		CStepper::GetInstance()->MoveIoPoll();
+	}
+
+	// speed synchronized output (e.g. laser power), not in the ISR
+	CStepper::GetInstance()->SpeedEventPoll();
+
+#ifdef SERIALRXBUFFERSIZE
+	if (_serialPoll)
+	{
+		// receive (and execute real-time commands) while a command is waiting
+		FillRxBuffer();
+	}
+#endif
+
 	uint32_t time = millis();
 
 	if (isIdle && _lastTime + TIMEOUTCALLIDLE < time)
@@ -110,6 +110,7 @@ public:
 		OnWarningEvent = CStepper::OnWarningEvent,
 		OnInfoEvent = CStepper::OnInfoEvent,
 		OnIoEvent = CStepper::OnIoEvent,
+		OnSpeedEvent = CStepper::OnSpeedEvent,
 
 		OnStartCut
 	};
@@ -140,6 +141,31 @@ public:
 
 	const char*  GetBuffer() const { return _buffer; }
 	uint8_t      GetBufferCount() const { return _bufferIdx; }
+
+#ifdef SERIALRXBUFFERSIZE
+
+	void     SetCharCounting(bool charCounting) { _charCounting = charCounting; }	// "ok" is followed by free receive buffer bytes and '?','!','~' are real-time commands, see M113
+	bool     IsCharCounting() const { return _charCounting; }
+	uint16_t GetRxFree() const;												// free bytes the host may send (without the bytes in the serial hardware buffer)
+
+	enum ERealtimeCommand
+	{
+		// single byte commands, executed when received (not part of a line), see FillRxBuffer
+
+		RealtimeStatus  = '?',			// only with character counting (M113 S1), else part of a line
+		RealtimeHold    = '!',
+		RealtimeResume  = '~',
+
+		RealtimeReset   = 0x18,			// Ctrl-X => Kill
+
+		RealtimeSpeedOverride100     = 0x90,
+		RealtimeSpeedOverridePlus10  = 0x91,
+		RealtimeSpeedOverrideMinus10 = 0x92,
+		RealtimeSpeedOverridePlus1   = 0x93,
+		RealtimeSpeedOverrideMinus1  = 0x94
+	};
+
+#endif
 	
 	REDUCED_SIZE_virtual bool IsEndOfCommandChar(char ch);					// override default End of command char, default \n
 
@@ -179,6 +205,7 @@ private:
 
 	void CheckIdlePoll(bool isIdle);						// check idle time and call Idle every 100ms
 
+	bool AddCommandChar(char ch, Stream* output);			// add char to _buffer, execute command if "IsEndOfCommandChar", return true if executed
 
 	uint8_t _bufferIdx;										// read Buffer index , see SERIALBUFFERSIZE
 
@@ -193,6 +220,20 @@ private:
 
 	char _buffer[SERIALBUFFERSIZE];							// serial input buffer
 
+#ifdef SERIALRXBUFFERSIZE
+
+	void FillRxBuffer();									// move chars from serial to _rxBuffer, must not execute a command (called while waiting)
+	void PrintRxFree(Stream* output);
+	bool RealtimeCommand(char ch);							// return true if ch is a real-time command (and executed)
+	void AddSpeedOverride(int8_t speedP);
+
+	CRingBufferQueueSPSC<char, SERIALRXBUFFERSIZE, uint16_t> _rxBuffer;	// serial receive buffer, filled while a command is executed (waiting for the stepper)
+
+	bool _charCounting;
+	bool _serialPoll;										// serial is read in CheckIdlePoll (in Run)
+
+#endif
+
 	static void HandleInterrupt() { GetInstance()->TimerInterrupt(); }
 
 	static bool StaticStepperEvent(CStepper* stepper, uintptr_t param, EnumAsByte(CStepper::EStepperEvent) eventType, uintptr_t addInfo);
@@ -0,0 +1,398 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <Arduino.h>
+
+#include "CutterRadiusCompensation.h"
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::Init(mm1000_t radius, axis_t axis_0, axis_t axis_1, const mm1000_t current[NUM_AXIS])
+{
+	_radius  = radius;
+	_axis_0  = axis_0;
+	_axis_1  = axis_1;
+	_count   = 0;
+	_isEntry = true;
+
+	memcpy(_programmed, current, sizeof(_programmed));
+	memcpy(_current, current, sizeof(_current));
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	CMotionControlBase::GetInstance()->MoveAbs(to, feedrate);
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate)
+{
+	CMotionControlBase::GetInstance()->Arc(to, offset0, offset1, _axis_0, _axis_1, isClockwise, feedrate);
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::Line(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	SSegment segment;
+	memcpy(segment.To, to, sizeof(segment.To));
+	segment.Feedrate = feedrate;
+	segment.Type     = (to[_axis_0] == _programmed[_axis_0] && to[_axis_1] == _programmed[_axis_1]) ? NoPlaneSegment : LineSegment;
+
+	Add(segment);
+}
+
+////////////////////////////////////////////////////////
+
+bool CCutterRadiusCompensation::Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate)
+{
+	SSegment segment;
+	memcpy(segment.To, to, sizeof(segment.To));
+	segment.From[0]   = _programmed[_axis_0];
+	segment.From[1]   = _programmed[_axis_1];
+	segment.Center[0] = _programmed[_axis_0] + offset0;
+	segment.Center[1] = _programmed[_axis_1] + offset1;
+	segment.Feedrate  = feedrate;
+	segment.Type      = isClockwise ? ArcCWSegment : ArcCCWSegment;
+
+	// offset must not be on the other side of the center (radius of arc < radius of tool)
+
+	SVector offset = GetOffset(GetTangent(segment, false));
+	if ((offset.X * offset0 + offset.Y * offset1) > 0 && (offset.X * offset.X + offset.Y * offset.Y) >= (float(offset0) * offset0 + float(offset1) * offset1))
+	{
+		return false;
+	}
+
+	Add(segment);
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::Command(CommandFunction command, uint32_t param0, uint32_t param1)
+{
+	if (_count == 0)
+	{
+		// nothing held back
+		command(param0, param1);
+		return;
+	}
+
+	if (_count >= CUTTERRADIUS_QUEUESIZE)
+	{
+		Flush();
+		command(param0, param1);
+		return;
+	}
+
+	SSegment& segment = _segment[_count++];
+	segment.Type      = CommandSegment;
+	segment.Command   = command;
+	segment.Center[0] = mm1000_t(param0);
+	segment.Center[1] = mm1000_t(param1);
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::SetPlane(axis_t axis_0, axis_t axis_1)
+{
+	if (axis_0 != _axis_0 || axis_1 != _axis_1)
+	{
+		// the held back segment ends normal to the programmed end, the next segment (in the new plane) is an entry move
+		Flush();
+		_axis_0 = axis_0;
+		_axis_1 = axis_1;
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::Add(const SSegment& segment)
+{
+	SSegment next = segment;
+	next.From[0]  = _programmed[_axis_0];
+	next.From[1]  = _programmed[_axis_1];
+
+	memcpy(_programmed, next.To, sizeof(_programmed));
+
+	if (next.Type == NoPlaneSegment)
+	{
+		if (_count == 0)
+		{
+			// nothing held back => move at current position in plane
+
+			next.To[_axis_0] = _current[_axis_0];
+			next.To[_axis_1] = _current[_axis_1];
+			MoveAbs(next.To, next.Feedrate);
+			memcpy(_current, next.To, sizeof(_current));
+			return;
+		}
+
+		if (_count >= CUTTERRADIUS_QUEUESIZE)
+		{
+			Flush();
+			Add(segment);
+			return;
+		}
+
+		_segment[_count++] = next;
+		return;
+	}
+
+	if (_count == 0)
+	{
+		_segment[_count++] = next;
+		return;
+	}
+
+	// corner between held back segment and next segment
+
+	const SSegment& prev = _segment[0];
+
+	SVector tangentPrev = GetTangent(prev, true);
+	SVector tangentNext = GetTangent(next, false);
+	SVector offsetPrev  = GetOffset(tangentPrev);
+	SVector offsetNext  = GetOffset(tangentNext);
+
+	float cross  = tangentPrev.X * tangentNext.Y - tangentPrev.Y * tangentNext.X;
+	float dot    = tangentPrev.X * tangentNext.X + tangentPrev.Y * tangentNext.Y;
+	auto  corner = SVector{ float(prev.To[_axis_0]), float(prev.To[_axis_1]) };
+
+	bool isTangential = fabs(cross) < 1e-4f && dot > 0;
+	bool isInside     = !isTangential && (_radius > 0 ? cross > 0 : cross < 0);		// turn to the side of the tool
+
+	if (isInside)
+	{
+		MoveSegment(prev, Intersect(prev, next, offsetPrev, offsetNext));
+		MoveQueued();
+	}
+	else
+	{
+		MoveSegment(prev, SVector{ corner.X + offsetPrev.X, corner.Y + offsetPrev.Y });
+		MoveQueued();
+
+		if (!isTangential)
+		{
+			// outside corner => arc around corner (G41: clockwise, G42: counterclockwise)
+
+			mm1000_t to[NUM_AXIS];
+			memcpy(to, _current, sizeof(to));
+			to[_axis_0] = mm1000_t(lround(corner.X + offsetNext.X));
+			to[_axis_1] = mm1000_t(lround(corner.Y + offsetNext.Y));
+
+			MoveArc(to, prev.To[_axis_0] - _current[_axis_0], prev.To[_axis_1] - _current[_axis_1], _radius > 0, next.Feedrate);
+			memcpy(_current, to, sizeof(_current));
+		}
+	}
+
+	_segment[0] = next;
+	_count      = 1;
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::Flush()
+{
+	if (_count == 0)
+	{
+		return;
+	}
+
+	const SSegment& prev   = _segment[0];
+	SVector         offset = GetOffset(GetTangent(prev, true));
+
+	MoveSegment(prev, SVector{ prev.To[_axis_0] + offset.X, prev.To[_axis_1] + offset.Y });
+	MoveQueued();
+
+	_count   = 0;
+	_isEntry = true;
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::MoveSegment(const SSegment& segment, const SVector& to)
+{
+	mm1000_t pos[NUM_AXIS];
+	memcpy(pos, segment.To, sizeof(pos));
+	pos[_axis_0] = mm1000_t(lround(to.X));
+	pos[_axis_1] = mm1000_t(lround(to.Y));
+
+	if (segment.Type == LineSegment)
+	{
+		MoveAbs(pos, segment.Feedrate);
+	}
+	else
+	{
+		if (_isEntry)
+		{
+			// entry move to start of offset arc
+
+			SVector  offset = GetOffset(GetTangent(segment, false));
+			mm1000_t start[NUM_AXIS];
+			memcpy(start, _current, sizeof(start));
+			start[_axis_0] = mm1000_t(lround(segment.From[0] + offset.X));
+			start[_axis_1] = mm1000_t(lround(segment.From[1] + offset.Y));
+			MoveAbs(start, segment.Feedrate);
+			memcpy(_current, start, sizeof(_current));
+		}
+
+		MoveArc(pos, segment.Center[0] - _current[_axis_0], segment.Center[1] - _current[_axis_1], segment.Type == ArcCWSegment, segment.Feedrate);
+	}
+
+	memcpy(_current, pos, sizeof(_current));
+	_isEntry = false;
+}
+
+////////////////////////////////////////////////////////
+
+void CCutterRadiusCompensation::MoveQueued()
+{
+	// queued moves without motion in the plane (at the current position in the plane) and commands
+
+	for (uint8_t i = 1; i < _count; i++)
+	{
+		SSegment& segment = _segment[i];
+		if (segment.Type == CommandSegment)
+		{
+			segment.Command(uint32_t(segment.Center[0]), uint32_t(segment.Center[1]));
+			continue;
+		}
+		segment.To[_axis_0] = _current[_axis_0];
+		segment.To[_axis_1] = _current[_axis_1];
+		MoveAbs(segment.To, segment.Feedrate);
+		memcpy(_current, segment.To, sizeof(_current));
+	}
+	_count = 1;
+}
+
+////////////////////////////////////////////////////////
+
+CCutterRadiusCompensation::SVector CCutterRadiusCompensation::GetTangent(const SSegment& segment, bool atEnd) const
+{
+	float x;
+	float y;
+
+	if (segment.Type == LineSegment)
+	{
+		x = float(segment.To[_axis_0] - segment.From[0]);
+		y = float(segment.To[_axis_1] - segment.From[1]);
+	}
+	else
+	{
+		// tangent of arc is normal to radius
+		float rx = atEnd ? float(segment.To[_axis_0] - segment.Center[0]) : float(segment.From[0] - segment.Center[0]);
+		float ry = atEnd ? float(segment.To[_axis_1] - segment.Center[1]) : float(segment.From[1] - segment.Center[1]);
+
+		x = segment.Type == ArcCWSegment ? ry : -ry;
+		y = segment.Type == ArcCWSegment ? -rx : rx;
+	}
+
+	float length = sqrt(x * x + y * y);
+	return SVector{ x / length, y / length };
+}
+
+////////////////////////////////////////////////////////
+
+CCutterRadiusCompensation::SVector CCutterRadiusCompensation::Intersect(const SSegment& prev, const SSegment& next, const SVector& offsetPrev, const SVector& offsetNext) const
+{
+	// intersection of the offset segments (line or circle) next to the corner
+
+	auto corner = SVector{ float(prev.To[_axis_0]), float(prev.To[_axis_1]) };
+	auto a      = SVector{ corner.X + offsetPrev.X, corner.Y + offsetPrev.Y };
+	auto b      = SVector{ corner.X + offsetNext.X, corner.Y + offsetNext.Y };
+
+	SVector tangentPrev = GetTangent(prev, true);
+	SVector tangentNext = GetTangent(next, false);
+
+	SVector best{ 0, 0 };
+	float   bestDist = -1;
+
+	auto check = [&](float x, float y)
+	{
+		float dist = (x - corner.X) * (x - corner.X) + (y - corner.Y) * (y - corner.Y);
+		if (bestDist < 0 || dist < bestDist)
+		{
+			best     = SVector{ x, y };
+			bestDist = dist;
+		}
+	};
+
+	auto lineCircle = [&](const SVector& p, const SVector& d, const SSegment& circle, const SVector& onCircle)
+	{
+		float ox   = p.X - circle.Center[0];
+		float oy   = p.Y - circle.Center[1];
+		float r2   = (onCircle.X - circle.Center[0]) * (onCircle.X - circle.Center[0]) + (onCircle.Y - circle.Center[1]) * (onCircle.Y - circle.Center[1]);
+		float bh   = d.X * ox + d.Y * oy;
+		float disc = bh * bh - (ox * ox + oy * oy - r2);
+		if (disc >= 0)
+		{
+			float s = sqrt(disc);
+			check(p.X + d.X * (-bh + s), p.Y + d.Y * (-bh + s));
+			check(p.X + d.X * (-bh - s), p.Y + d.Y * (-bh - s));
+		}
+	};
+
+	bool prevIsLine = prev.Type == LineSegment;
+	bool nextIsLine = next.Type == LineSegment;
+
+	if (!prevIsLine && !nextIsLine)
+	{
+		// circle - circle
+		float dx = float(next.Center[0] - prev.Center[0]);
+		float dy = float(next.Center[1] - prev.Center[1]);
+		float d  = sqrt(dx * dx + dy * dy);
+		float r1 = sqrt((a.X - prev.Center[0]) * (a.X - prev.Center[0]) + (a.Y - prev.Center[1]) * (a.Y - prev.Center[1]));
+		float r2 = sqrt((b.X - next.Center[0]) * (b.X - next.Center[0]) + (b.Y - next.Center[1]) * (b.Y - next.Center[1]));
+		if (d > 0)
+		{
+			float l  = (r1 * r1 - r2 * r2 + d * d) / (2 * d);
+			float h2 = r1 * r1 - l * l;
+			if (h2 >= 0)
+			{
+				float h  = sqrt(h2);
+				float mx = prev.Center[0] + l * dx / d;
+				float my = prev.Center[1] + l * dy / d;
+				check(mx - h * dy / d, my + h * dx / d);
+				check(mx + h * dy / d, my - h * dx / d);
+			}
+		}
+	}
+	else if (!prevIsLine)
+	{
+		lineCircle(b, tangentNext, prev, a);
+	}
+	else if (!nextIsLine)
+	{
+		lineCircle(a, tangentPrev, next, b);
+	}
+
+	if (bestDist < 0)
+	{
+		// line - line (or tangents at the corner if circles do not intersect)
+		float cross = tangentPrev.X * tangentNext.Y - tangentPrev.Y * tangentNext.X;
+		float u     = ((b.X - a.X) * tangentNext.Y - (b.Y - a.Y) * tangentNext.X) / cross;
+		check(a.X + tangentPrev.X * u, a.Y + tangentPrev.Y * u);
+	}
+
+	return best;
+}
@@ -0,0 +1,102 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////
+
+#include "ConfigurationCNCLib.h"
+#include "MotionControlBase.h"
+
+////////////////////////////////////////////////////////
+//
+// Cutter radius compensation (G41/G42) of programmed lines and arcs in a plane
+//
+// The end of an offset segment depends on the next segment, so the last programmed segment (in the plane) is held back:
+//		outside corner:	the offset segment ends normal to the programmed end, an arc around the programmed corner is inserted
+//		inside corner:	the offset segments end at their intersection
+// Moves without motion in the plane (e.g. z) and commands (e.g. io, dwell) are queued behind the held back segment (max CUTTERRADIUS_QUEUESIZE-1)
+// The first segment (after Init) is the entry move, it starts at the current (not compensated) position.
+//
+class CCutterRadiusCompensation
+{
+public:
+
+	typedef void (*CommandFunction)(uint32_t param0, uint32_t param1);
+
+	void Init(mm1000_t radius, axis_t axis_0, axis_t axis_1, const mm1000_t current[NUM_AXIS]);	// radius > 0: left (G41), radius < 0: right (G42)
+
+	void Line(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
+	bool Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate);	// false if radius of arc is too small
+	void Command(CommandFunction command, uint32_t param0, uint32_t param1);	// no motion (e.g. io), called in order with the moves
+	void SetPlane(axis_t axis_0, axis_t axis_1);	// G17/G18/G19, flush if the plane changes
+	void Flush();					// move all queued segments, the last ends normal to the programmed end
+
+	void GetPosition(mm1000_t pos[NUM_AXIS]) const { memcpy(pos, _programmed, sizeof(_programmed)); }	// programmed (not compensated) position
+	uint8_t GetQueueCount() const { return _count; }
+
+protected:
+
+	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
+	virtual void MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate);
+
+private:
+
+	enum ESegmentType
+	{
+		LineSegment,
+		ArcCWSegment,
+		ArcCCWSegment,
+		NoPlaneSegment,			// no move in plane
+		CommandSegment			// no move, call Command
+	};
+
+	struct SSegment
+	{
+		mm1000_t                  To[NUM_AXIS];
+		mm1000_t                  From[2];				// programmed start in plane
+		mm1000_t                  Center[2];			// arc, parameters of Command
+		feedrate_t                Feedrate;
+		CommandFunction           Command;
+		EnumAsByte(ESegmentType) Type;
+	};
+
+	struct SVector
+	{
+		float X;
+		float Y;
+	};
+
+	SSegment _segment[CUTTERRADIUS_QUEUESIZE];			// [0]: held back segment in plane, followed by moves without motion in plane
+	uint8_t  _count;
+	bool     _isEntry;
+
+	mm1000_t _programmed[NUM_AXIS];
+	mm1000_t _current[NUM_AXIS];						// end of last move (compensated)
+	mm1000_t _radius;
+	axis_t   _axis_0;
+	axis_t   _axis_1;
+
+	void Add(const SSegment& segment);
+	void MoveSegment(const SSegment& segment, const SVector& to);
+	void MoveQueued();
+
+	SVector GetTangent(const SSegment& segment, bool atEnd) const;
+	SVector GetOffset(const SVector& tangent) const { return SVector{ -tangent.Y * _radius, tangent.X * _radius }; }
+	SVector Intersect(const SSegment& prev, const SSegment& next, const SVector& offsetPrev, const SVector& offsetNext) const;
+};
+
+////////////////////////////////////////////////////////
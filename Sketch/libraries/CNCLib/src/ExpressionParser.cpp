@@ -30,6 +30,19 @@ void CExpressionParser::Parse()
 {
 	Answer = 0;
 
+#ifdef EXPRPARSER_CACHESIZE
+	const char* text = _reader->GetBuffer();
+
+	if (ParseCached(text))
+	{
+		return;
+	}
+
+	_codeSize   = 0;
+	_stackDepth = 0;
+	_compileOK  = _cache != nullptr;
+#endif
+
 	GetNextToken();
 	if (GetTokenType() == EndOfLineSy)
 	{
@@ -48,13 +61,158 @@ void CExpressionParser::Parse()
 		ErrorAdd(MESSAGE_EXPR_FORMAT);
 		return;
 	}
+
+#ifdef EXPRPARSER_CACHESIZE
+	AddToCache(text);
+#endif
+}
+
+#ifdef EXPRPARSER_CACHESIZE
+
+////////////////////////////////////////////////////////////
+// bytecode: postfix, one byte ETokenType as opcode
+//	FloatSy		+ expr_t	push constant
+//	VariableSy	+ uint16_t	push GetVariableRefValue
+//	operator				pop rhs, replace lhs with result (FactorialSy: replace value)
+//	function, NegateSy		replace value with result
+
+void CExpressionParser::Emit(uint8_t op, const void* data, uint8_t size, int8_t stackChange)
+{
+	if (!_compileOK)
+	{
+		return;
+	}
+
+	_stackDepth += stackChange;
+
+	if (_codeSize + 1 + size > EXPRPARSER_MAXCODESIZE || _stackDepth > EXPRPARSER_MAXSTACK)
+	{
+		_compileOK = false;
+		return;
+	}
+
+	_code[_codeSize++] = op;
+	if (size != 0)
+	{
+		// data is nullptr for opcodes without operand
+		memcpy(&_code[_codeSize], data, size);
+		_codeSize += size;
+	}
 }
 
 ////////////////////////////////////////////////////////////
 
+bool CExpressionParser::ParseCached(const char* text)
+{
+	if (_cache == nullptr)
+	{
+		return false;
+	}
+
+	for (SCacheEntry& entry : _cache->_entry)
+	{
+		if (entry._lastUse != 0 && strcmp(entry._text, text) == 0)
+		{
+			entry._lastUse = ++_cache->_clock;
+			Answer         = EvalCode(entry._code, entry._codeSize);
+			_reader->MoveToEnd();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////
+
+void CExpressionParser::AddToCache(const char* text)
+{
+	if (!_compileOK || strlen(text) >= EXPRPARSER_MAXTEXTLENGTH)
+	{
+		return;
+	}
+
+	// replace least recently used
+
+	SCacheEntry* entry = &_cache->_entry[0];
+	for (SCacheEntry& e : _cache->_entry)
+	{
+		if (e._lastUse < entry->_lastUse)
+		{
+			entry = &e;
+		}
+	}
+
+	strcpy(entry->_text, text);
+	memcpy(entry->_code, _code, _codeSize);
+	entry->_codeSize = _codeSize;
+	entry->_lastUse  = ++_cache->_clock;
+}
+
+////////////////////////////////////////////////////////////
+
+expr_t CExpressionParser::EvalCode(const uint8_t* code, uint8_t codeSize)
+{
+	expr_t  stack[EXPRPARSER_MAXSTACK];
+	uint8_t sp = 0;
+
+	for (uint8_t pc = 0; pc < codeSize && !IsError();)
+	{
+		auto op = EnumAsByte(ETokenType)(code[pc++]);
+
+		switch (op)
+		{
+			case FloatSy:
+			{
+				memcpy(&stack[sp++], &code[pc], sizeof(expr_t));
+				pc += sizeof(expr_t);
+				break;
+			}
+			case VariableSy:
+			{
+				uint16_t varRef;
+				memcpy(&varRef, &code[pc], sizeof(varRef));
+				pc += sizeof(varRef);
+				stack[sp++] = GetVariableRefValue(varRef);
+				break;
+			}
+			case NegateSy:
+			{
+				stack[sp - 1] = -stack[sp - 1];
+				break;
+			}
+			case FactorialSy:
+			{
+				stack[sp - 1] = Factorial(stack[sp - 1]);
+				break;
+			}
+			default:
+			{
+				if (op >= FirstFunctionSy && op <= LastFunctionSy)
+				{
+					stack[sp - 1] = EvalFunction(op, stack[sp - 1]);
+				}
+				else
+				{
+					sp--;
+					stack[sp - 1] = EvalOperator(op, stack[sp - 1], stack[sp]);
+				}
+				break;
+			}
+		}
+	}
+
+	return stack[0];
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+
 void CExpressionParser::GetNextToken()
 {
 	_state._detailToken = NothingSy;
+	_state._varRef      = 0;
 	if (IsError()) return;
 
 	char ch = _reader->SkipSpaces();
@@ -195,6 +353,9 @@ expr_t CExpressionParser::ParseLevel1()
 		if (GetTokenType() == AssignSy)
 		{
 			// assignment
+#ifdef EXPRPARSER_CACHESIZE
+			_compileOK = false;
+#endif
 			GetNextToken();
 			expr_t ans = ParseLevel2();
 
@@ -231,7 +392,7 @@ expr_t CExpressionParser::ParseLevel2()
 	while (operatorSy == AndSy || operatorSy == OrSy || operatorSy == BitShiftLeftSy || operatorSy == BitShiftRightSy)
 	{
 		GetNextToken();
-		ans        = EvalOperator(operatorSy, ans, ParseLevel3());
+		ans        = CompileOperator(operatorSy, ans, ParseLevel3());
 		operatorSy = GetTokenType();
 	}
 
@@ -249,7 +410,7 @@ expr_t CExpressionParser::ParseLevel3()
 	while (operatorSy == EqualSy || operatorSy == UnEqualSy || operatorSy == LessSy || operatorSy == LessEqualSy || operatorSy == GreaterSy || operatorSy == GreaterEqualSy)
 	{
 		GetNextToken();
-		ans        = EvalOperator(operatorSy, ans, ParseLevel4());
+		ans        = CompileOperator(operatorSy, ans, ParseLevel4());
 		operatorSy = GetTokenType();
 	}
 
@@ -267,7 +428,7 @@ expr_t CExpressionParser::ParseLevel4()
 	while (operatorSy == PlusSy || operatorSy == MinusSy)
 	{
 		GetNextToken();
-		ans        = EvalOperator(operatorSy, ans, ParseLevel5());
+		ans        = CompileOperator(operatorSy, ans, ParseLevel5());
 		operatorSy = GetTokenType();
 	}
 
@@ -285,7 +446,7 @@ expr_t CExpressionParser::ParseLevel5()
 	while (operatorSy == MultiplySy || operatorSy == DivideSy || operatorSy == ModuloSy || operatorSy == XOrSy)
 	{
 		GetNextToken();
-		ans        = EvalOperator(operatorSy, ans, ParseLevel6());
+		ans        = CompileOperator(operatorSy, ans, ParseLevel6());
 		operatorSy = GetTokenType();
 	}
 
@@ -303,7 +464,7 @@ expr_t CExpressionParser::ParseLevel6()
 	while (operatorSy == PowSy)
 	{
 		GetNextToken();
-		ans        = EvalOperator(operatorSy, ans, ParseLevel7());
+		ans        = CompileOperator(operatorSy, ans, ParseLevel7());
 		operatorSy = GetTokenType();
 	}
 
@@ -323,7 +484,7 @@ expr_t CExpressionParser::ParseLevel7()
 		GetNextToken();
 		// factorial does not need a value right from the
 		// operator, so zero is filled in.
-		ans        = EvalOperator(operatorSy, ans, 0.0);
+		ans        = CompileOperator(operatorSy, ans, 0.0);
 		operatorSy = GetTokenType();
 	}
 
@@ -338,7 +499,7 @@ expr_t CExpressionParser::ParseLevel8()
 	if (GetTokenType() == MinusSy)
 	{
 		GetNextToken();
-		return -ParseLevel9();
+		return CompileNegate(ParseLevel9());
 	}
 
 	return ParseLevel9();
@@ -353,7 +514,7 @@ expr_t CExpressionParser::ParseLevel9()
 	{
 		EnumAsByte(ETokenType) functionSy = GetTokenType();
 		GetNextToken();
-		return EvalFunction(functionSy, ParseLevel10());
+		return CompileFunction(functionSy, ParseLevel10());
 	}
 	return ParseLevel10();
 }
@@ -394,6 +555,16 @@ expr_t CExpressionParser::ParseNumber()
 		case VariableSy:
 			// this is a number
 			ans = _state._number;
+#ifdef EXPRPARSER_CACHESIZE
+			if (_state._varRef != 0)
+			{
+				Emit(VariableSy, &_state._varRef, sizeof(_state._varRef), 1);
+			}
+			else
+			{
+				Emit(FloatSy, &ans, sizeof(ans), 1);
+			}
+#endif
 			GetNextToken();
 			break;
 		default:
@@ -405,6 +576,32 @@ expr_t CExpressionParser::ParseNumber()
 	return ans;
 }
 
+////////////////////////////////////////////////////////////
+
+expr_t CExpressionParser::CompileOperator(EnumAsByte(ETokenType) operatorSy, const expr_t& lhs, const expr_t& rhs)
+{
+#ifdef EXPRPARSER_CACHESIZE
+	Emit(operatorSy, nullptr, 0, operatorSy == FactorialSy ? 0 : -1);
+#endif
+	return EvalOperator(operatorSy, lhs, rhs);
+}
+
+expr_t CExpressionParser::CompileFunction(EnumAsByte(ETokenType) operatorSy, const expr_t& value)
+{
+#ifdef EXPRPARSER_CACHESIZE
+	Emit(operatorSy, nullptr, 0, 0);
+#endif
+	return EvalFunction(operatorSy, value);
+}
+
+expr_t CExpressionParser::CompileNegate(const expr_t& value)
+{
+#ifdef EXPRPARSER_CACHESIZE
+	Emit(NegateSy, nullptr, 0, 0);
+#endif
+	return -value;
+}
+
 ////////////////////////////////////////////////////////////
 // evaluate an operator for given values
 
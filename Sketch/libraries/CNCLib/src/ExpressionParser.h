@@ -18,15 +18,25 @@
 
 ////////////////////////////////////////////////////////
 
+#include "ConfigurationCNCLib.h"
 #include "Parser.h"
 
 #define EXPRPARSER_MAXTOKENLENGTH 16
 
+#ifdef EXPRPARSER_CACHESIZE
+#define EXPRPARSER_MAXTEXTLENGTH	48		// max length of the expression text to cache
+#define EXPRPARSER_MAXCODESIZE		64		// max size of bytecode of a cached expression
+#define EXPRPARSER_MAXSTACK			16		// stack of bytecode evaluation
+#endif
+
 ////////////////////////////////////////////////////////
 //
 // Expression Parser, 
 //	read char from CStreamReader and calculate the result(=Answer)
 //
+//	with EXPRPARSER_CACHESIZE and a cache (set by the derived class) the expression is compiled to a postfix bytecode while parsing,
+//	the next Parse() of the same text evaluates the bytecode (stack machine) without scanning the text
+//
 class CExpressionParser : public CParser
 {
 private:
@@ -39,6 +49,9 @@ public:
 	{
 		_leftParenthesis  = '(';
 		_rightParenthesis = ')';
+#ifdef EXPRPARSER_CACHESIZE
+		_cache = nullptr;
+#endif
 	}
 
 	virtual void Parse() override;
@@ -47,6 +60,38 @@ public:
 
 protected:
 
+#ifdef EXPRPARSER_CACHESIZE
+
+	struct SCacheEntry
+	{
+		uint32_t _lastUse;									// LRU, 0 => free
+		uint8_t  _codeSize;
+		char     _text[EXPRPARSER_MAXTEXTLENGTH];
+		uint8_t  _code[EXPRPARSER_MAXCODESIZE];
+	};
+
+	struct SCache
+	{
+		uint32_t    _clock;
+		SCacheEntry _entry[EXPRPARSER_CACHESIZE];
+	};
+
+	SCache* _cache;											// nullptr => no compile
+
+	uint8_t _code[EXPRPARSER_MAXCODESIZE];					// bytecode of current Parse()
+	uint8_t _codeSize;
+	uint8_t _stackDepth;
+	bool    _compileOK;										// e.g. false for assignment, too long
+
+	void   Emit(uint8_t op, const void* data, uint8_t size, int8_t stackChange);
+	bool   ParseCached(const char* text);
+	void   AddToCache(const char* text);
+	expr_t EvalCode(const uint8_t* code, uint8_t codeSize);
+
+#endif
+
+	virtual expr_t GetVariableRefValue(uint16_t) { return 0; }	// value of _varRef (bytecode)
+
 	char _leftParenthesis;
 	char _rightParenthesis;
 
@@ -118,7 +163,9 @@ protected:
 		RoundSy,
 
 		FactorialFncSy,
-		LastFunctionSy = FactorialFncSy
+		LastFunctionSy = FactorialFncSy,
+
+		NegateSy								// unary minus (only bytecode)
 	};
 
 	struct SParserState
@@ -126,6 +173,7 @@ protected:
 		expr_t      _number;					// number if parsed integer or float or variable(content)
 		const char* _varName;
 		bool        _variableOK;				// _number = variable with content
+		uint16_t    _varRef;					// != 0 => variable is read with GetVariableRefValue(_varRef) (e.g. param no), else _number is constant
 
 		EnumAsByte(ETokenType) _detailToken;
 	};
@@ -149,6 +197,11 @@ protected:
 	expr_t EvalOperator(EnumAsByte(ETokenType) operatorSy, const expr_t& lhs, const expr_t& rhs);
 	expr_t EvalFunction(EnumAsByte(ETokenType) operatorSy, const expr_t& value);
 
+	// evaluate and add to bytecode, the operands are already added
+	expr_t CompileOperator(EnumAsByte(ETokenType) operatorSy, const expr_t& lhs, const expr_t& rhs);
+	expr_t CompileFunction(EnumAsByte(ETokenType) operatorSy, const expr_t& value);
+	expr_t CompileNegate(const expr_t& value);
+
 	expr_t Factorial(expr_t value);
 	expr_t Sign(expr_t      value);
 };
@@ -28,6 +28,12 @@
 //
 // Expression Parser
 
+#ifdef EXPRPARSER_CACHESIZE
+CExpressionParser::SCache CGCodeExpressionParser::_exprCache;
+#endif
+
+////////////////////////////////////////////////////////////
+
 void CGCodeExpressionParser::ReadIdent()
 {
 	// read variable name of gcode : #1 or #<_x>
@@ -44,6 +50,10 @@ void CGCodeExpressionParser::ReadIdent()
 			Error(_gcodeParser->GetError());
 			return;
 		}
+#ifdef EXPRPARSER_CACHESIZE
+		// bytecode reads the param by number (not the value at compile time)
+		_state._varRef = uint16_t(_state._number) + 1;
+#endif
 	}
 	else
 	{
@@ -60,6 +70,9 @@ void CGCodeExpressionParser::ScanNextToken()
 	{
 		if (ch == ';' || ch == '(') // comment
 		{
+#ifdef EXPRPARSER_CACHESIZE
+			_compileOK = false; // comment may have side effects, e.g. (MSG,...)
+#endif
 			ch = _gcodeParser->SkipSpacesOrComment();
 		}
 		else
@@ -87,3 +100,14 @@ bool CGCodeExpressionParser::EvalVariable(const char* var_name, expr_t& answer)
 	}
 	return super::EvalVariable(var_name, answer);
 }
+
+////////////////////////////////////////////////////////////
+
+#ifdef EXPRPARSER_CACHESIZE
+
+expr_t CGCodeExpressionParser::GetVariableRefValue(uint16_t varRef)
+{
+	return CMm1000::ConvertTo(_gcodeParser->GetParamValue(param_t(varRef - 1), false));
+}
+
+#endif
@@ -36,6 +36,9 @@ public:
 		_gcodeParser      = parser;
 		_leftParenthesis  = '[';
 		_rightParenthesis = ']';
+#ifdef EXPRPARSER_CACHESIZE
+		_cache = &_exprCache;
+#endif
 	};
 
 protected:
@@ -47,6 +50,12 @@ protected:
 	virtual bool IsIdentStart(char ch) override { return ch == '#' || super::IsIdentStart(ch); } // start of function or variable
 
 	virtual bool EvalVariable(const char* var_name, expr_t& answer) override;
+
+#ifdef EXPRPARSER_CACHESIZE
+	virtual expr_t GetVariableRefValue(uint16_t varRef) override;	// varRef = paramNo + 1
+
+	static SCache _exprCache;										// shared by all instances (parser is created per expression)
+#endif
 };
 
 ////////////////////////////////////////////////////////
@@ -38,6 +38,10 @@
 
 struct CGCodeParser::SModalState    CGCodeParser::_modalState;
 struct CGCodeParser::SModelessState CGCodeParser::_modelessState;
+CCutterRadiusCompensation           CGCodeParser::_cutterRadiusCompensation;
+#ifdef OWORD_PROGRAMSIZE
+struct CGCodeParser::SOWordState    CGCodeParser::_oWordState;
+#endif
 
 ////////////////////////////////////////////////////////////
 
@@ -66,6 +70,94 @@ void CGCodeParser::CleanupParse()
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParser::GetMovePosition(mm1000_t pos[NUM_AXIS])
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.GetPosition(pos);
+		return;
+	}
+	super::GetMovePosition(pos);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Line(to, feedrate);
+		return;
+	}
+	super::MoveAbs(to, feedrate);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		if (!_cutterRadiusCompensation.Arc(to, offset0, offset1, isClockwise, feedrate))
+		{
+			Error(MESSAGE_GCODE_CutterRadiusTooBig);
+		}
+		return;
+	}
+	super::MoveArc(to, offset0, offset1, isClockwise, feedrate);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::Wait(uint32_t ms)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		// after the held back segment (see CGCodeParserBase::Wait)
+		_cutterRadiusCompensation.Command([](uint32_t sec100, uint32_t) { CStepper::GetInstance()->Wait(sec100); }, ms / 10, 0);
+		return;
+	}
+	super::Wait(ms);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::WaitClock(uint32_t clock)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Command([](uint32_t stepperClock, uint32_t) { CStepper::GetInstance()->WaitClock(stepperClock); }, clock + super::_modalState.Clock, 0);
+		return;
+	}
+	super::WaitClock(clock);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::CallIOControl(uint8_t io, uint16_t value)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Command([](uint32_t tool, uint32_t level) { CStepper::GetInstance()->IoControl(uint8_t(tool), uint16_t(level)); }, io, value);
+		return;
+	}
+	super::CallIOControl(io, value);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::CallMoveIOControl(uint8_t io, uint16_t value)
+{
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Command([](uint32_t tool, uint32_t level) { CStepper::GetInstance()->MoveIoControl(uint8_t(tool), uint16_t(level)); }, io, value);
+		return;
+	}
+	super::CallMoveIOControl(io, value);
+}
+
+////////////////////////////////////////////////////////////
+
 bool CGCodeParser::GetParamOrExpression(mm1000_t* value, bool convertToInch)
 {
 	if (_reader->GetChar() == '#')
@@ -76,45 +168,57 @@ bool CGCodeParser::GetParamOrExpression(mm1000_t* value, bool convertToInch)
 	}
 	if (_reader->GetChar() == '[')
 	{
-		const char* start = _reader->GetBuffer();
-		char        ch    = _reader->GetNextChar();
-		uint8_t     count = 1;
+		expr_t answer;
+		if (ParseExpression(answer))
+		{
+			*value = CMm1000::ConvertFrom(answer);
+		}
+		return true;
+	}
 
-		while (!_reader->IsEOC(ch))
+	return super::GetParamOrExpression(value, convertToInch);
+}
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::ParseExpression(expr_t& answer)
+{
+	// reader must be at '[', expression ends with matching ']'
+
+	const char* start = _reader->GetBuffer();
+	char        ch    = _reader->GetNextChar();
+	uint8_t     count = 1;
+
+	while (!_reader->IsEOC(ch))
+	{
+		if (ch == '[')
 		{
-			if (ch == '[')
-			{
-				count++;
-			}
-			else if (ch == ']')
+			count++;
+		}
+		else if (ch == ']')
+		{
+			count--;
+			if (count == 0)
 			{
-				count--;
-				if (count == 0)
-				{
-					_reader->GetNextChar();
-					CStreamReader::CSetTemporary terminate(_reader->GetBuffer());
-					_reader->ResetBuffer(start);
+				_reader->GetNextChar();
+				CStreamReader::CSetTemporary terminate(_reader->GetBuffer());
+				_reader->ResetBuffer(start);
 
-					CGCodeExpressionParser expressionParser(this);
-					expressionParser.Parse();
-					if (expressionParser.IsError())
-					{
-						Error(expressionParser.GetError());
-					}
-					else
-					{
-						*value = CMm1000::ConvertFrom(expressionParser.Answer);
-					}
-					return true;
+				CGCodeExpressionParser expressionParser(this);
+				expressionParser.Parse();
+				if (expressionParser.IsError())
+				{
+					Error(expressionParser.GetError());
+					return false;
 				}
+				answer = expressionParser.Answer;
+				return true;
 			}
-			ch = _reader->GetNextChar();
 		}
-		Error(MESSAGE_EXPR_MISSINGRPARENTHESIS);
-		return true;
+		ch = _reader->GetNextChar();
 	}
-
-	return super::GetParamOrExpression(value, convertToInch);
+	Error(MESSAGE_EXPR_MISSINGRPARENTHESIS);
+	return false;
 }
 
 ////////////////////////////////////////////////////////////
@@ -281,20 +385,82 @@ static bool IsModifyParam(param_t paramNo)
 
 ////////////////////////////////////////////////////////////
 
+static_assert((NUM_PARAMETER & (NUM_PARAMETER - 1)) == 0 && NUM_PARAMETER <= 128, "NUM_PARAMETER must be 2^x (max 128)");
+
+// user parameter: hash table with linear probing, a free slot (ParamNo == 0) ends the search
+
 uint8_t CGCodeParser::ParamNoToParamIdx(param_t paramNo)
 {
-	for (uint8_t idx = 0; idx < NUM_PARAMETER; idx++)
+	uint8_t idx = ParamHash(paramNo);
+
+	for (uint8_t i = 0; i < NUM_PARAMETER; i++)
 	{
-		if (uint8_t(paramNo) == _modalState.ParamNoToIdx[idx])
+		if (_modalState.ParamNo[idx] == paramNo)
 		{
 			return idx;
 		}
+		if (_modalState.ParamNo[idx] == 0)
+		{
+			break;
+		}
+		idx = (idx + 1) & (NUM_PARAMETER - 1);
 	}
 
 	// return 255 of not found
 	return 255;
 }
 
+////////////////////////////////////////////////////////////
+
+uint8_t CGCodeParser::AddParam(param_t paramNo)
+{
+	uint8_t idx = ParamHash(paramNo);
+
+	for (uint8_t i = 0; i < NUM_PARAMETER; i++)
+	{
+		if (_modalState.ParamNo[idx] == 0)
+		{
+			_modalState.ParamNo[idx] = paramNo;
+			return idx;
+		}
+		idx = (idx + 1) & (NUM_PARAMETER - 1);
+	}
+
+	return 255;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::RemoveParam(uint8_t paramIdx)
+{
+	// backward shift deletion: move following entries of the probe sequence to the free slot (no "deleted" marker needed)
+
+	uint8_t freeIdx = paramIdx;
+	uint8_t idx     = paramIdx;
+
+	while (true)
+	{
+		idx = (idx + 1) & (NUM_PARAMETER - 1);
+
+		param_t paramNo = _modalState.ParamNo[idx];
+		if (paramNo == 0 || idx == paramIdx)
+		{
+			break;
+		}
+
+		// distance from hash slot: entry can move to freeIdx if freeIdx is between hash slot and idx
+		uint8_t home = ParamHash(paramNo);
+		if (((idx - home) & (NUM_PARAMETER - 1)) >= ((idx - freeIdx) & (NUM_PARAMETER - 1)))
+		{
+			_modalState.ParamNo[freeIdx]   = paramNo;
+			_modalState.Parameter[freeIdx] = _modalState.Parameter[idx];
+			freeIdx                        = idx;
+		}
+	}
+
+	_modalState.ParamNo[freeIdx] = 0;
+}
+
 // 5161-5169 - G28 Home for (X Y Z A B C U V W)
 // 5221-5230 - Coordinate System 1, G54 (X Y Z A B C U V W R) - R denotes the XY rotation angle around the Z axis 
 // 5420-5428 - Current Position including offsets in current program units (X Y Z A B C U V W)
@@ -371,6 +537,38 @@ mm1000_t CGCodeParser::GetParamValue(param_t paramNo, bool convertToInch)
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParser::SetUserParamValue(param_t paramNo, float value)
+{
+	uint8_t paramIdx = ParamNoToParamIdx(paramNo);
+
+	if (paramIdx == 255)
+	{
+		if (value != 0.0)
+		{
+			paramIdx = AddParam(paramNo);
+			if (paramIdx == 255)
+			{
+				Error(MESSAGE_GCODE_NoParamSlotAvailable);
+			}
+			else
+			{
+				_modalState.Parameter[paramIdx] = value;
+			}
+		}
+	}
+	else if (value == 0.0)
+	{
+		// free slot
+		RemoveParam(paramIdx);
+	}
+	else
+	{
+		_modalState.Parameter[paramIdx] = value;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParser::SetParamValue(param_t paramNo)
 {
 	CGCodeExpressionParser expressionParser(this);
@@ -388,37 +586,7 @@ void CGCodeParser::SetParamValue(param_t paramNo)
 
 		if (IsModifyParam(paramNo))
 		{
-			uint8_t paramIdx = ParamNoToParamIdx(paramNo);
-
-			if (paramIdx == 255)
-			{
-				if (expressionParser.Answer != 0.0)
-				{
-					uint8_t idx;
-					for (idx = 0; idx < NUM_PARAMETER; idx++)
-					{
-						if (_modalState.ParamNoToIdx[idx] == 0)
-						{
-							_modalState.ParamNoToIdx[idx] = uint8_t(paramNo);
-							_modalState.Parameter[idx]    = expressionParser.Answer;
-							break;
-						}
-					}
-					if (idx >= NUM_PARAMETER)
-					{
-						Error(MESSAGE_GCODE_NoParamSlotAvailable);
-					}
-				}
-			}
-			else if (expressionParser.Answer == 0.0)
-			{
-				// free slot
-				_modalState.ParamNoToIdx[paramIdx] = 0;
-			}
-			else
-			{
-				_modalState.Parameter[paramIdx] = expressionParser.Answer;
-			}
+			SetUserParamValue(paramNo, expressionParser.Answer);
 		}
 		else if (param != nullptr)
 		{
@@ -506,46 +674,6 @@ void CGCodeParser::SetParamValue(param_t paramNo)
 
 ////////////////////////////////////////////////////////////
 
-const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfo(uintptr_t param, bool (*check)(const SParamInfo*, uintptr_t))
-{
-	auto item = &_paramDef[0];
-	while (item->GetParamNo() != 0)
-	{
-		if (check(item, param))
-		{
-			return item;
-		}
-		item++;
-	}
-
-	return nullptr;
-}
-
-////////////////////////////////////////////////////////////
-
-const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfoByText(const char* text)
-{
-	return FindParamInfo(uintptr_t(text), [](const SParamInfo* p, uintptr_t x) -> bool
-	{
-		const char* text = p->GetText();
-		return text != nullptr && strcasecmp_P((const char*)x, text) == 0;
-	});
-}
-
-////////////////////////////////////////////////////////////
-
-const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfoByParamNo(param_t paramNo)
-{
-	return FindParamInfo(uintptr_t(paramNo), [](const SParamInfo* p, uintptr_t x) -> bool
-	{
-		auto findParamNo = param_t(x);
-		return p->GetParamNo() == findParamNo ||	// exact same paramNo
-			(p->GetAllowAxisOfs() && p->GetParamNo() <= findParamNo && p->GetParamNo() + NUM_AXIS > findParamNo);	// diff with axis
-	});
-}
-
-////////////////////////////////////////////////////////////
-
 static const char _feedrate[] PROGMEM      = "_feedrate";
 static const char _g28home[] PROGMEM       = "_g28home";
 static const char _g92home[] PROGMEM       = "_g92home";
@@ -575,12 +703,79 @@ static const char _aPos[] PROGMEM          = "_a";
 static const char _bPos[] PROGMEM          = "_b";
 static const char _cPos[] PROGMEM          = "_c";
 
+// index of _paramDef, same order and conditions as _paramDef (sorted by paramNo)
+
+enum EParamDef : uint8_t
+{
+	ParamDefProbePos,
+	ParamDefProbeOk,
+	ParamDefG28Home,
+	ParamDefG92Home,
+	ParamDefG54Home,
+	ParamDefG55Home,
+#if G54ARRAYSIZE > 2
+	ParamDefG56Home,
+#if G54ARRAYSIZE > 3
+	ParamDefG57Home,
+#if G54ARRAYSIZE > 4
+	ParamDefG58Home,
+#if G54ARRAYSIZE > 5
+	ParamDefG59Home,
+#endif
+#endif
+#endif
+#endif
+	ParamDefCurrentPos,
+	ParamDefXPos,
+	ParamDefYPos,
+	ParamDefZPos,
+#if NUM_AXIS > 3
+	ParamDefAPos,
+#if NUM_AXIS > 4
+	ParamDefBPos,
+#if NUM_AXIS > 5
+	ParamDefCPos,
+#endif
+#endif
+#endif
+	ParamDefCurrentAbsPos,
+	ParamDefBacklash,
+	ParamDefBacklashFeed,
+	ParamDefMaxPos,
+	ParamDefMinPos,
+	ParamDefAcc,
+	ParamDefDec,
+	ParamDefJerk,
+	ParamDefFan,
+	ParamDefG0Feedrate,
+	ParamDefFeedrate,
+
+	ParamDefCount
+};
+
 const CGCodeParser::SParamInfo CGCodeParser::_paramDef[] PROGMEM =
 {
+	{ PARAMSTART_PROBEPOS, _probePos, true, CGCodeParser::SParamInfo::IsMm1000 },
+	{ PARAMSTART_PROBEOK, _probeOk, false, CGCodeParser::SParamInfo::IsInt },
 	{ PARAMSTART_G28HOME, _g28home, true, CGCodeParser::SParamInfo::IsMm1000 },
 	{ PARAMSTART_G92OFFSET, _g92home, true, CGCodeParser::SParamInfo::IsMm1000 },
-	{ PARAMSTART_CURRENTPOS, _currentPos, true, CGCodeParser::SParamInfo::IsMm1000 },
 
+	{ PARAMSTART_G54OFFSET + 0 * PARAMSTART_G54FF_OFFSET, _g54home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	{ PARAMSTART_G54OFFSET + 1 * PARAMSTART_G54FF_OFFSET, _g55home, true, CGCodeParser::SParamInfo::IsMm1000 },
+#if G54ARRAYSIZE > 2
+	{ PARAMSTART_G54OFFSET + 2 * PARAMSTART_G54FF_OFFSET, _g56home, true, CGCodeParser::SParamInfo::IsMm1000 },
+#if G54ARRAYSIZE > 3
+	{ PARAMSTART_G54OFFSET + 3 * PARAMSTART_G54FF_OFFSET, _g57home, true, CGCodeParser::SParamInfo::IsMm1000 },
+#if G54ARRAYSIZE > 4
+	{ PARAMSTART_G54OFFSET + 4 * PARAMSTART_G54FF_OFFSET, _g58home, true, CGCodeParser::SParamInfo::IsMm1000 },
+#if G54ARRAYSIZE > 5
+	{ PARAMSTART_G54OFFSET + 5 * PARAMSTART_G54FF_OFFSET, _g59home, true, CGCodeParser::SParamInfo::IsMm1000 },
+#endif
+#endif
+#endif
+#endif
+
+	{ PARAMSTART_CURRENTPOS, _currentPos, true, CGCodeParser::SParamInfo::IsMm1000 },	// must be before _x (same paramNo)
 	{ PARAMSTART_CURRENTPOS, _xPos, false, CGCodeParser::SParamInfo::IsMm1000 },
 	{ PARAMSTART_CURRENTPOS + 1, _yPos, false, CGCodeParser::SParamInfo::IsMm1000 },
 	{ PARAMSTART_CURRENTPOS + 2, _zPos, false, CGCodeParser::SParamInfo::IsMm1000 },
@@ -595,8 +790,6 @@ const CGCodeParser::SParamInfo CGCodeParser::_paramDef[] PROGMEM =
 #endif
 
 	{ PARAMSTART_CURRENTABSPOS, _currentAbsPos, true, CGCodeParser::SParamInfo::IsMm1000 },
-	{ PARAMSTART_PROBEPOS, _probePos, true, CGCodeParser::SParamInfo::IsMm1000 },
-	{ PARAMSTART_PROBEOK, _probeOk, false, CGCodeParser::SParamInfo::IsInt },
 	{ PARAMSTART_BACKLASH, _backlash, true, CGCodeParser::SParamInfo::IsMm1000 },
 	{ PARAMSTART_BACKLASH_FEEDRATE, _backlashfeed, false, CGCodeParser::SParamInfo::IsMm1000 },
 	{ PARAMSTART_MAX, _maxPos, true, CGCodeParser::SParamInfo::IsMm1000 },
@@ -607,32 +800,137 @@ const CGCodeParser::SParamInfo CGCodeParser::_paramDef[] PROGMEM =
 	{ PARAMSTART_CONTROLLERFAN, _fan, false, CGCodeParser::SParamInfo::IsInt },
 	{ PARAMSTART_RAPIDMOVEFEED, _g0feedrate, false, CGCodeParser::SParamInfo::IsMm1000 },
 
-	{ PARAMSTART_G54OFFSET + 0 * PARAMSTART_G54FF_OFFSET, _g54home, true, CGCodeParser::SParamInfo::IsMm1000 },
-	{ PARAMSTART_G54OFFSET + 1 * PARAMSTART_G54FF_OFFSET, _g55home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	{ PARAMSTART_FEEDRATE, _feedrate, false, CGCodeParser::SParamInfo::IsMm1000 },
+	{ 0, nullptr, false, 0 }
+};
+
+// sorted by text (strcasecmp)
+
+const uint8_t CGCodeParser::_paramDefByText[] PROGMEM =
+{
+#if NUM_AXIS > 3
+	ParamDefAPos,			// _a
+#endif
+	ParamDefAcc,			// _acc
+#if NUM_AXIS > 4
+	ParamDefBPos,			// _b
+#endif
+	ParamDefBacklash,		// _backlash
+	ParamDefBacklashFeed,	// _backlashfeed
+#if NUM_AXIS > 5
+	ParamDefCPos,			// _c
+#endif
+	ParamDefCurrentPos,		// _current
+	ParamDefCurrentAbsPos,	// _currentAbs
+	ParamDefDec,			// _dec
+	ParamDefFan,			// _fan
+	ParamDefFeedrate,		// _feedrate
+	ParamDefG0Feedrate,		// _g0feedrate
+	ParamDefG28Home,		// _g28home
+	ParamDefG54Home,		// _g54home
+	ParamDefG55Home,		// _g55home
 #if G54ARRAYSIZE > 2
-	{ PARAMSTART_G54OFFSET + 2 * PARAMSTART_G54FF_OFFSET, _g56home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	ParamDefG56Home,		// _g56home
 #if G54ARRAYSIZE > 3
-	{ PARAMSTART_G54OFFSET + 3 * PARAMSTART_G54FF_OFFSET, _g57home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	ParamDefG57Home,		// _g57home
 #if G54ARRAYSIZE > 4
-	{ PARAMSTART_G54OFFSET + 4 * PARAMSTART_G54FF_OFFSET, _g58home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	ParamDefG58Home,		// _g58home
 #if G54ARRAYSIZE > 5
-	{ PARAMSTART_G54OFFSET + 5 * PARAMSTART_G54FF_OFFSET, _g59home, true, CGCodeParser::SParamInfo::IsMm1000 },
+	ParamDefG59Home,		// _g59home
 #endif
 #endif
 #endif
 #endif
-
-	{ PARAMSTART_FEEDRATE, _feedrate, false, CGCodeParser::SParamInfo::IsMm1000 },
-	{ 0, nullptr, false, 0 }
+	ParamDefG92Home,		// _g92home
+	ParamDefJerk,			// _jerk
+	ParamDefMaxPos,			// _maxPos
+	ParamDefMinPos,			// _minPos
+	ParamDefProbeOk,		// _probeOK
+	ParamDefProbePos,		// _probePos
+	ParamDefXPos,			// _x
+	ParamDefYPos,			// _y
+	ParamDefZPos,			// _z
 };
 
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::PrintParam(const CGCodeParser::SParamInfo* item, axis_t axis)
+const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfoByText(const char* text)
 {
-	const char* paramName = item->GetText();
-	StepperSerial.print('#');
-	if (paramName != nullptr)
+	// binary search in _paramDefByText
+
+	static_assert(sizeof(_paramDefByText) == ParamDefCount, "_paramDefByText must contain all _paramDef");
+
+	uint8_t lo = 0;
+	uint8_t hi = ParamDefCount;
+
+	while (lo < hi)
+	{
+		uint8_t           mid  = (lo + hi) / 2;
+		const SParamInfo* item = &_paramDef[pgm_read_byte(&_paramDefByText[mid])];
+		int               cmp  = strcasecmp_P(text, item->GetText());
+
+		if (cmp == 0)
+		{
+			return item;
+		}
+		if (cmp < 0)
+		{
+			hi = mid;
+		}
+		else
+		{
+			lo = mid + 1;
+		}
+	}
+
+	return nullptr;
+}
+
+////////////////////////////////////////////////////////////
+
+const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfoByParamNo(param_t paramNo)
+{
+	static_assert(sizeof(_paramDef) / sizeof(_paramDef[0]) == ParamDefCount + 1, "EParamDef does not match _paramDef");
+
+	// binary search for the first entry which may include paramNo (paramNo or with axis offset), then first match as defined in _paramDef
+
+	param_t minParamNo = paramNo >= NUM_AXIS ? paramNo - (NUM_AXIS - 1) : 0;
+
+	uint8_t lo = 0;
+	uint8_t hi = ParamDefCount;
+
+	while (lo < hi)
+	{
+		uint8_t mid = (lo + hi) / 2;
+		if (_paramDef[mid].GetParamNo() < minParamNo)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	for (auto item = &_paramDef[lo]; item < &_paramDef[ParamDefCount] && item->GetParamNo() <= paramNo; item++)
+	{
+		if (item->GetParamNo() == paramNo ||	// exact same paramNo
+			(item->GetAllowAxisOfs() && item->GetParamNo() + NUM_AXIS > paramNo))	// diff with axis
+		{
+			return item;
+		}
+	}
+
+	return nullptr;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::PrintParam(const CGCodeParser::SParamInfo* item, axis_t axis)
+{
+	const char* paramName = item->GetText();
+	StepperSerial.print('#');
+	if (paramName != nullptr)
 	{
 		StepperSerial.print('<');
 		StepperSerial.print(paramName);
@@ -679,7 +977,7 @@ void CGCodeParser::PrintParamValue(param_t paramNo)
 	if (IsModifyParam(paramNo))
 	{
 		uint8_t  paramIdx   = ParamNoToParamIdx(paramNo);
-		mm1000_t paramValue = paramIdx != 255 ? GetParamValue(_modalState.ParamNoToIdx[paramIdx], false) : 0;
+		mm1000_t paramValue = paramIdx != 255 ? GetParamValue(_modalState.ParamNo[paramIdx], false) : 0;
 		char     tmp[16];
 		StepperSerial.println(CMm1000::ToString(paramValue, tmp, 3));
 	}
@@ -689,12 +987,12 @@ void CGCodeParser::PrintParamValue(param_t paramNo)
 
 void CGCodeParser::PrintAllParam()
 {
-	for (uint8_t paramNo : _modalState.ParamNoToIdx)
+	for (param_t paramNo : _modalState.ParamNo)
 	{
 		if (paramNo != 0)
 		{
 			StepperSerial.print('#');
-			StepperSerial.print(uint16_t(paramNo));
+			StepperSerial.print(paramNo);
 			StepperSerial.print('=');
 			PrintParamValue(paramNo);
 		}
@@ -776,6 +1074,28 @@ bool CGCodeParser::Command(char ch)
 
 bool CGCodeParser::GCommand(uint8_t gcode)
 {
+	if (_modalState.CutterRadiusCompensation)
+	{
+		switch (gcode)
+		{
+			// @formatter:off — disable formatter after this line
+			case 10: case 28: case 31: case 38: case 53: case 68: case 69: case 92:
+			{
+				// position or coordinate system must not change while a segment is held back
+				Error(MESSAGE_GCODE_G41G43AreNotAllowedWithThisCommand);
+				return true;
+			}
+			case 17: case 18: case 19:
+			{
+				super::GCommand(gcode);
+				_cutterRadiusCompensation.SetPlane(super::_modalState.Plane_axis_0, super::_modalState.Plane_axis_1);
+				return true;
+			}
+			default: break;		// other codes are queued with the moves (e.g. G4) or do not move
+			// @formatter:on — enable formatter after this line
+		}
+	}
+
 	if (super::GCommand(gcode))
 		return true;
 
@@ -829,10 +1149,15 @@ bool CGCodeParser::MCommand(mcode_t mcode)
 		case 31: M31Command();	return true;
   		case 110: M110Command();	return true;
 		case 111: M111Command();	return true;
+		case 113: M113Command();	return true;
 		case 114: M114Command();	return true;
 		case 220: M220Command();	return true;
 #ifndef REDUCED_SIZE
+		case 170: M170Command();	return true;
 		case 300: M300Command();	return true;
+#endif
+#ifdef STEPPER_STATUS
+		case 408: M408Command();	return true;
 #endif
 		default: break;
 		// @formatter:on — enable formatter after this line
@@ -858,7 +1183,7 @@ void CGCodeParser::ParameterCommand()
 			}
 			else
 			{
-				for (unsigned char& paramNo : _modalState.ParamNoToIdx)
+				for (param_t& paramNo : _modalState.ParamNo)
 				{
 					paramNo = 0;
 				}
@@ -1178,30 +1503,49 @@ bool CGCodeParser::CenterProbeCommand(SAxisMove& move, bool probeValue, axis_t a
 
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::G41Command()
+void CGCodeParser::G40Command()
 {
-	/*
-			if (_reader->SkipSpacesToUpper() == 'D')
-			{
-				_reader->GetNextChar();
-				GetUint16OrParam();			// ignore it
-			}
-	*/
-	ErrorNotImplemented();
+	CutterRadiusFlush();
+	_modalState.CutterRadiusCompensation = SModalState::CutterRadiusOff;
 }
 
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::G42Command()
+void CGCodeParser::G4142Command(bool isLeft)
 {
-	/*
-		if (_reader->SkipSpacesToUpper() == 'D')
+	// G41 [D<tool>] (default: selected tool)
+
+	if (CutterRadiusIsOn())
+	{
+		Error(MESSAGE_GCODE_G41G43AreNotAllowedWithThisCommand);
+		return;
+	}
+
+	toolnr_t tool = _modalState.ToolSelected;
+
+	if (_reader->SkipSpacesToUpper() == 'D')
+	{
+		_reader->GetNextChar();
+		tool = GetUint16OrParam();
+		if (IsError())
 		{
-			_reader->GetNextChar();
-			GetUint16OrParam();			// ignore it
+			return;
 		}
-	*/
-	ErrorNotImplemented();
+	}
+
+	if (!CGCodeTools::GetInstance()->IsValidTool(tool))
+	{
+		Error(MESSAGE_GCODE_NoValidTool);
+		return;
+	}
+
+	mm1000_t current[NUM_AXIS];
+	CMotionControlBase::GetInstance()->GetPositions(current);
+
+	mm1000_t radius = CGCodeTools::GetInstance()->GetRadius(tool);
+	_cutterRadiusCompensation.Init(isLeft ? radius : -radius, super::_modalState.Plane_axis_0, super::_modalState.Plane_axis_1, current);
+
+	_modalState.CutterRadiusCompensation = isLeft ? SModalState::CutterRadiusLeft : SModalState::CutterRadiusRight;
 }
 
 ////////////////////////////////////////////////////////////
@@ -1799,21 +2143,39 @@ void CGCodeParser::G83Command()
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParser::StopProgram(uint32_t checkConditional, uint32_t)
+{
+	Sync();
+	CControl::GetInstance()->StopProgram(checkConditional != 0);
+}
+
 void CGCodeParser::M00Command()
 {
 	//Stop
-	Sync();
-	CControl::GetInstance()->StopProgram(false);
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Command(StopProgram, false, 0);
+		return;
+	}
+	StopProgram(false, 0);
 }
 
 void CGCodeParser::M01Command()
 {
 	//Optional Stop
-	Sync();
-	CControl::GetInstance()->StopProgram(true);
+	if (_modalState.CutterRadiusCompensation)
+	{
+		_cutterRadiusCompensation.Command(StopProgram, true, 0);
+		return;
+	}
+	StopProgram(true, 0);
 }
 
-void CGCodeParser::M02Command() {}
+void CGCodeParser::M02Command()
+{
+	// End of program => G40
+	G40Command();
+}
 
 ////////////////////////////////////////////////////////////
 
@@ -1895,6 +2257,39 @@ void CGCodeParser::M111Command()
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParser::M113Command()
+{
+	// character counting: S1 => "ok" is followed by the free bytes of the receive buffer (e.g. "ok RX:200")
+	// and '?', '!', '~' are real-time commands (status, hold, resume), see CControl::RealtimeCommand
+
+	if (_reader->SkipSpacesToUpper() == 'S')
+	{
+		_reader->GetNextChar();
+		uint8_t charCounting = GetUInt8();
+		if (IsError())
+		{
+			return;
+		}
+#ifdef SERIALRXBUFFERSIZE
+		CControl::GetInstance()->SetCharCounting(charCounting != 0);
+#else
+		if (charCounting != 0)
+		{
+			InfoNotImplemented();
+		}
+#endif
+	}
+	else
+	{
+		Error(MESSAGE_GCODE_SExpected);
+		return;
+	}
+
+	if (!ExpectEndOfCommand()) { return; }
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParser::M114Command()
 {
 	uint8_t posType = 0;
@@ -1913,83 +2308,130 @@ void CGCodeParser::M114Command()
 	}
 }
 
-
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::M220Command()
+#ifdef STEPPER_STATUS
+
+void CGCodeParser::M408Command()
 {
-	// set speed override
+	_OkMessage = PrintStatus;
 
-	if (_reader->SkipSpacesToUpper() == 'S')
-	{
-		_reader->GetNextChar();
-		uint8_t speedInP = GetUInt8();
-		if (IsError())
-		{
-			return;
-		}
-		CStepper::GetInstance()->SetSpeedOverride(CStepper::PToSpeedOverride(speedInP));
-	}
-	else
+	if (!ExpectEndOfCommand())
 	{
-		Error(MESSAGE_GCODE_SExpected);
 		return;
 	}
-
-	if (!ExpectEndOfCommand()) { return; }
 }
 
+#endif
+
+
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::M300Command()
+#ifndef REDUCED_SIZE
+
+// base64 (RFC 4648) without line breaks, '=' padding is optional
+
+struct SBase64Reader
 {
-	SPlayTone        tone[2];
-	const SPlayTone* myTone      = tone;
-	bool             fromProgMem = false;
+	const char* _src;
+	uint16_t    _bits;
+	uint8_t     _bitCount;
 
-	tone[0].Tone     = ToneA4;
-	tone[0].Duration = MilliSecToDuration(500);
+	static uint8_t Value(char ch)		// 0..63 or 255 if ch is not a base64 char
+	{
+		if (CStreamReader::IsUpperAZ(ch)) return ch - 'A';
+		if (CStreamReader::IsLowerAZ(ch)) return ch - 'a' + 26;
+		if (CStreamReader::IsDigit(ch)) return ch - '0' + 52;
+		if (ch == '+') return 62;
+		if (ch == '/') return 63;
+		return 255;
+	}
 
-	tone[1].Tone = ToneEnd;
+	void Init(const char* src)
+	{
+		_src      = src;
+		_bits     = 0;
+		_bitCount = 0;
+	}
 
-	if (_reader->SkipSpacesToUpper() == 'S')
+	bool Read(uint8_t& value)
 	{
-		_reader->GetNextChar();
-		unsigned int freq = GetUInt16();
-		tone[0].Tone      = ETone(FreqToTone(freq));
-		if (IsError())
+		while (_bitCount < 8)
 		{
-			return;
+			uint8_t v = Value(*_src);
+			if (v == 255)
+			{
+				return false;
+			}
+			_src++;
+			_bits = (_bits << 6) + v;
+			_bitCount += 6;
 		}
+		_bitCount -= 8;
+		value = uint8_t(_bits >> _bitCount);
+		return true;
+	}
+};
 
-		switch (freq)
+void CGCodeParser::M170Command()
+{
+	// raster scanline, e.g. for laser engraving: constant velocity move in X from the current position
+	// M170 P<pitch> [F<feedrate>] B<base64>		one byte (power 0..255) for each pixel
+	// M170 P<pitch> [F<feedrate>] R<base64>		run length encoded: byte pairs count(1..255),power(0..255)
+	// pitch < 0 => move in -X direction, power is scaled with the spindle speed (S), no power if spindle is off
+	// pixels with the same power are one movement, the power is set at the start of the movement (MoveIoControl)
+	// the power is switched off at the start of the next move (pending MoveIoControl): a following M170 (next part of the scanline) replaces it => no stop
+	// no next move: CStepper::MoveIoPoll queues the off if the stepper is idle, other commands queue it with their move or io (FlushMoveIo)
+
+	if (_modalState.CutterRadiusCompensation)
+	{
+		Error(MESSAGE_GCODE_G41G43AreNotAllowedWithThisCommand);
+		return;
+	}
+
+	SAxisMove   move(true);
+	mm1000_t    pitch  = 0;
+	char        format = 0;
+	const char* data   = nullptr;
+
+	for (char ch = _reader->SkipSpacesToUpper(); ch; ch = _reader->SkipSpacesToUpper())
+	{
+		if (ch == 'P')
 		{
-			case 1:
+			if (move.bitfield.bit.P)
 			{
-				myTone      = SPlayTone::PlayOK;
-				fromProgMem = true;
-				break;
+				Error(MESSAGE(MESSAGE_GCODE_PalreadySpecified));
+				return;
 			}
-			case 2:
+			move.bitfield.bit.P = true;
+			_reader->GetNextChar();
+			pitch = ParseCoordinate(true);
+		}
+		else if (ch == 'F')
+		{
+			_reader->GetNextChar();
+			GetFeedrate(move);
+		}
+		else if ((ch == 'B' || ch == 'R') && format == 0)
+		{
+			format = ch;
+			_reader->GetNextChar();
+			data = _reader->GetBuffer();
+			while (SBase64Reader::Value(_reader->GetChar()) != 255)
 			{
-				myTone      = SPlayTone::PlayError;
-				fromProgMem = true;
-				break;
+				_reader->GetNextChar();
 			}
-			case 3:
+			while (_reader->GetChar() == '=')
 			{
-				myTone      = SPlayTone::PlayInfo;
-				fromProgMem = true;
-				break;
+				_reader->GetNextChar();
 			}
-			default: break;
 		}
-	}
-	if (!fromProgMem && _reader->SkipSpacesToUpper() == 'P')
-	{
-		_reader->GetNextChar();
-		tone[0].Duration = MilliSecToDuration(GetUInt16());
-		if (IsError())
+		else
+		{
+			break;
+		}
+
+		if (CheckError())
 		{
 			return;
 		}
@@ -2000,39 +2442,232 @@ void CGCodeParser::M300Command()
 		return;
 	}
 
-	if (CLcd::GetInstance())
+	if (!move.bitfield.bit.P || pitch == 0)
 	{
-		CLcd::GetInstance()->Beep(myTone, fromProgMem);
+		Error(MESSAGE(MESSAGE_GCODE_PExpected));
+		return;
 	}
-}
 
-////////////////////////////////////////////////////////////
-
-void CGCodeParser::CommandEscape()
-{
-	CNCLibCommandExtensions();
-}
+	if (data == nullptr)
+	{
+		Error(MESSAGE(MESSAGE_GCODE_InvalidRasterData));
+		return;
+	}
 
-////////////////////////////////////////////////////////////
+	// check data before any movement is queued
 
-void CGCodeParser::CNCLibCommandExtensions()
-{
-	char ch = _reader->SkipSpaces();
+	SBase64Reader reader;
+	uint8_t       value = 0;
+	uint16_t      byteCount = 0;
 
-	switch (ch)
+	reader.Init(data);
+	while (reader.Read(value))
 	{
-		case '&':
+		if (format == 'R' && (byteCount % 2) == 0 && value == 0)
 		{
-			_reader->GetNextChar();
-			if (!ExpectEndOfCommand()) { return; }
-
-			CStepper::GetInstance()->Dump(CStepper::DumpAll);
+			byteCount = 0;
 			break;
 		}
-		case '!':
+		byteCount++;
+	}
+
+	if (byteCount == 0 || (format == 'R' && (byteCount % 2) != 0))
+	{
+		Error(MESSAGE(MESSAGE_GCODE_InvalidRasterData));
+		return;
+	}
+
+	const uint8_t  tool   = super::_modalState.SpindleOnCW ? CControl::SpindleCW : CControl::SpindleCCW;
+	const mm1000_t startX = move.newpos[X_AXIS];
+
+	uint32_t pixel     = 0;		// end of the current run
+	uint16_t runLevel  = 0;
+	uint16_t lastLevel = 0;
+	bool     isFirst   = true;
+
+	reader.Init(data);
+
+	while (byteCount > 0)
+	{
+		uint8_t count = 1;
+		if (format == 'R')
 		{
-			_reader->GetNextChar();
-			if (_reader->IsEOC(SkipSpacesOrComment()))
+			if (!reader.Read(count))
+			{
+				break;
+			}
+			byteCount--;
+		}
+		if (!reader.Read(value))
+		{
+			break;
+		}
+		byteCount--;
+
+		uint16_t level = super::_modalState.SpindleOn ? uint16_t(RoundMulDivU32(value, super::_modalState.SpindleSpeed, 255)) : 0;
+
+		if (level != runLevel && pixel != 0)
+		{
+			if (isFirst || runLevel != lastLevel)
+			{
+				CallMoveIOControl(tool, runLevel);
+				lastLevel = runLevel;
+				isFirst   = false;
+			}
+			move.newpos[X_AXIS] = startX + mm1000_t(pixel) * pitch;
+			CMotionControlBase::GetInstance()->MoveAbs(move.newpos, super::_modalState.G1FeedRate);
+		}
+
+		runLevel = level;
+		pixel += count;
+	}
+
+	if (byteCount > 0)
+	{
+		// short data (checked above, must not happen)
+		Error(MESSAGE(MESSAGE_GCODE_InvalidRasterData));
+	}
+	else
+	{
+		if (isFirst || runLevel != lastLevel)
+		{
+			CallMoveIOControl(tool, runLevel);
+			lastLevel = runLevel;
+		}
+		move.newpos[X_AXIS] = startX + mm1000_t(pixel) * pitch;
+		CMotionControlBase::GetInstance()->MoveAbs(move.newpos, super::_modalState.G1FeedRate);
+	}
+
+	if (lastLevel != 0)
+	{
+		CallMoveIOControl(tool, 0);
+	}
+
+	// next cut move must switch on the spindle again
+	super::_modalState.CutMove = false;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::M220Command()
+{
+	// set speed override
+
+	if (_reader->SkipSpacesToUpper() == 'S')
+	{
+		_reader->GetNextChar();
+		uint8_t speedInP = GetUInt8();
+		if (IsError())
+		{
+			return;
+		}
+		CStepper::GetInstance()->SetSpeedOverride(CStepper::PToSpeedOverride(speedInP));
+	}
+	else
+	{
+		Error(MESSAGE_GCODE_SExpected);
+		return;
+	}
+
+	if (!ExpectEndOfCommand()) { return; }
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::M300Command()
+{
+	SPlayTone        tone[2];
+	const SPlayTone* myTone      = tone;
+	bool             fromProgMem = false;
+
+	tone[0].Tone     = ToneA4;
+	tone[0].Duration = MilliSecToDuration(500);
+
+	tone[1].Tone = ToneEnd;
+
+	if (_reader->SkipSpacesToUpper() == 'S')
+	{
+		_reader->GetNextChar();
+		unsigned int freq = GetUInt16();
+		tone[0].Tone      = ETone(FreqToTone(freq));
+		if (IsError())
+		{
+			return;
+		}
+
+		switch (freq)
+		{
+			case 1:
+			{
+				myTone      = SPlayTone::PlayOK;
+				fromProgMem = true;
+				break;
+			}
+			case 2:
+			{
+				myTone      = SPlayTone::PlayError;
+				fromProgMem = true;
+				break;
+			}
+			case 3:
+			{
+				myTone      = SPlayTone::PlayInfo;
+				fromProgMem = true;
+				break;
+			}
+			default: break;
+		}
+	}
+	if (!fromProgMem && _reader->SkipSpacesToUpper() == 'P')
+	{
+		_reader->GetNextChar();
+		tone[0].Duration = MilliSecToDuration(GetUInt16());
+		if (IsError())
+		{
+			return;
+		}
+	}
+
+	if (!ExpectEndOfCommand())
+	{
+		return;
+	}
+
+	if (CLcd::GetInstance())
+	{
+		CLcd::GetInstance()->Beep(myTone, fromProgMem);
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::CommandEscape()
+{
+	CNCLibCommandExtensions();
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::CNCLibCommandExtensions()
+{
+	char ch = _reader->SkipSpaces();
+
+	switch (ch)
+	{
+		case '&':
+		{
+			_reader->GetNextChar();
+			if (!ExpectEndOfCommand()) { return; }
+
+			CStepper::GetInstance()->Dump(CStepper::DumpAll);
+			break;
+		}
+		case '!':
+		{
+			_reader->GetNextChar();
+			if (_reader->IsEOC(SkipSpacesOrComment()))
 			{
 				CControl::GetInstance()->Kill();
 			}
@@ -2044,6 +2679,644 @@ void CGCodeParser::CNCLibCommandExtensions()
 
 ////////////////////////////////////////////////////////////
 
+#ifdef OWORD_PROGRAMSIZE
+
+void CGCodeParser::Parse()
+{
+	// lines executed from O-word memory are parsed "normal"
+
+	if (_oWordState.Executing || !OWordParse())
+	{
+		super::Parse();
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::OWordParse()
+{
+	char*  line = const_cast<char*>(_reader->GetBuffer());
+	SOWord oWord;
+	bool   isOWord = ParseOWord(oWord);
+
+	if (IsError())
+	{
+		_oWordState.Depth       = 0;
+		_oWordState.ProgramUsed = _oWordState.SubUsed;
+		return true;
+	}
+
+	if (_oWordState.Depth == 0)
+	{
+		if (!isOWord)
+		{
+			return false;
+		}
+
+		switch (oWord.Keyword)
+		{
+			case OWordCall:
+			{
+				OWordExecute(OWORD_ENDPC, &oWord);
+				break;
+			}
+			case OWordSub:
+			case OWordDo:
+			case OWordWhile:
+			case OWordRepeat:
+			case OWordIf:
+			{
+				OWordRecord(line, oWord, isOWord);
+				break;
+			}
+			default:
+			{
+				Error(MESSAGE_GCODE_OWordUnexpected);
+				break;
+			}
+		}
+	}
+	else
+	{
+		OWordRecord(line, oWord, isOWord);
+	}
+
+	_reader->ResetBuffer(line);
+	_reader->MoveToEnd();
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::ParseOWord(SOWord& oWord)
+{
+	// O-word line: [N<linenumber>] O<n> keyword ...
+
+	const char* start = _reader->GetBuffer();
+	char        ch    = _reader->SkipSpacesToUpper();
+
+	if (ch == 'N' && IsUInt(_reader->GetNextChar()))
+	{
+		GetUInt32();
+		ch = _reader->SkipSpacesToUpper();
+	}
+
+	if (ch != 'O')
+	{
+		_reader->ResetBuffer(start);
+		return false;
+	}
+
+	if (!IsUInt(_reader->GetNextChar()))
+	{
+		Error(MESSAGE_GCODE_OWordUnknown);
+		return true;
+	}
+
+	oWord.ONum = GetUInt16();
+	_reader->SkipSpaces();
+
+	// @formatter:off — disable formatter after this line
+	if (IsToken(F("SUB"), true, true))				{ oWord.Keyword = OWordSub; }
+	else if (IsToken(F("ENDSUB"), true, true))		{ oWord.Keyword = OWordEndSub; }
+	else if (IsToken(F("RETURN"), true, true))		{ oWord.Keyword = OWordReturn; }
+	else if (IsToken(F("CALL"), true, true))		{ oWord.Keyword = OWordCall; }
+	else if (IsToken(F("DO"), true, true))			{ oWord.Keyword = OWordDo; }
+	else if (IsToken(F("WHILE"), true, true))		{ oWord.Keyword = OWordWhile; }
+	else if (IsToken(F("ENDWHILE"), true, true))	{ oWord.Keyword = OWordEndWhile; }
+	else if (IsToken(F("REPEAT"), true, true))		{ oWord.Keyword = OWordRepeat; }
+	else if (IsToken(F("ENDREPEAT"), true, true))	{ oWord.Keyword = OWordEndRepeat; }
+	else if (IsToken(F("IF"), true, true))			{ oWord.Keyword = OWordIf; }
+	else if (IsToken(F("ELSEIF"), true, true))		{ oWord.Keyword = OWordElseIf; }
+	else if (IsToken(F("ELSE"), true, true))		{ oWord.Keyword = OWordElse; }
+	else if (IsToken(F("ENDIF"), true, true))		{ oWord.Keyword = OWordEndIf; }
+	else if (IsToken(F("BREAK"), true, true))		{ oWord.Keyword = OWordBreak; }
+	else if (IsToken(F("CONTINUE"), true, true))	{ oWord.Keyword = OWordContinue; }
+	else											{ Error(MESSAGE_GCODE_OWordUnknown); }
+	// @formatter:on — enable formatter after this line
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordRecord(char* line, const SOWord& oWord, bool isOWord)
+{
+	// append line to program, execute (or keep sub) if the outermost block is closed
+
+	auto size = uint16_t(strlen(line) + 1);
+	auto pc   = _oWordState.ProgramUsed;
+
+	if (pc + size > OWORD_PROGRAMSIZE)
+	{
+		Error(MESSAGE_GCODE_OWordProgramFull);
+	}
+	else if (isOWord)
+	{
+		SOWordFrame*       top = _oWordState.Depth > 0 ? &_oWordState.Frame[_oWordState.Depth - 1] : nullptr;
+		EnumAsByte(EOWord) open;
+
+		switch (oWord.Keyword)
+		{
+			case OWordSub:			open = top == nullptr ? OWordSub : OWordEndSub;	break;		// no nested sub
+			case OWordWhile:		open = top != nullptr && top->ONum == oWord.ONum && top->Keyword == OWordDo ? OWordDo : OWordWhile;	break;
+			case OWordEndSub:		open = OWordSub;	break;
+			case OWordEndWhile:		open = OWordWhile;	break;
+			case OWordEndRepeat:	open = OWordRepeat;	break;
+			case OWordEndIf:
+			case OWordElseIf:
+			case OWordElse:			open = OWordIf;		break;
+			default:				open = oWord.Keyword;	break;
+		}
+
+		switch (oWord.Keyword)
+		{
+			case OWordDo:
+			case OWordRepeat:
+			case OWordIf:
+			case OWordSub:
+			case OWordWhile:
+			{
+				if (open == oWord.Keyword)
+				{
+					OWordPush(oWord.ONum, pc, oWord.Keyword);
+				}
+				else if (open == OWordDo)
+				{
+					_oWordState.Depth--;			// while of do .. while, top is the do (see open)
+				}
+				else
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+				}
+				break;
+			}
+			case OWordEndSub:
+			case OWordEndWhile:
+			case OWordEndRepeat:
+			case OWordEndIf:
+			case OWordElseIf:
+			case OWordElse:
+			{
+				if (top == nullptr || top->ONum != oWord.ONum || top->Keyword != open)
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+				}
+				else if (oWord.Keyword != OWordElseIf && oWord.Keyword != OWordElse)
+				{
+					_oWordState.Depth--;
+				}
+				break;
+			}
+			default: break;
+		}
+	}
+
+	if (IsError())
+	{
+		_oWordState.Depth       = 0;
+		_oWordState.ProgramUsed = _oWordState.SubUsed;
+		return;
+	}
+
+	memcpy(&_oWordState.Program[pc], line, size);
+	_oWordState.ProgramUsed += size;
+
+	if (_oWordState.Depth == 0)
+	{
+		if (oWord.Keyword == OWordEndSub)
+		{
+			OWordAddSub(oWord.ONum);
+		}
+		else
+		{
+			OWordExecute(_oWordState.SubUsed, nullptr);
+			_oWordState.ProgramUsed = _oWordState.SubUsed;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordAddSub(uint16_t oNum)
+{
+	// recorded sub is at [SubUsed..ProgramUsed), remove a previous definition
+
+	uint8_t subIdx = OWordFindSub(oNum);
+	if (subIdx != 255)
+	{
+		SOWordSub old  = _oWordState.Sub[subIdx];
+		auto      size = uint16_t(old.End - old.Pc);
+
+		memmove(&_oWordState.Program[old.Pc], &_oWordState.Program[old.End], _oWordState.ProgramUsed - old.End);
+		_oWordState.ProgramUsed -= size;
+		_oWordState.SubUsed -= size;
+
+		_oWordState.SubCount--;
+		for (uint8_t i = subIdx; i < _oWordState.SubCount; i++)
+		{
+			_oWordState.Sub[i] = _oWordState.Sub[i + 1];
+			_oWordState.Sub[i].Pc -= size;
+			_oWordState.Sub[i].End -= size;
+		}
+	}
+
+	if (_oWordState.SubCount >= OWORD_MAXSUB)
+	{
+		Error(MESSAGE_GCODE_OWordProgramFull);
+		_oWordState.ProgramUsed = _oWordState.SubUsed;
+		return;
+	}
+
+	SOWordSub& sub = _oWordState.Sub[_oWordState.SubCount++];
+	sub.ONum       = oNum;
+	sub.Pc         = _oWordState.SubUsed;
+	sub.End        = _oWordState.ProgramUsed;
+
+	_oWordState.SubUsed = _oWordState.ProgramUsed;
+}
+
+////////////////////////////////////////////////////////////
+
+uint8_t CGCodeParser::OWordFindSub(uint16_t oNum)
+{
+	for (uint8_t i = 0; i < _oWordState.SubCount; i++)
+	{
+		if (_oWordState.Sub[i].ONum == oNum)
+		{
+			return i;
+		}
+	}
+	return 255;
+}
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::OWordPush(uint16_t oNum, uint16_t pc, EnumAsByte(EOWord) keyword)
+{
+	if (_oWordState.Depth >= OWORD_MAXDEPTH)
+	{
+		Error(MESSAGE_GCODE_OWordNestingTooDeep);
+		return false;
+	}
+
+	SOWordFrame& frame = _oWordState.Frame[_oWordState.Depth++];
+	frame.ONum         = oNum;
+	frame.Pc           = pc;
+	frame.Count        = 0;
+	frame.Keyword      = keyword;
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+expr_t CGCodeParser::OWordExpression()
+{
+	expr_t value = 0;
+
+	if (_reader->SkipSpaces() != '[')
+	{
+		Error(MESSAGE_GCODE_OWordExpressionExpected);
+	}
+	else if (ParseExpression(value))
+	{
+		ExpectEndOfCommand();
+	}
+
+	return IsError() ? 0 : value;
+}
+
+////////////////////////////////////////////////////////////
+
+uint16_t CGCodeParser::OWordFind(uint16_t pc, uint16_t oNum, SOWord& oWord)
+{
+	// next O-word line with oNum, reader is after the keyword
+
+	while (pc < _oWordState.ProgramUsed)
+	{
+		_reader->ResetBuffer(&_oWordState.Program[pc]);
+		if (ParseOWord(oWord) && oWord.ONum == oNum)
+		{
+			return IsError() ? OWORD_ENDPC : pc;
+		}
+		pc = OWordNextLine(pc);
+	}
+
+	Error(MESSAGE_GCODE_OWordUnexpected);
+	return OWORD_ENDPC;
+}
+
+uint16_t CGCodeParser::OWordFind(uint16_t pc, uint16_t oNum, EnumAsByte(EOWord) keyword)
+{
+	SOWord oWord;
+	for (pc = OWordFind(pc, oNum, oWord); !IsError() && oWord.Keyword != keyword; pc = OWordFind(OWordNextLine(pc), oNum, oWord)) {}
+	return pc;
+}
+
+////////////////////////////////////////////////////////////
+
+uint16_t CGCodeParser::OWordCallSub(const SOWord& oWord, uint16_t returnPc)
+{
+	// O<n> call [arg1] [arg2] ... => #1 = arg1, #2 = arg2
+	// all arguments are evaluated first (with #1, #2, ... of the caller), the values of the caller are saved in Arg (see OWordPopFrame)
+
+	uint8_t subIdx = OWordFindSub(oWord.ONum);
+	if (subIdx == 255)
+	{
+		Error(MESSAGE_GCODE_OWordSubNotDefined);
+		return OWORD_ENDPC;
+	}
+
+	uint8_t argStart = _oWordState.ArgUsed;
+	while (_reader->SkipSpaces() == '[')
+	{
+		expr_t value;
+		if (_oWordState.ArgUsed >= OWORD_MAXARG)
+		{
+			Error(MESSAGE_GCODE_OWordTooManyArguments);
+		}
+		else if (ParseExpression(value))
+		{
+			_oWordState.Arg[_oWordState.ArgUsed++] = value;
+			continue;
+		}
+		_oWordState.ArgUsed = argStart;
+		return OWORD_ENDPC;
+	}
+
+	if (!ExpectEndOfCommand() || !OWordPush(oWord.ONum, returnPc, OWordCall))
+	{
+		_oWordState.ArgUsed = argStart;
+		return OWORD_ENDPC;
+	}
+
+	_oWordState.Frame[_oWordState.Depth - 1].Count = uint16_t(_oWordState.ArgUsed - argStart);
+
+	for (uint8_t i = argStart; i < _oWordState.ArgUsed; i++)
+	{
+		auto    paramNo  = param_t(i - argStart + 1);
+		uint8_t paramIdx = ParamNoToParamIdx(paramNo);
+		float   value    = _oWordState.Arg[i];
+
+		_oWordState.Arg[i] = paramIdx != 255 ? _modalState.Parameter[paramIdx] : 0.0f;
+		SetUserParamValue(paramNo, value);
+	}
+
+	return OWordNextLine(_oWordState.Sub[subIdx].Pc);		// skip "O<n> sub"
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordPopFrame()
+{
+	SOWordFrame& frame = _oWordState.Frame[--_oWordState.Depth];
+
+	if (frame.Keyword == OWordCall)
+	{
+		_oWordState.ArgUsed -= uint8_t(frame.Count);
+		for (uint8_t i = 0; i < frame.Count; i++)
+		{
+			SetUserParamValue(param_t(i + 1), _oWordState.Arg[_oWordState.ArgUsed + i]);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordExecute(uint16_t pc, const SOWord* call)
+{
+	// execute program (from pc or call of sub) until the end of the recorded block (or return of call)
+
+	_oWordState.Executing = true;
+
+	uint16_t linePc = OWORD_ENDPC;
+
+	if (call != nullptr)
+	{
+		pc = OWordCallSub(*call, OWORD_ENDPC);
+	}
+
+	while (pc < _oWordState.ProgramUsed && !CheckError())
+	{
+		if (CControl::GetInstance()->IsKilled())
+		{
+			Error(MESSAGE_CONTROL_KILLED);
+			break;
+		}
+
+		linePc = pc;
+		pc     = OWordNextLine(linePc);
+
+		_reader->ResetBuffer(&_oWordState.Program[linePc]);
+
+		SOWord oWord;
+		if (!ParseOWord(oWord))
+		{
+			if (InitParse())
+			{
+				Parse();
+			}
+			CleanupParse();
+			if (_OkMessage != nullptr)
+			{
+				// output of the line (e.g. M114) without "ok", only "ok" of the line (closing the block) is sent
+				_OkMessage();
+				StepperSerial.println();
+				_OkMessage = nullptr;
+			}
+			continue;
+		}
+
+		if (IsError())
+		{
+			break;
+		}
+
+		SOWordFrame* top = _oWordState.Depth > 0 ? &_oWordState.Frame[_oWordState.Depth - 1] : nullptr;
+		bool         isTop = top != nullptr && top->ONum == oWord.ONum;
+
+		switch (oWord.Keyword)
+		{
+			case OWordEndSub:
+			case OWordReturn:
+			{
+				while (_oWordState.Depth > 0 && _oWordState.Frame[_oWordState.Depth - 1].Keyword != OWordCall)
+				{
+					_oWordState.Depth--;
+				}
+				if (_oWordState.Depth == 0)
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+					break;
+				}
+				pc = _oWordState.Frame[_oWordState.Depth - 1].Pc;
+				OWordPopFrame();
+				break;
+			}
+			case OWordCall:
+			{
+				pc = OWordCallSub(oWord, pc);
+				break;
+			}
+			case OWordDo:
+			{
+				OWordPush(oWord.ONum, pc, OWordDo);
+				break;
+			}
+			case OWordWhile:
+			{
+				bool condition = OWordExpression() != 0;
+				if (isTop && top->Keyword == OWordDo)
+				{
+					// end of do .. while
+					if (condition)
+					{
+						pc = top->Pc;
+					}
+					else
+					{
+						_oWordState.Depth--;
+					}
+				}
+				else if (condition)
+				{
+					if (!isTop)
+					{
+						OWordPush(oWord.ONum, linePc, OWordWhile);
+					}
+				}
+				else
+				{
+					if (isTop)
+					{
+						_oWordState.Depth--;
+					}
+					pc = OWordNextLine(OWordFind(pc, oWord.ONum, OWordEndWhile));
+				}
+				break;
+			}
+			case OWordEndWhile:
+			{
+				if (!isTop)
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+					break;
+				}
+				pc = top->Pc;						// test condition again
+				break;
+			}
+			case OWordRepeat:
+			{
+				expr_t count = OWordExpression();
+				if (count >= 1)
+				{
+					if (OWordPush(oWord.ONum, pc, OWordRepeat))
+					{
+						_oWordState.Frame[_oWordState.Depth - 1].Count = uint16_t(count);
+					}
+				}
+				else if (!IsError())
+				{
+					pc = OWordNextLine(OWordFind(pc, oWord.ONum, OWordEndRepeat));
+				}
+				break;
+			}
+			case OWordEndRepeat:
+			{
+				if (!isTop)
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+				}
+				else if (--top->Count > 0)
+				{
+					pc = top->Pc;
+				}
+				else
+				{
+					_oWordState.Depth--;
+				}
+				break;
+			}
+			case OWordIf:
+			{
+				if (OWordExpression() == 0 && !IsError())
+				{
+					// find branch: elseif (with true condition), else or endif
+					SOWord branch;
+					do
+					{
+						pc = OWordFind(pc, oWord.ONum, branch);
+						pc = OWordNextLine(pc);
+					}
+					while (!IsError() && branch.Keyword != OWordEndIf && branch.Keyword != OWordElse && (branch.Keyword != OWordElseIf || OWordExpression() == 0));
+				}
+				break;
+			}
+			case OWordElseIf:
+			case OWordElse:
+			{
+				// end of executed branch
+				pc = OWordNextLine(OWordFind(pc, oWord.ONum, OWordEndIf));
+				break;
+			}
+			case OWordEndIf: break;
+			case OWordBreak:
+			case OWordContinue:
+			{
+				while (_oWordState.Depth > 0 && _oWordState.Frame[_oWordState.Depth - 1].ONum != oWord.ONum && _oWordState.Frame[_oWordState.Depth - 1].Keyword != OWordCall)
+				{
+					_oWordState.Depth--;
+				}
+
+				SOWordFrame* loop = _oWordState.Depth > 0 ? &_oWordState.Frame[_oWordState.Depth - 1] : nullptr;
+				if (loop == nullptr || loop->ONum != oWord.ONum || loop->Keyword == OWordCall)
+				{
+					Error(MESSAGE_GCODE_OWordUnexpected);
+					break;
+				}
+
+				EnumAsByte(EOWord) end = loop->Keyword == OWordWhile ? OWordEndWhile : (loop->Keyword == OWordRepeat ? OWordEndRepeat : OWordWhile);
+
+				if (oWord.Keyword == OWordBreak)
+				{
+					_oWordState.Depth--;
+					pc = OWordNextLine(OWordFind(pc, oWord.ONum, end));
+				}
+				else if (loop->Keyword == OWordWhile)
+				{
+					pc = loop->Pc;
+				}
+				else
+				{
+					pc = OWordFind(pc, oWord.ONum, end);	// execute endrepeat or while of do
+				}
+				break;
+			}
+			default:
+			{
+				Error(MESSAGE_GCODE_OWordUnexpected);
+				break;
+			}
+		}
+	}
+
+	if (IsError() && linePc != OWORD_ENDPC)
+	{
+		_errorLine = &_oWordState.Program[linePc];		// e.g. condition of "O<n> while", not the line closing the block
+	}
+
+	while (_oWordState.Depth > 0)
+	{
+		OWordPopFrame();
+	}
+
+	_oWordState.Executing = false;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParser::PrintAbsPosition()
 {
 	PrintPosition([](axis_t axis) { return CMotionControlBase::GetInstance()->GetPosition(axis); });
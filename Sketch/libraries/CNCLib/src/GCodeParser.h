@@ -20,6 +20,7 @@
 
 #include "GCodeParserBase.h"
 #include "GCodeTools.h"
+#include "CutterRadiusCompensation.h"
 
 ////////////////////////////////////////////////////////
 
@@ -60,6 +61,9 @@ typedef uint16_t param_t;
 // g73 retraction
 #define G73RETRACTION			200			// mm1000_t => 0.2mm
 
+// O-word
+#define OWORD_ENDPC				0xffff		// pc of O-word program: end
+
 ////////////////////////////////////////////////////////
 
 class CGCodeParser : public CGCodeParserBase
@@ -83,11 +87,16 @@ public:
 
 	static mm1000_t GetAllPreset(axis_t axis) { return GetG92PosPreset(axis) + GetG54PosPreset(axis) + GetToolHeightPosPreset(axis); }
 
+	static void Abort() { _modalState.CutterRadiusCompensation = SModalState::CutterRadiusOff; }		// program aborted (kill), drop the held back segment of cutter radius compensation
+
 	static void Init()
 	{
 		super::Init();
 		_modalState.Init();
 		_modelessState.Init();
+#ifdef OWORD_PROGRAMSIZE
+		_oWordState.Init();
+#endif
 	}
 
 	static void InitAndSetFeedRate(feedrate_t feedrateG0, feedrate_t feedrateG1, feedrate_t feedrateG1max)
@@ -98,6 +107,9 @@ public:
 
 protected:
 
+#ifdef OWORD_PROGRAMSIZE
+	virtual void Parse() override;
+#endif
 	virtual bool InitParse() override;
 	virtual void CleanupParse() override;
 
@@ -112,6 +124,15 @@ protected:
 	virtual void     CommentMessage(char* ) override;
 	virtual mm1000_t CalcAllPreset(axis_t axis) override;
 
+	virtual void GetMovePosition(mm1000_t pos[NUM_AXIS]) override;
+	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate) override;
+	virtual void MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate) override;
+
+	virtual void Wait(uint32_t ms) override;
+	virtual void WaitClock(uint32_t clock) override;
+	virtual void CallIOControl(uint8_t io, uint16_t value) override;
+	virtual void CallMoveIOControl(uint8_t io, uint16_t value) override;
+
 protected:
 
 	////////////////////////////////////////////////////////
@@ -147,7 +168,7 @@ protected:
 		mm1000_t ToolHeigtCompensation;
 
 		float   Parameter[NUM_PARAMETER];		// this is a expression, mm or inch
-		uint8_t ParamNoToIdx[NUM_PARAMETER];
+		param_t ParamNo[NUM_PARAMETER];			// hash table (open addressing, see ParamNoToParamIdx), 0 => free slot
 
 		void Init()
 		{
@@ -181,6 +202,101 @@ protected:
 
 	static SModelessState _modelessState;
 
+	static CCutterRadiusCompensation _cutterRadiusCompensation;
+
+#ifdef OWORD_PROGRAMSIZE
+
+	////////////////////////////////////////////////////////
+	// O-word control flow (see linuxcnc): 
+	//	O<n> sub/endsub/return/call, O<n> while/endwhile, O<n> do/while, O<n> repeat/endrepeat, O<n> if/elseif/else/endif, O<n> break/continue
+	// Lines of a block are recorded (not executed) until the outermost block is closed, then the block is executed from memory.
+	// Subs are kept in memory (until redefined), arguments of call are assigned to #1, #2, ... (no local parameters), the values of the caller are restored by endsub/return
+
+	enum EOWord
+	{
+		OWordSub,
+		OWordEndSub,
+		OWordReturn,
+		OWordCall,
+		OWordDo,
+		OWordWhile,
+		OWordEndWhile,
+		OWordRepeat,
+		OWordEndRepeat,
+		OWordIf,
+		OWordElseIf,
+		OWordElse,
+		OWordEndIf,
+		OWordBreak,
+		OWordContinue
+	};
+
+	struct SOWord
+	{
+		uint16_t           ONum;
+		EnumAsByte(EOWord) Keyword;
+	};
+
+	struct SOWordFrame							// open block (recording) or active loop/call (executing)
+	{
+		uint16_t           ONum;
+		uint16_t           Pc;					// recording: opening line, while: while line, do/repeat: first line of body, call: return
+		uint16_t           Count;				// repeat: loops left, call: number of arguments (saved values in SOWordState::Arg)
+		EnumAsByte(EOWord) Keyword;
+	};
+
+	struct SOWordSub
+	{
+		uint16_t ONum;
+		uint16_t Pc;							// "O<n> sub" line
+		uint16_t End;							// after "O<n> endsub" line
+	};
+
+	struct SOWordState
+	{
+		char     Program[OWORD_PROGRAMSIZE];	// '\0' terminated lines: subs [0..SubUsed), recorded block [SubUsed..ProgramUsed)
+		uint16_t ProgramUsed;
+		uint16_t SubUsed;
+
+		SOWordSub Sub[OWORD_MAXSUB];
+		uint8_t   SubCount;
+
+		SOWordFrame Frame[OWORD_MAXDEPTH];
+		uint8_t     Depth;
+		bool        Executing;
+
+		float   Arg[OWORD_MAXARG];				// #1, #2, ... of the callers (stack of the call frames)
+		uint8_t ArgUsed;
+
+		void Init()
+		{
+			ProgramUsed = SubUsed = 0;
+			SubCount    = 0;
+			Depth       = 0;
+			Executing   = false;
+			ArgUsed     = 0;
+		}
+	};
+
+	static SOWordState _oWordState;
+
+	bool     OWordParse();					// true if line is handled (O-word or recorded)
+	bool     ParseOWord(SOWord& oWord);		// false if line is no O-word line, else reader is after keyword
+	void     OWordRecord(char* line, const SOWord& oWord, bool isOWord);
+	void     OWordExecute(uint16_t pc, const SOWord* call);
+	uint16_t OWordCallSub(const SOWord& oWord, uint16_t returnPc);
+	void     OWordPopFrame();				// restore the arguments of the caller if the frame is a call
+	expr_t   OWordExpression();
+	bool     OWordPush(uint16_t oNum, uint16_t pc, EnumAsByte(EOWord) keyword);
+	uint16_t OWordFind(uint16_t pc, uint16_t oNum, SOWord& oWord);
+	uint16_t OWordFind(uint16_t pc, uint16_t oNum, EnumAsByte(EOWord) keyword);
+	uint16_t OWordNextLine(uint16_t pc) { return pc >= _oWordState.ProgramUsed ? OWORD_ENDPC : uint16_t(pc + strlen(&_oWordState.Program[pc]) + 1); }
+	void     OWordAddSub(uint16_t oNum);
+
+	static uint8_t OWordFindSub(uint16_t oNum);	// 255 if not found
+
+#endif
+
 	////////////////////////////////////////////////////////
 	// Parser structure
 
@@ -194,14 +310,27 @@ protected:
 		else return false;
 	}
 
+	void CutterRadiusFlush()
+	{
+		if (_modalState.CutterRadiusCompensation)
+		{
+			_cutterRadiusCompensation.Flush();
+		}
+	}
+
 	virtual bool GetParamOrExpression(mm1000_t*, bool convertToInch) override;
 	mm1000_t     ParseParameter(bool           convertToInch);
 	param_t      ParseParamNo();
 
+	bool     ParseExpression(expr_t& answer);				// [expression], false on error
 	mm1000_t GetParamValue(param_t paramNo, bool convertToInch);
 	void     SetParamValue(param_t paramNo);
+	void     SetUserParamValue(param_t paramNo, float value);	// paramNo must be IsModifyParam
 
-	static uint8_t ParamNoToParamIdx(param_t paramNo);
+	static uint8_t ParamHash(param_t paramNo) { return uint8_t(uint16_t(paramNo * 40503u) >> 8) & (NUM_PARAMETER - 1); }	// Fibonacci hashing
+	static uint8_t ParamNoToParamIdx(param_t paramNo);		// 255 if not found
+	static uint8_t AddParam(param_t paramNo);				// 255 if no slot available
+	static void    RemoveParam(uint8_t paramIdx);
 
 	static mm1000_t GetParamAsMm1000(mm1000_t   posMm100, axis_t     ) { return posMm100; }
 	static mm1000_t GetParamAsPosition(mm1000_t posInMachine, axis_t axis) { return CMotionControlBase::GetInstance()->ToMm1000(axis, posInMachine); }
@@ -223,9 +352,10 @@ private:
 
 	void G10Command();
 	void G38Command();
-	void G40Command() { _modalState.CutterRadiusCompensation = SModalState::CutterRadiusOff; }
-	void G41Command();		// Cutter Radius Compensation left
-	void G42Command();		// Cutter Radius Compensation right
+	void G40Command();
+	void G41Command() { G4142Command(true); }		// Cutter Radius Compensation left
+	void G42Command() { G4142Command(false); }		// Cutter Radius Compensation right
+	void G4142Command(bool isLeft);
 	void G43Command();		// Tool Height Compensation 
 	void G49Command() { _modalState.ToolHeigtCompensation = 0; }
 	void G53Command();
@@ -245,6 +375,7 @@ private:
 	void G98Command() { _modalState.IsG98 = true; }
 	void G99Command() { _modalState.IsG98 = false; }
 
+	static void StopProgram(uint32_t checkConditional, uint32_t);	// Sync and stop, see M00/M01
 	void M00Command();		// Compulsory stop
 	void M01Command();		// Optional stop
 	void M02Command();		// End of program
@@ -255,8 +386,13 @@ private:
 	void M31Command();      // Print time since start
 	void M110Command();
 	void M111Command();		// Set debug level
+	void M113Command();		// Character counting and real-time '?','!','~' (streaming) on/off
 	void M114Command();		// Report Position
+#ifdef STEPPER_STATUS
+	void M408Command();		// Report status (compact)
+#endif
 
+	void M170Command();		// Raster scanline (laser engraving)
 	void M220Command();		// Set Speed override
 	void M300Command();		// Play Song
 
@@ -310,9 +446,9 @@ protected:
 	void PrintParamValue(const SParamInfo* item, axis_t ofs);
 	void PrintParamValue(param_t           paramNo);
 
-	static const struct SParamInfo _paramDef[] PROGMEM;
+	static const struct SParamInfo _paramDef[] PROGMEM;	// sorted by paramNo
+	static const uint8_t           _paramDefByText[] PROGMEM;	// index of _paramDef sorted by text
 
-	static const SParamInfo* FindParamInfo(uintptr_t         param, bool (*check)(const SParamInfo*, uintptr_t));
 	static const SParamInfo* FindParamInfoByText(const char* text);
 	static const SParamInfo* FindParamInfoByParamNo(param_t  paramNo);
 };
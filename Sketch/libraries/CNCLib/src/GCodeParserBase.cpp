@@ -294,7 +294,7 @@ void CGCodeParserBase::MoveStart(bool cutMove, bool needSpindleCallIo)
 			else
 			{
 				needSpindleCallIo = false;
-				CallIOControl(CControl::SpindleCW, 0);
+				CallMoveIOControl(CControl::SpindleCW, 0);
 			}
 		}
 	}
@@ -304,12 +304,33 @@ void CGCodeParserBase::MoveStart(bool cutMove, bool needSpindleCallIo)
 
 	if (needSpindleCallIo)
 	{
-		SpindleCallIOControl();
+		CallMoveIOControl(_modalState.SpindleOnCW ? CControl::SpindleCW : CControl::SpindleCCW, _modalState.SpindleSpeed);
 	}
 }
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParserBase::GetMovePosition(mm1000_t pos[NUM_AXIS])
+{
+	CMotionControlBase::GetInstance()->GetPositions(pos);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParserBase::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	CMotionControlBase::GetInstance()->MoveAbs(to, feedrate);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParserBase::MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate)
+{
+	CMotionControlBase::GetInstance()->Arc(to, offset0, offset1, _modalState.Plane_axis_0, _modalState.Plane_axis_1, isClockwise, feedrate);
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParserBase::ConstantVelocity()
 {
 	if (!_modalState.ConstantVelocity)
@@ -336,6 +357,7 @@ void CGCodeParserBase::WaitClock(uint32_t clock)
 
 void CGCodeParserBase::Sync()
 {
+	CMotionControlBase::GetInstance()->FlushArc();
 	CStepper::GetInstance()->WaitBusy();
 #ifdef _USE_LCD
 	CControl::GetInstance()->Delay(0);
@@ -410,6 +432,7 @@ void CGCodeParserBase::Parse()
 			case 'S':		// spindle/laser speed
 			{
 				_reader->GetNextChar();
+				CMotionControlBase::GetInstance()->FlushArc();
 				if (GetSpindleSpeedCommand())
 				{
 					SpindleCallIOControl();
@@ -470,6 +493,11 @@ void CGCodeParserBase::Parse()
 
 bool CGCodeParserBase::GCommand(uint8_t gcode)
 {
+	if (gcode > 3)
+	{
+		CMotionControlBase::GetInstance()->FlushArc();		// pending arc must be moved first
+	}
+
 	switch (gcode)
 	{
 		// @formatter:off — disable formatter after this line
@@ -500,6 +528,8 @@ bool CGCodeParserBase::GCommand(uint8_t gcode)
 
 bool CGCodeParserBase::MCommand(mcode_t mcode)
 {
+	CMotionControlBase::GetInstance()->FlushArc();
+
 	switch (mcode)
 	{
 		// @formatter:off — disable formatter after this line
@@ -797,7 +827,8 @@ void CGCodeParserBase::G0001Command(bool isG00)
 	bool useG0Feed          = isG00;
 	bool needSpindleCallIo     = false;
 
-	SAxisMove move(true);
+	SAxisMove move(false);
+	GetMovePosition(move.newpos);
 
 	for (char ch = _reader->SkipSpacesToUpper(); ch; ch = _reader->SkipSpacesToUpper())
 	{
@@ -843,7 +874,7 @@ void CGCodeParserBase::G0001Command(bool isG00)
 
 	if (move.axes)
 	{
-		CMotionControlBase::GetInstance()->MoveAbs(move.newpos, useG0Feed ? _modalState.G0FeedRate : _modalState.G1FeedRate);
+		MoveAbs(move.newpos, useG0Feed ? _modalState.G0FeedRate : _modalState.G1FeedRate);
 		ConstantVelocity();
 	}
 }
@@ -854,9 +885,13 @@ void CGCodeParserBase::G0203Command(bool isG02)
 {
 	_modalState.LastCommand = isG02 ? &CGCodeParserBase::G02Command : &CGCodeParserBase::G03Command;
 
-	SAxisMove move(true);
+	SAxisMove move(false);
 	mm1000_t  radius;
 	mm1000_t  offset[2] = { 0, 0 };
+	mm1000_t  current[NUM_AXIS];
+
+	GetMovePosition(current);
+	memcpy(move.newpos, current, sizeof(current));
 
 	bool needSpindleCallIo = false;
 
@@ -915,8 +950,8 @@ void CGCodeParserBase::G0203Command(bool isG02)
 	if (move.bitfield.bit.R)
 	{
 		// Calculate the change in position int32_t each selected axis
-		auto x = float(move.newpos[_modalState.Plane_axis_0] - CMotionControlBase::GetInstance()->GetPosition(_modalState.Plane_axis_0));
-		auto y = float(move.newpos[_modalState.Plane_axis_1] - CMotionControlBase::GetInstance()->GetPosition(_modalState.Plane_axis_1));
+		auto x = float(move.newpos[_modalState.Plane_axis_0] - current[_modalState.Plane_axis_0]);
+		auto y = float(move.newpos[_modalState.Plane_axis_1] - current[_modalState.Plane_axis_1]);
 		auto r = float(radius);
 
 		if (x == 0.0 && y == 0.0)
@@ -952,7 +987,7 @@ void CGCodeParserBase::G0203Command(bool isG02)
 	}
 
 	MoveStart(true, needSpindleCallIo);
-	CMotionControlBase::GetInstance()->Arc(move.newpos, offset[0], offset[1], _modalState.Plane_axis_0, _modalState.Plane_axis_1, isG02, _modalState.G1FeedRate);
+	MoveArc(move.newpos, offset[0], offset[1], isG02, _modalState.G1FeedRate);
 	ConstantVelocity();
 }
 
@@ -1248,6 +1283,13 @@ void CGCodeParserBase::CallIOControl(uint8_t io, uint16_t value)
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParserBase::CallMoveIOControl(uint8_t io, uint16_t value)
+{
+	CStepper::GetInstance()->MoveIoControl(io, value);
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParserBase::M0304Command(bool m3)
 {
 	for (char ch = _reader->SkipSpacesToUpper(); ch; ch = _reader->SkipSpacesToUpper())
@@ -1335,3 +1377,50 @@ void CGCodeParserBase::PrintInfo()
 	PrintPosition([](axis_t axis) { return GetG92PosPreset(axis); });
 	StepperSerial.print('>');
 }
+
+////////////////////////////////////////////////////////////
+
+#ifdef STEPPER_STATUS
+
+void CGCodeParserBase::PrintStatus()
+{
+	CStepper::SStatus status;
+	CStepper::GetInstance()->GetStatus(status);
+
+	mm1000_t pos[NUM_AXIS];
+	CMotionControlBase::GetInstance()->GetPosition(status.Current, pos);
+
+	switch (status.State)
+	{
+		case CStepper::StatusRun: StepperSerial.print(F("<Run"));
+			break;
+		case CStepper::StatusHold: StepperSerial.print(F("<Hold"));
+			break;
+		case CStepper::StatusEmergencyStop: StepperSerial.print(F("<Kill"));
+			break;
+		default: StepperSerial.print(F("<Idle"));
+			break;
+	}
+
+	StepperSerial.print(F("|MPos:"));
+	for (axis_t i = 0; i < NUM_AXIS; i++)
+	{
+		if (i != 0)
+		{
+			StepperSerial.print(':');
+		}
+		PrintPosition(pos[i]);
+	}
+
+	StepperSerial.print(F("|Rate:"));
+	StepperSerial.print(status.GetStepRate());
+	StepperSerial.print(F("|Q:"));
+	StepperSerial.print((unsigned int)status.MovementCount);
+	StepperSerial.print(':');
+	StepperSerial.print((unsigned int)status.StepBufferCount);
+	StepperSerial.print(F("|Ov:"));
+	StepperSerial.print((unsigned int)CStepper::SpeedOverrideToP(status.SpeedOverride));
+	StepperSerial.print('>');
+}
+
+#endif
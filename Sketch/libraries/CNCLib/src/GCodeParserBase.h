@@ -66,10 +66,16 @@ public:
 	static bool IsInch(axis_t axis) { return !IsMm1000() && IsBitSet(_modalState.UnitConvert, axis); }
 
 	static bool IsSpindleOn() { return _modalState.SpindleOn; }
+	static bool IsSpindleOnCW() { return _modalState.SpindleOnCW; }
 
 	static bool    IsCutMove() { return _modalState.CutMove; }
 	static uint16_t GetSpindleSpeed() { return _modalState.SpindleSpeed; }
 
+	static void PrintInfo();		// "?" and real-time status, see CControl::RealtimeCommand
+#ifdef STEPPER_STATUS
+	static void PrintStatus();		// compact status from CStepper::GetStatus (no CCriticalRegion), e.g. <Run|MPos:1.000:2.000:0.000|Rate:3200|Q:5:16|Ov:100>
+#endif
+
 	static void Init()
 	{
 		super::Init();
@@ -247,9 +253,11 @@ protected:
 
 	////////////////////////////////////////////////////////
 
-	void Sync();									// WaitBusy, sync movement with realtime
-	void Wait(uint32_t ms);							// add "wait" in movement queue
-	void WaitClock(uint32_t clock);					// "wait" until this clock time (see Clock in stepper.h)
+	static void Sync();								// WaitBusy, sync movement with realtime
+
+	// queued with the movements, may be delayed by a derived class (e.g. cutter radius compensation)
+	REDUCED_SIZE_virtual void Wait(uint32_t ms);			// add "wait" in movement queue
+	REDUCED_SIZE_virtual void WaitClock(uint32_t clock);	// "wait" until this clock time (see Clock in stepper.h)
 	void SkipCommentNested();
 
 	void ConstantVelocity();
@@ -298,16 +306,21 @@ protected:
 
 	void GetRadius(SAxisMove& move, mm1000_t& radius);
 
-	void CallIOControl(uint8_t io, uint16_t value);
+	REDUCED_SIZE_virtual void CallIOControl(uint8_t io, uint16_t value);
+	REDUCED_SIZE_virtual void CallMoveIOControl(uint8_t io, uint16_t value);		// io is set at the start of the next move (no stop)
 	bool GetSpindleSpeedCommand();	
 	void SpindleCallIOControl() { CallIOControl(_modalState.SpindleOnCW ? CControl::SpindleCW : CControl::SpindleCCW, _modalState.SpindleSpeed); }
 
 	void MoveStart(bool cutMove, bool needSpindleCallIo);
 
+	// G0 G1 G2 G3, may be modified by a derived class (e.g. cutter radius compensation)
+	REDUCED_SIZE_virtual void GetMovePosition(mm1000_t pos[NUM_AXIS]);	// programmed current position
+	REDUCED_SIZE_virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
+	REDUCED_SIZE_virtual void MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t feedrate);
+
 	void G31Command(bool probevalue);
 	bool ProbeCommand(SAxisMove& move, bool probevalue);
 
-	static void PrintInfo();
 	static void PrintPosition(mm1000_t (*GetPos)(axis_t axis));
 	static void PrintPosition(mm1000_t pos);
 
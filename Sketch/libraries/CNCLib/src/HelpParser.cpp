@@ -22,6 +22,7 @@
 #include "ConfigurationCNCLib.h"
 #include "Control.h"
 #include "HelpParser.h"
+#include "MotionControlBase.h"
 #include "Stepper.h"
 
 ////////////////////////////////////////////////////////////
@@ -30,6 +31,8 @@ void CHelpParser::Parse()
 {
 	_reader->SkipSpaces();
 
+	CMotionControlBase::GetInstance()->FlushArc();		// commands use the stepper direct
+
 	// @formatter:off — disable formatter after this line
 
 	if (IsToken(F("s"), true, false)) { SetSpeed(); return; }
@@ -0,0 +1,221 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <Arduino.h>
+
+#include "CNCLib.h"
+#include "Kinematics.h"
+
+////////////////////////////////////////////////////////
+
+mm1000_t CKinematics::GetSplitMaxDist(feedrate_t feedrate) const
+{
+	if (_segmentsPerSec != 0)
+	{
+		if (feedrate < 0)
+			feedrate = -feedrate;
+
+		mm1000_t dist = feedrate / (60l * _segmentsPerSec);
+		if (dist < _splitMaxDist)
+			return dist;
+	}
+
+	return _splitMaxDist;
+}
+
+////////////////////////////////////////////////////////
+
+#ifdef KINEMATICS_FIXEDPOINT
+
+static mm1000_t SqrtMm1000(uint64_t val)
+{
+	// _ulsqrt_round is 32 bit => sqrt(val/4^n)*2^n
+
+	uint8_t shift = 0;
+	while ((val >> 32) != 0)
+	{
+		val >>= 2;
+		shift++;
+	}
+
+	return mm1000_t(_ulsqrt_round(uint32_t(val)) << shift);
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
+CDeltaKinematics::CDeltaKinematics(mm1000_t diagonalRod, mm1000_t radius)
+{
+	static const int16_t towerAngle[3] = { 210, 330, 90 };
+
+	_diagonalRod = diagonalRod;
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		_towerX[i] = CMm1000::Cast(radius * cosf(towerAngle[i] * float(M_PI / 180.0)));
+		_towerY[i] = CMm1000::Cast(radius * sinf(towerAngle[i] * float(M_PI / 180.0)));
+	}
+
+#ifdef KINEMATICS_FIXEDPOINT
+	_diagonalRod2 = int64_t(diagonalRod) * diagonalRod;
+#else
+	_diagonalRod2 = float(diagonalRod) * float(diagonalRod);
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+bool CDeltaKinematics::ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const
+{
+	// height of the carriage: z + sqrt(rod^2 - horizontal distance^2)
+
+	const mm1000_t x = pos[X_AXIS];
+	const mm1000_t y = pos[Y_AXIS];
+	const mm1000_t z = pos[Z_AXIS];
+
+	for (axis_t i = 0; i < 3; i++)
+	{
+#ifdef KINEMATICS_FIXEDPOINT
+		int64_t dx = x - _towerX[i];
+		int64_t dy = y - _towerY[i];
+		int64_t h2 = _diagonalRod2 - dx * dx - dy * dy;
+
+		if (h2 < 0)
+			return false;
+
+		joint[i] = z + SqrtMm1000(uint64_t(h2));
+#else
+		auto  dx = float(x - _towerX[i]);
+		auto  dy = float(y - _towerY[i]);
+		float h2 = _diagonalRod2 - dx * dx - dy * dy;
+
+		if (h2 < 0.0f)
+			return false;
+
+		joint[i] = z + CMm1000::Cast(sqrtf(h2));
+#endif
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+void CDeltaKinematics::FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const
+{
+	// intersection of the spheres (radius diagonalRod) around the rod joints of the carriages (trilateration)
+	// p1 is the origin, ex points to p2, ey is in the plane of p1, p2 and p3 => the effector is below the plane (-ez)
+
+	float p1[3] = { float(_towerX[0]), float(_towerY[0]), float(joint[X_AXIS]) };
+	float p2[3] = { float(_towerX[1]), float(_towerY[1]), float(joint[Y_AXIS]) };
+	float p3[3] = { float(_towerX[2]), float(_towerY[2]), float(joint[Z_AXIS]) };
+
+	float   ex[3], ey[3], ez[3];
+	uint8_t n;
+
+	for (n = 0; n < 3; n++)
+	{
+		ex[n] = p2[n] - p1[n];
+	}
+
+	float d = sqrtf(ex[0] * ex[0] + ex[1] * ex[1] + ex[2] * ex[2]);
+
+	for (n = 0; n < 3; n++)
+	{
+		ex[n] /= d;
+	}
+
+	float i = ex[0] * (p3[0] - p1[0]) + ex[1] * (p3[1] - p1[1]) + ex[2] * (p3[2] - p1[2]);
+
+	for (n = 0; n < 3; n++)
+	{
+		ey[n] = p3[n] - p1[n] - i * ex[n];
+	}
+
+	float j = sqrtf(ey[0] * ey[0] + ey[1] * ey[1] + ey[2] * ey[2]);
+
+	for (n = 0; n < 3; n++)
+	{
+		ey[n] /= j;
+	}
+
+	ez[0] = ex[1] * ey[2] - ex[2] * ey[1];
+	ez[1] = ex[2] * ey[0] - ex[0] * ey[2];
+	ez[2] = ex[0] * ey[1] - ex[1] * ey[0];
+
+	// same radius of all spheres
+
+	float x  = d / 2.0f;
+	float y  = ((i * i + j * j) / 2.0f - i * x) / j;
+	float z2 = float(_diagonalRod) * float(_diagonalRod) - x * x - y * y;
+	float z  = z2 > 0.0f ? sqrtf(z2) : 0.0f;
+
+	for (n = 0; n < 3; n++)
+	{
+		pos[n] = CMm1000::Cast(p1[n] + x * ex[n] + y * ey[n] - z * ez[n]);
+	}
+}
+
+////////////////////////////////////////////////////////
+
+CScaraKinematics::CScaraKinematics(mm1000_t arm1, mm1000_t arm2)
+{
+	_arm1 = float(arm1);
+	_arm2 = float(arm2);
+}
+
+////////////////////////////////////////////////////////
+
+bool CScaraKinematics::ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const
+{
+	auto x = float(pos[X_AXIS]);
+	auto y = float(pos[Y_AXIS]);
+
+	float cos2 = (x * x + y * y - _arm1 * _arm1 - _arm2 * _arm2) / (2.0f * _arm1 * _arm2);
+
+	if (cos2 > 1.0f || cos2 < -1.0f)
+		return false;
+
+	float angle2 = acosf(cos2);
+	float angle1 = atan2f(y, x) - atan2f(_arm2 * sinf(angle2), _arm1 + _arm2 * cos2);
+
+	if (angle1 < -float(M_PI))
+		angle1 += float(2.0 * M_PI);
+
+	joint[X_AXIS] = CMm1000::FromRAD(angle1);
+	joint[Y_AXIS] = CMm1000::FromRAD(angle2);
+	joint[Z_AXIS] = pos[Z_AXIS];
+
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+void CScaraKinematics::FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const
+{
+	float angle1 = CMm1000::DegreeToRAD(joint[X_AXIS]);
+	float angle2 = angle1 + CMm1000::DegreeToRAD(joint[Y_AXIS]);
+
+	pos[X_AXIS] = CMm1000::Cast(_arm1 * cosf(angle1) + _arm2 * cosf(angle2));
+	pos[Y_AXIS] = CMm1000::Cast(_arm1 * sinf(angle1) + _arm2 * sinf(angle2));
+	pos[Z_AXIS] = joint[Z_AXIS];
+}
+
+////////////////////////////////////////////////////////
@@ -0,0 +1,107 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////
+
+#include "ConfigurationCNCLib.h"
+
+////////////////////////////////////////////////////////
+//
+// Kinematics of a non-cartesian machine, see CMotionControlBase::SetKinematics
+//
+// logical-pos (after TransformPosition) <=> joint-pos (machine-mm1000, e.g. height of a delta carriage, 1/1000 degree of a SCARA arm)
+// only X, Y and Z are transformed, the caller copies all other axes
+//
+// CMotionControlBase splits a move where the joint move (linear in machine-pos) leaves the line:
+//		tolerance:		max deviation (mm1000) of the midpoint of a segment (recursive midpoint test, max KINEMATICS_SPLITMAXDEPTH)
+//		maxDist:		max length (mm1000) of a segment, the midpoint test does not detect an S-shaped deviation (not limited by KINEMATICS_SPLITMAXDEPTH)
+//		segmentsPerSec:	max length of a segment by time (feedrate), 0 => off
+//
+class CKinematics
+{
+public:
+
+	virtual bool ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const = 0;	// inverse, false if pos is not reachable
+	virtual void FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const = 0;	// forward
+
+	void SetSplit(mm1000_t tolerance, mm1000_t maxDist, uint8_t segmentsPerSec)
+	{
+		_splitTolerance = tolerance;
+		_splitMaxDist   = maxDist;
+		_segmentsPerSec = segmentsPerSec;
+	}
+
+	mm1000_t GetSplitTolerance() const { return _splitTolerance; }
+	mm1000_t GetSplitMaxDist(feedrate_t feedrate) const;
+
+private:
+
+	mm1000_t _splitTolerance = KINEMATICS_SPLITTOLERANCE;
+	mm1000_t _splitMaxDist   = KINEMATICS_SPLITMAXDIST;
+	uint8_t  _segmentsPerSec = 0;
+};
+
+////////////////////////////////////////////////////////
+//
+// linear delta: towers at 210 (X), 330 (Y) and 90 (Z) degree, joint-pos is the height of the carriage above the effector at z=0
+// KINEMATICS_FIXEDPOINT: ToJoint with int64 and integer sqrt (no FPU), FromJoint is float
+//
+class CDeltaKinematics : public CKinematics
+{
+public:
+
+	CDeltaKinematics(mm1000_t diagonalRod, mm1000_t radius);		// radius: horizontal distance of the rod joints (effector center to carriage)
+
+	virtual bool ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const override;
+	virtual void FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const override;
+
+private:
+
+	mm1000_t _diagonalRod;
+	mm1000_t _towerX[3];
+	mm1000_t _towerY[3];
+
+#ifdef KINEMATICS_FIXEDPOINT
+	int64_t _diagonalRod2;
+#else
+	float _diagonalRod2;
+#endif
+};
+
+////////////////////////////////////////////////////////
+//
+// SCARA: arm 1 rotates around the Z axis (X=0,Y=0), arm 2 at the end of arm 1
+// joint-pos X: angle of arm 1 (from X axis), Y: angle of arm 2 relative to arm 1 (>= 0, counterclockwise), 1/1000 degree, Z is linear
+// float only (trigonometric functions)
+//
+class CScaraKinematics : public CKinematics
+{
+public:
+
+	CScaraKinematics(mm1000_t arm1, mm1000_t arm2);
+
+	virtual bool ToJoint(const mm1000_t pos[NUM_AXIS], mm1000_t joint[NUM_AXIS]) const override;
+	virtual void FromJoint(const mm1000_t joint[NUM_AXIS], mm1000_t pos[NUM_AXIS]) const override;
+
+private:
+
+	float _arm1;
+	float _arm2;
+};
+
+////////////////////////////////////////////////////////
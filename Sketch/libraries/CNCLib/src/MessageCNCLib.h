@@ -94,5 +94,15 @@
 #define MESSAGE_GCODE_IJKVECTORIS0					StepperMessage("3E","Vector IJK is 0")
 #define MESSAGE_GCODE_SPECIFIED						StepperMessage("3F","IJK is specified")
 #define MESSAGE_GCODE_G90OR91						StepperMessage("40","G90 or G91 expected")
+#define MESSAGE_GCODE_InvalidRasterData				StepperMessage("41","invalid raster data")
+#define MESSAGE_GCODE_OWordUnknown					StepperMessage("42","unknown O-word")
+#define MESSAGE_GCODE_OWordUnexpected				StepperMessage("43","O-word not expected")
+#define MESSAGE_GCODE_OWordProgramFull				StepperMessage("44","O-word program memory full")
+#define MESSAGE_GCODE_OWordNestingTooDeep			StepperMessage("45","O-word nesting too deep")
+#define MESSAGE_GCODE_OWordSubNotDefined			StepperMessage("46","O-word sub not defined")
+#define MESSAGE_GCODE_OWordExpressionExpected		StepperMessage("47","O-word [expression] expected")
+#define MESSAGE_GCODE_OWordTooManyArguments			StepperMessage("4A","O-word too many call arguments")
+#define MESSAGE_GCODE_CutterRadiusTooBig			StepperMessage("48","tool radius too big for arc")
+#define MESSAGE_MOTIONCONTROL_Unreachable			StepperMessage("49","position not reachable (kinematics)")
 
 ////////////////////////////////////////////////////////
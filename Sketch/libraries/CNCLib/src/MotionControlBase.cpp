@@ -41,6 +41,13 @@ template <> CMotionControlBase* CSingleton<CMotionControlBase>::_instance = null
 
 void CMotionControlBase::GetPositions(mm1000_t current[NUM_AXIS]) const
 {
+#ifdef ARC_BACKGROUND
+	if (IsArcPending())
+	{
+		memcpy(current, _arc.To, sizeof(_arc.To));
+		return;
+	}
+#endif
 	memcpy(current, _current, sizeof(_current));
 }
 
@@ -48,6 +55,12 @@ void CMotionControlBase::GetPositions(mm1000_t current[NUM_AXIS]) const
 
 mm1000_t CMotionControlBase::GetPosition(axis_t axis) const
 {
+#ifdef ARC_BACKGROUND
+	if (IsArcPending())
+	{
+		return _arc.To[axis];
+	}
+#endif
 	return _current[axis];
 }
 
@@ -62,6 +75,9 @@ void CMotionControlBase::GetPosition(const udist_t src[NUM_AXIS], mm1000_t dest[
 
 void CMotionControlBase::SetPositionFromMachine()
 {
+#ifdef ARC_BACKGROUND
+	_arc.Segment = 0;
+#endif
 	TransformFromMachinePosition(CStepper::GetInstance()->GetPositions(), _current);
 	CLcd::InvalidateLcd();
 }
@@ -70,6 +86,16 @@ void CMotionControlBase::SetPositionFromMachine()
 
 void CMotionControlBase::TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
 {
+#ifdef KINEMATICS
+	if (_kinematics != nullptr)
+	{
+		mm1000_t joint[NUM_AXIS];
+		ToMm1000(src, joint);
+		memcpy(dest, joint, sizeof(joint));
+		_kinematics->FromJoint(joint, dest);
+		return;
+	}
+#endif
 	ToMm1000(src, dest);
 }
 
@@ -87,34 +113,198 @@ void CMotionControlBase::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrat
 	// the ONLY method to move!!!!!
 	// do not call Stepper direct
 
+	FlushArc();
+
 #ifdef _MSC_VER
 	CStepper::GetInstance()->MSCInfo = CControl::GetInstance()->GetBuffer();
 #endif
 
+#ifdef KINEMATICS
+	if (_kinematics != nullptr)
+	{
+		MoveAbsKinematics(to, feedrate);
+		return;
+	}
+#endif
+
 	mm1000_t to_proj[NUM_AXIS];
-	udist_t  to_m[NUM_AXIS];
 
 	memcpy(to_proj, to, sizeof(_current));
 
 	if (TransformPosition(to, to_proj))
 	{
-		ToMachine(to_proj, to_m);
+		MoveAbsMachine(to, to_proj, feedrate);
+	}
+}
 
- 		feedrate = GetFeedRate(to, feedrate);
+/////////////////////////////////////////////////////////
 
-		CStepper::GetInstance()->MoveAbs(to_m, GetStepRate(to, to_m, feedrate));
+void CMotionControlBase::MoveAbsMachine(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate)
+{
+	udist_t to_m[NUM_AXIS];
+
+	ToMachine(to_proj, to_m);
+
+	feedrate = GetFeedRate(to, feedrate);
 
-		if (CStepper::GetInstance()->IsError())
+	CStepper::GetInstance()->MoveAbs(to_m, GetStepRate(to, to_m, feedrate));
+
+	if (CStepper::GetInstance()->IsError())
+	{
+		SetPositionFromMachine();
+	}
+	else
+	{
+		memcpy(_current, to, sizeof(_current));
+	}
+}
+
+/////////////////////////////////////////////////////////
+
+#ifdef KINEMATICS
+
+bool CMotionControlBase::TransformToJoint(const mm1000_t src[NUM_AXIS], mm1000_t line[NUM_AXIS], mm1000_t joint[NUM_AXIS])
+{
+	memcpy(line, src, sizeof(_current));
+
+	if (!TransformPosition(src, line))
+		return false;
+
+	memcpy(joint, line, sizeof(_current));
+
+	if (!_kinematics->ToJoint(line, joint))
+	{
+		Error(MESSAGE_MOTIONCONTROL_Unreachable);
+		return false;
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::MoveAbsKinematics(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	// split where the joint move (linear in machine-pos) leaves the line, see CKinematics
+	// the move is divided into pieces of max maxDist first (count not limited)
+	// each piece: recursive midpoint test, with a stack instead of recursion (max KINEMATICS_SPLITMAXDEPTH)
+	// stack[0] is the end of the piece, a split move from "from" to stack[n] pushes the midpoint as stack[n+1]
+	// each point is transformed once, the start is the position of the stepper (no transformation)
+
+	SSplitPoint stack[KINEMATICS_SPLITMAXDEPTH + 1];
+	SSplitPoint from;
+	mm1000_t    start[NUM_AXIS];
+	mm1000_t    line[NUM_AXIS];
+	mm1000_t    dist = 0;
+	axis_t      i;
+
+	const mm1000_t maxDist = _kinematics->GetSplitMaxDist(feedrate);
+
+	memcpy(start, _current, sizeof(_current));
+	memcpy(from.Pos, _current, sizeof(_current));
+	ToMm1000(CStepper::GetInstance()->GetPositions(), from.Joint);
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		mm1000_t diff = to[i] - start[i];
+		if (diff < 0) diff = -diff;
+		if (diff > dist)
+			dist = diff;
+	}
+
+	const uint32_t pieces = maxDist > 0 && dist > maxDist ? uint32_t((dist + maxDist - 1) / maxDist) : 1;
+
+	for (uint32_t piece = 1; piece <= pieces; piece++)
+	{
+		for (i = 0; i < NUM_AXIS; i++)
 		{
-			SetPositionFromMachine();
+			stack[0].Pos[i] = piece == pieces ? to[i] : start[i] + mm1000_t(int64_t(to[i] - start[i]) * piece / pieces);
 		}
-		else
+		stack[0].Depth = 0;
+
+		if (!TransformToJoint(stack[0].Pos, line, stack[0].Joint))
+			return;
+
+		uint8_t count = 1;
+
+		while (count > 0)
 		{
-			memcpy(_current, to, sizeof(_current));
+			SSplitPoint& next = stack[count - 1];
+
+			if (next.Depth < KINEMATICS_SPLITMAXDEPTH && SplitMove(from, next, stack[count], maxDist))
+			{
+				next.Depth++;
+				stack[count++].Depth = next.Depth;
+				continue;
+			}
+
+			if (IsError()) return;
+
+			MoveAbsMachine(next.Pos, next.Joint, feedrate);
+
+			if (CStepper::GetInstance()->IsError()) return;
+
+			from = next;
+			count--;
 		}
 	}
 }
 
+/////////////////////////////////////////////////////////
+
+bool CMotionControlBase::SplitMove(const SSplitPoint& from, const SSplitPoint& to, SSplitPoint& mid, mm1000_t maxDist)
+{
+	const mm1000_t tolerance = _kinematics->GetSplitTolerance();
+
+	mm1000_t dist = 0;
+	axis_t   i;
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		mm1000_t diff = to.Pos[i] - from.Pos[i];
+		mid.Pos[i]    = from.Pos[i] + diff / 2;
+
+		if (diff < 0) diff = -diff;
+		if (diff > dist)
+			dist = diff;
+	}
+
+	if (dist <= tolerance)
+		return false;
+
+	mm1000_t midLine[NUM_AXIS];
+
+	if (!TransformToJoint(mid.Pos, midLine, mid.Joint))
+		return false;
+
+	if (dist > maxDist)
+		return true;
+
+	// midpoint of the joint move => compare with the midpoint of the line
+
+	mm1000_t midJoint[NUM_AXIS];
+	mm1000_t midPos[NUM_AXIS];
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		midJoint[i] = from.Joint[i] + (to.Joint[i] - from.Joint[i]) / 2;
+	}
+
+	memcpy(midPos, midJoint, sizeof(midPos));
+	_kinematics->FromJoint(midJoint, midPos);
+
+	for (i = 0; i < NUM_AXISXYZ; i++)
+	{
+		mm1000_t diff = midPos[i] - midLine[i];
+		if (diff > tolerance || diff < -tolerance)
+			return true;
+	}
+
+	return false;
+}
+
+#endif
+
 /////////////////////////////////////////////////////////
 // based on:
 //	motion_control.c - high level interface for issuing motion commands
@@ -122,57 +312,105 @@ void CMotionControlBase::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrat
 
 // Arc with axis_0 and axis_1
 // all other linear
-// calculate Segments with f = k * x + d (x... radius, f ... segments)
+// calculate Segments with the max deviation of a chord from the arc (SetArcChordError)
+//
+// float is only used once for each arc (and for the exact correction)
+// the radius vector is rotated in fixed point for each segment: no FPU on AVR (and SAM)
 
-#define SEGMENTS_K	4.0
+#define ARCMAXSEGMENTANGLE	( 20.0 * M_PI / 180.0)		// small radius: at least 18 segments for a full circle
 
-#define SEGMENTS_D	18.0		// 20 Grad 
-//#define SEGMENTS_D	20.0		// 18 Grad
-//#define SEGMENTS_D	22.0		// 16.3
-//#define SEGMENTS_D	24.0		// 15
-//#define SEGMENTS_D	36.0		// 10
+#define ARC_FRACBITS	8								// radius vector: mm1000 * 2^8 => max radius 8m
+#define ARC_ONE			(int32_t(1) << 30)				// sin/cos: 1.0 = 2^30
+#define ARC_MAXRADIUS	float(int32_t(1) << (31 - ARC_FRACBITS))	// larger radius (overrun of R): exact (float) for each segment
 
-// Use: Small angle approximation from http://en.wikipedia.org/wiki/Small-angle_approximation
-/*
-Figure 3 shows the relative errors of the small angle approximations.The angles at which the relative error exceeds 1 % are as follows :
-tan O near O at about 0.176 radians(10Grad).
-sin O near O at about 0.244 radians(14Grad).
-cos O near 1 - O2 / 2 at about 0.664 radians(38Grad).
+#define ARCCORRECTIONSEGMENTS	64						// exact radius vector every n segments (rounding error of one segment < 1/256 mm1000)
 
-=> To be save => not more than 10Grad for Arc_Correction
-*/
+static int32_t MulArcOne(int32_t value, int32_t sincos)
+{
+	// value * sincos / 2^30 (rounded) with 16x16=>32 bit products: no 64 bit multiplication (__muldi3 on AVR)
+	// sin/cos with 15 bit (32 bit products) would change the radius up to 2^-15 with each segment
 
-#define ARCCORRECTION	( 10.0 * M_PI / 180.0)		// every 10grad
+	bool     negative = (value < 0) != (sincos < 0);
+	uint32_t a        = value < 0 ? uint32_t(-value) : uint32_t(value);
+	uint32_t b        = sincos < 0 ? uint32_t(-sincos) : uint32_t(sincos);
+
+	auto aH = uint16_t(a >> 16);
+	auto aL = uint16_t(a);
+	auto bH = uint16_t(b >> 16);		// <= 2^14
+	auto bL = uint16_t(b);
+
+	uint32_t mid    = uint32_t(aH) * bL + uint32_t(aL) * bH + ((uint32_t(aL) * bL) >> 16) + (uint32_t(1) << 13);
+	uint32_t result = ((uint32_t(aH) * bH) << 2) + (mid >> 14);
+
+	return negative ? -int32_t(result) : int32_t(result);
+}
 
 void CMotionControlBase::Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, axis_t axis_0, axis_t axis_1, bool isclockwise, feedrate_t feedrate)
 {
-	// start from current position!
+	// start from current position => previous arc must be finished
+
+	FlushArc();
+
+#ifdef ARC_BACKGROUND
+
+	// the arc is pending, segments are added if the movement queue can take them (or with the next move)
 
+	if (InitArc(_arc, to, offset0, offset1, axis_0, axis_1, isclockwise, feedrate))
+	{
+		ArcPoll();
+	}
+
+#else
+
+	SArc arc;
+	if (InitArc(arc, to, offset0, offset1, axis_0, axis_1, isclockwise, feedrate))
+	{
+		while (arc.Segment != 0)
+		{
+			MoveArcSegment(arc);
+		}
+	}
+
+#endif
+}
+
+/////////////////////////////////////////////////////////
+
+bool CMotionControlBase::InitArc(SArc& arc, const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, axis_t axis_0, axis_t axis_1, bool isclockwise, feedrate_t feedrate)
+{
 	mm1000_t current[NUM_AXIS];
 	GetPositions(current);
 
-	mm1000_t center_axis0 = current[axis_0] + offset0;
-	mm1000_t center_axis1 = current[axis_1] + offset1;
+	arc.Segment   = 0;
+	arc.Axis_0    = axis_0;
+	arc.Axis_1    = axis_1;
+	arc.Feedrate  = feedrate;
+	arc.Center[0] = current[axis_0] + offset0;
+	arc.Center[1] = current[axis_1] + offset1;
+	arc.Offset[0] = -offset0; // Radius vector from center to current location
+	arc.Offset[1] = -offset1;
+
+	memcpy(arc.To, to, sizeof(arc.To));
 
-	mm1000_t linear_travel_max     = 0;
-	mm1000_t dist_linear[NUM_AXIS] = { 0 };
+	mm1000_t linear_travel_max = 0;
 
 	for (axis_t x = 0; x < NUM_AXIS; x++)
 	{
+		arc.DistLinear[x] = 0;
 		if (x != axis_0 && x != axis_1)
 		{
-			dist_linear[x] = to[x] - current[x];
-			if (dist_linear[x] > linear_travel_max)
-				linear_travel_max = dist_linear[x];
+			arc.DistLinear[x] = to[x] - current[x];
+			if (arc.DistLinear[x] > linear_travel_max)
+				linear_travel_max = arc.DistLinear[x];
 		}
 	}
 
 	float radius = hypot(float(offset0), float(offset1));
 
-	auto     r_axis0  = float(-offset0); // Radius vector from center to current location
-	auto     r_axis1  = float(-offset1);
-	mm1000_t rt_axis0 = to[axis_0] - center_axis0;
-	mm1000_t rt_axis1 = to[axis_1] - center_axis1;
+	auto     r_axis0  = float(arc.Offset[0]);
+	auto     r_axis1  = float(arc.Offset[1]);
+	mm1000_t rt_axis0 = to[axis_0] - arc.Center[0];
+	mm1000_t rt_axis1 = to[axis_1] - arc.Center[1];
 
 	// CCW angle between position and target from circle center. Only one atan2() trig computation required.
 	float angular_travel = atan2(r_axis0 * rt_axis1 - r_axis1 * rt_axis0, r_axis0 * rt_axis0 + r_axis1 * rt_axis1);
@@ -200,92 +438,203 @@ void CMotionControlBase::Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm10
 		}
 	}
 
-#if defined(_MSC_VER)
-#pragma warning (suppress:4189)
-	float mm1000_of_travel = hypot(angular_travel * radius, float(abs(linear_travel_max)));
-	mm1000_of_travel;
-#endif
 	if (hypot(angular_travel * radius, float(abs(linear_travel_max))) < 1)
 	{
-		return;
+		return false;
 	}
 
-	// difference to Grbl => use dynamic calculation of segments => suitable for small r
-	//
-	// segments for full circle => (CONST_K * r * M_PI * b + CONST_D)		(r in mm, b ...2?)
+	// difference to Grbl => segment angle from the max deviation (e) of the chord: 
+	// e = r * (1 - cos(theta/2)) => theta = 2 * acos(1 - e/r) ~ 2 * sqrt(2 * e/r)
 
-	auto segments = uint16_t(abs(floor((CMm1000::ConvertTo(mm1000_t(2 * SEGMENTS_K * M_PI)) * radius + SEGMENTS_D) * angular_travel / (2.0 * M_PI))));
+	float theta_max = float(ARCMAXSEGMENTANGLE);
+	if (radius > _arcChordError)
+	{
+		theta_max = min(theta_max, float(2.0 * sqrt(2.0 * _arcChordError / radius)));
+	}
+
+	auto segments = uint16_t(ceil(fabs(angular_travel) / theta_max));
 
 #if defined(_MSC_VER)
-	double segments_full = CMm1000::ConvertTo(mm1000_t(2 * SEGMENTS_K * M_PI)) * radius + SEGMENTS_D;
-	segments_full;
-	Trace("Gx command with\tr=%f\tfull_segments=%f\tangular=%f\tangularG=%f\tsegments=%i\n", radius, segments_full, angular_travel, angular_travel / M_PI * 180, segments);
+	Trace("Gx command with\tr=%f\ttheta_max=%f\tangular=%f\tangularG=%f\tsegments=%i\n", radius, theta_max, angular_travel, angular_travel / M_PI * 180, segments);
 #endif
 
-	if (segments > 1)
+	arc.Segments        = max(segments, uint16_t(1));
+	arc.Segment         = 1;
+	arc.ThetaPerSegment = angular_travel / arc.Segments;
+
+	arc.Count           = 0;
+	arc.Exact           = radius >= ARC_MAXRADIUS;
+	arc.R[0]            = arc.Exact ? 0 : arc.Offset[0] * (1l << ARC_FRACBITS);
+	arc.R[1]            = arc.Exact ? 0 : arc.Offset[1] * (1l << ARC_FRACBITS);
+
+	// Vector rotation matrix values
+	arc.CosT = int32_t(cos(arc.ThetaPerSegment) * ARC_ONE);
+	arc.SinT = int32_t(sin(arc.ThetaPerSegment) * ARC_ONE);
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::MoveArcSegment(SArc& arc)
+{
+	uint16_t i = arc.Segment;
+
+	if (i >= arc.Segments)
 	{
-		float theta_per_segment = angular_travel / segments;
+		// Ensure last segment arrives at target location.
+		arc.Segment = 0;
+		MoveAbs(arc.To, arc.Feedrate);
+		return;
+	}
+
+	mm1000_t current[NUM_AXIS];
+	memcpy(current, _current, sizeof(current));
 
-		auto arc_correction = int8_t(ARCCORRECTION / theta_per_segment);
-		if (arc_correction < 0)
+	if (arc.Count < ARCCORRECTIONSEGMENTS && !arc.Exact)
+	{
+		// Apply vector rotation matrix 
+		int32_t r_axisi = MulArcOne(arc.R[0], arc.SinT) + MulArcOne(arc.R[1], arc.CosT);
+		arc.R[0]        = MulArcOne(arc.R[0], arc.CosT) - MulArcOne(arc.R[1], arc.SinT);
+		arc.R[1]        = r_axisi;
+		arc.Count++;
+
+		current[arc.Axis_0] = arc.Center[0] + ((arc.R[0] + (1l << (ARC_FRACBITS - 1))) >> ARC_FRACBITS);
+		current[arc.Axis_1] = arc.Center[1] + ((arc.R[1] + (1l << (ARC_FRACBITS - 1))) >> ARC_FRACBITS);
+	}
+	else
+	{
+		// Arc correction to radius vector. Computed only every ARCCORRECTIONSEGMENTS increments (each segment if Exact).
+		// Compute exact location by applying transformation matrix from initial radius vector(=-offset).
+		float cos_Ti = cos(i * arc.ThetaPerSegment);
+		float sin_Ti = sin(i * arc.ThetaPerSegment);
+		float r0     = arc.Offset[0] * cos_Ti - arc.Offset[1] * sin_Ti;
+		float r1     = arc.Offset[0] * sin_Ti + arc.Offset[1] * cos_Ti;
+
+		if (!arc.Exact)
 		{
-			arc_correction = -arc_correction;
+			arc.R[0]  = int32_t(lround(r0 * (1l << ARC_FRACBITS)));
+			arc.R[1]  = int32_t(lround(r1 * (1l << ARC_FRACBITS)));
+			arc.Count = 0;
 		}
 
-		// Vector rotation matrix values
-		float cos_T = float(1.0 - 0.5 * theta_per_segment * theta_per_segment);
-		float sin_T = theta_per_segment;
+		current[arc.Axis_0] = arc.Center[0] + mm1000_t(lround(r0));
+		current[arc.Axis_1] = arc.Center[1] + mm1000_t(lround(r1));
+	}
 
-		uint8_t count = 0;
+	// Update arc_target location (linear axes)
 
-		for (uint16_t i = 1; i < segments; i++)
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		if (arc.DistLinear[x])
 		{
-			if (count < arc_correction)
-			{
-				// Apply vector rotation matrix 
-				float r_axisi = r_axis0 * sin_T + r_axis1 * cos_T;
-				r_axis0       = r_axis0 * cos_T - r_axis1 * sin_T;
-				r_axis1       = r_axisi;
-				count++;
-			}
-			else
-			{
-				// Arc correction to radius vector. Computed only every N_ARC_CORRECTION increments.
-				// Compute exact location by applying transformation matrix from initial radius vector(=-offset).
-				float cos_Ti = cos(i * theta_per_segment);
-				float sin_Ti = sin(i * theta_per_segment);
-				r_axis0      = -offset0 * cos_Ti + offset1 * sin_Ti;
-				r_axis1      = -offset0 * sin_Ti - offset1 * cos_Ti;
-				count        = 0;
-			}
+			current[x] = arc.To[x] - RoundMulDivI32(arc.DistLinear[x], arc.Segments - i, arc.Segments);
+		}
+	}
 
-			// Update arc_target location
+	// not pending while moving the segment (MoveAbs calls FlushArc)
 
-			current[axis_0] = mm1000_t(center_axis0 + r_axis0);
-			current[axis_1] = mm1000_t(center_axis1 + r_axis1);
+	arc.Segment = 0;
+	MoveAbs(current, arc.Feedrate);
 
-			for (axis_t x = 0; x < NUM_AXIS; x++)
-			{
-				if (dist_linear[x])
-				{
-					current[x] = to[x] - RoundMulDivI32(dist_linear[x], segments - i, segments);
-				}
-			}
+	if (!CStepper::GetInstance()->IsEmergencyStop())
+	{
+		arc.Segment = i + 1;
+	}
+}
 
-			MoveAbs(current, feedrate);
-		}
+#ifdef ARC_BACKGROUND
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::ArcPoll()
+{
+	while (IsArcPending() && CStepper::GetInstance()->CanQueueMovement())
+	{
+		MoveArcSegment(_arc);
 	}
+}
 
-	// Ensure last segment arrives at target location.
-	MoveAbs(to, feedrate);
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::FlushArc()
+{
+	while (IsArcPending())
+	{
+		MoveArcSegment(_arc);
+	}
 }
 
+#endif
+
 /////////////////////////////////////////////////////////
 
 steprate_t CMotionControlBase::GetStepRate(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], feedrate_t feedrate) const
 {
-	// TODO: look to all axis to calculate the correct (max) steprate. It is not only AXIS_X
+#ifdef REDUCED_SIZE
+
 	return FeedRateToStepRate(0, feedrate);
+
+#else
+
+	// feedrate is for the axis with the max distance (mm1000), see GetFeedRate
+	// steprate is for the axis with the max distance in steps (dominant axis), see CStepper::MoveAbs
+	// => the steps of the move are known (to_m and position of stepper), no conversion needed (and it works for all kinematics)
+
+	mm1000_t maxdist  = 0;
+	udist_t  maxsteps = 0;
+	udist_t  steps[NUM_AXIS];
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		mm1000_t dist = to[x] > _current[x] ? (to[x] - _current[x]) : (_current[x] - to[x]);
+		if (dist > maxdist)
+		{
+			maxdist = dist;
+		}
+
+		udist_t pos = CStepper::GetInstance()->GetPosition(x);
+		steps[x]    = to_m[x] > pos ? (to_m[x] - pos) : (pos - to_m[x]);
+		if (steps[x] > maxsteps)
+		{
+			maxsteps = steps[x];
+		}
+	}
+
+	if (maxdist == 0 || maxsteps == 0)
+	{
+		return FeedRateToStepRate(0, feedrate);
+	}
+
+	if (feedrate < 0)
+	{
+		feedrate = -feedrate;
+	}
+
+	float steprate = float(feedrate) * float(maxsteps) / (float(maxdist) * 60.0f);
+
+	// limit speed of each axis: steprate of axis = steprate * steps[x] / maxsteps
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		if (steps[x] != 0)
+		{
+			float maxsteprate = float(CStepper::GetInstance()->GetMaxSpeed(x)) * float(maxsteps) / float(steps[x]);
+			if (steprate > maxsteprate)
+			{
+				steprate = maxsteprate;
+			}
+		}
+	}
+
+	if (steprate > STEPRATE_MAX)
+	{
+		return STEPRATE_MAX;
+	}
+
+	return steprate < 1.0f ? steprate_t(1) : steprate_t(steprate);
+
+#endif
 }
 
 /////////////////////////////////////////////////////////
@@ -20,6 +20,7 @@
 
 #include <limits.h>
 #include "Stepper.h"
+#include "Kinematics.h"
 
 ////////////////////////////////////////////////////////
 
@@ -101,6 +102,28 @@ protected:
 
 	mm1000_t _current[NUM_AXIS];
 
+	struct SArc
+	{
+		mm1000_t   To[NUM_AXIS];
+		mm1000_t   DistLinear[NUM_AXIS];			// linear travel of all other axis
+		mm1000_t   Center[2];
+		mm1000_t   Offset[2];						// radius vector from center to start
+		int32_t    R[2];							// radius vector from center to last segment (fixed point, ARC_FRACBITS)
+		int32_t    CosT;							// rotation of one segment (fixed point, ARC_ONE)
+		int32_t    SinT;
+		float      ThetaPerSegment;
+		feedrate_t Feedrate;
+		uint16_t   Segments;
+		uint16_t   Segment;						// next segment (1..Segments), 0 => no segment pending
+		uint8_t    Count;							// segments since last exact radius vector
+		bool       Exact;							// radius too large for R (ARC_MAXRADIUS) => float for each segment
+		axis_t     Axis_0;
+		axis_t     Axis_1;
+	};
+
+	bool InitArc(SArc& arc, const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, axis_t axis_0, axis_t axis_1, bool isclockwise, feedrate_t feedrate);
+	void MoveArcSegment(SArc& arc);
+
 	void Error(cncerror_t error) { _error = error; }
 	void Error() { Error(MESSAGE_UNKNOWNERROR); }
 
@@ -108,6 +131,30 @@ private:
 	static ToMm1000_t  _toMm1000;
 	static ToMachine_t _toMachine;
 	cncerror_t            _error = nullptr;
+	uint16_t              _arcChordError = ARC_CHORDERROR;
+
+#ifdef ARC_BACKGROUND
+	SArc _arc = {};
+#endif
+
+#ifdef KINEMATICS
+
+	struct SSplitPoint
+	{
+		mm1000_t Pos[NUM_AXIS];			// logical-pos
+		mm1000_t Joint[NUM_AXIS];		// machine-mm1000
+		uint8_t  Depth;					// of the segment to this point
+	};
+
+	CKinematics* _kinematics = nullptr;
+
+	bool TransformToJoint(const mm1000_t src[NUM_AXIS], mm1000_t line[NUM_AXIS], mm1000_t joint[NUM_AXIS]);
+	bool SplitMove(const SSplitPoint& from, const SSplitPoint& to, SSplitPoint& mid, mm1000_t maxDist);
+	void MoveAbsKinematics(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
+
+#endif
+
+	void MoveAbsMachine(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate);
 
 public:
 	static steprate_t  FeedRateToStepRate(axis_t axis, feedrate_t feedrate);
@@ -129,6 +176,11 @@ public:
 	{
 		return GetFeedRate(to, feedrate);
 	}
+
+	steprate_t CalcStepRate(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], feedrate_t feedrate) const
+	{
+		return GetStepRate(to, to_m, feedrate);
+	}
 	
 #endif
 
@@ -138,11 +190,29 @@ public:
 	void         Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, axis_t axis_0, axis_t axis_1, bool isclockwise, feedrate_t feedrate);
 	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
 
+#ifdef ARC_BACKGROUND
+	bool IsArcPending() const { return _arc.Segment != 0; }
+	void ArcPoll();								// add segments of the pending arc while the movement queue can take them, call while waiting for input
+	void FlushArc();							// add all segments of the pending arc
+#else
+	bool IsArcPending() const { return false; }
+	void ArcPoll() {}
+	void FlushArc() {}
+#endif
+
 	void     GetPositions(mm1000_t current[NUM_AXIS]) const;
 	mm1000_t GetPosition(axis_t axis) const;
 
 	static feedrate_t GetMaxFeedRate(axis_t axis, feedrate_t feedrate = LONG_MAX);
 
+	void     SetArcChordError(uint16_t chordError) { _arcChordError = chordError; }	// max deviation (mm1000) of a chord from the arc
+	uint16_t GetArcChordError() const { return _arcChordError; }
+
+#ifdef KINEMATICS
+	void         SetKinematics(CKinematics* kinematics) { _kinematics = kinematics; }	// nullptr => cartesian, call SetPositionFromMachine after
+	CKinematics* GetKinematics() const { return _kinematics; }
+#endif
+
 	/////////////////////////////////////////////////////////
 	// some helper function to move (all result in MoveAbs(...)
 
@@ -40,6 +40,7 @@ public:
 		_reader    = reader;
 		_output    = output;
 		_error     = nullptr;
+		_errorLine = nullptr;
 		_OkMessage = nullptr;
 	}
 
@@ -47,6 +48,7 @@ public:
 
 	bool    IsError() const { return _error != nullptr; }
 	cncerror_t GetError() const { return _error; }
+	const char* GetErrorLine() const { return _errorLine; }		// line of the error if it is not the parsed command (e.g. executed from memory), else nullptr
 
 	typedef void (*PrintMessage)();
 
@@ -106,6 +108,7 @@ protected:
 	Stream*        _output;
 	CStreamReader* _reader;
 	cncerror_t        _error;
+	const char*    _errorLine;
 	PrintMessage   _OkMessage;
 
 public:
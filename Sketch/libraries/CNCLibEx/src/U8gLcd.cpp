@@ -477,11 +477,11 @@ bool CU8GLcd::DrawLoopDebug(EnumAsByte(EDrawLoopType) type, uintptr_t data)
 	SetPosition(ToCol(20), ToRow(0 + 1) + PosLineOffset());
 	Print(CControl::GetInstance()->IsHold() ? '1' : '0');
 
-	SetPosition(ToCol(19), ToRow(0 + 3) + PosLineOffset());
-	Print(CSDist::ToString(CControl::GetInstance()->GetBufferCount(), tmp, 2));
+	SetPosition(ToCol(18), ToRow(0 + 3) + PosLineOffset());
+	Print(CSDist::ToString(CControl::GetInstance()->GetBufferCount(), tmp, 3));
 
-	SetPosition(ToCol(19), ToRow(0 + 4) + PosLineOffset());
-	Print(CSDist::ToString(CStepper::GetInstance()->QueuedMovements(), tmp, 2));
+	SetPosition(ToCol(18), ToRow(0 + 4) + PosLineOffset());
+	Print(CSDist::ToString(CStepper::GetInstance()->QueuedMovements(), tmp, 3));
 
 	SetPosition(ToCol(18), ToRow(0 + 5) + PosLineOffset());
 	Print(CSDist::ToString(CStepper::SpeedOverrideToP(CStepper::GetInstance()->GetSpeedOverride()), tmp, 3));
@@ -540,10 +540,17 @@ bool CU8GLcd::DrawLoopPos(EnumAsByte(EDrawLoopType) type, uintptr_t data)
 	char tmp[16];
 
 	mm1000_t dest[NUM_AXIS];
+#ifdef STEPPER_STATUS
+	CStepper::SStatus status;
+	CStepper::GetInstance()->GetStatus(status);
+
+	CMotionControlBase::GetInstance()->GetPosition(status.Current, dest);
+#else
 	udist_t  src[NUM_AXIS];
 	CStepper::GetInstance()->GetCurrentPositions(src);
 
 	CMotionControlBase::GetInstance()->GetPosition(src, dest);
+#endif
 
 	for (uint8_t i = 0; i < _lcd_numaxis; i++)
 	{
@@ -44,6 +44,11 @@ public:
 		MySetLevel(_level);
 	}
 
+	void OnScaled(uint8_t scale) // turn on at level*scale/255, level is not changed (e.g. laser power relative to speed)
+	{
+		MySetLevel(uint8_t((uint16_t(_level) * scale + 127) / 255));
+	}
+
 	void Off() // turn off, use On() to switch on at same value
 	{
 		MySetLevel(0);
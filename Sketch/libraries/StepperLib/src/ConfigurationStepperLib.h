@@ -79,6 +79,33 @@ typedef FLSTR cncerror_t;
 
 #define SYNC_STEPBUFFERCOUNT	8					// allow only x element in step buffer when io or wait starts
 
+#define SPEEDMARKSIZE		8						// movements in the step buffer with a speed reference for OnSpeedEvent (size 2^x)
+
+////////////////////////////////////////////////////////
+// step generator:
+// default:     the step multiplier (1..7 steps per ISR) is set per movement (GetStepMultiplier) and the distance of each axis is adjusted to it
+// STEPPER_DDA: each axis has a 32 bit phase accumulator, the steps per ISR (1..7) are calculated from the current speed => ISR rate <= MAXINTERRUPTSPEED
+
+//#define STEPPER_DDA
+
+////////////////////////////////////////////////////////
+// ramp:
+// default:        constant acceleration (trapezoid), timer calculated with the integer Eiderman formula (CalcTimerAcc/CalcTimerDec)
+// STEPPER_SCURVE: jerk limited acceleration (S-curve) for axis with SetRampJerk != 0, each ramp has a jerk, const acc and jerk phase
+//                 the ramp is longer than the planned trapezoid by the jerk phase tj = a/jerk => the acceleration does not exceed a
+//                 uses 64 bit math in the ISR => for 32 bit boards
+
+//#define STEPPER_SCURVE
+
+// STEPPER_RAMPLOOKUP: timer of the ramp from the (PROGMEM) table timerAcc/sqrt(2n), 4 entries per octave => index and linear interpolation with shifts
+//                     instead of the recurrence with division and rest (CalcTimerAcc/CalcTimerDec) and the _ulsqrt of GetTimer
+
+//#define STEPPER_RAMPLOOKUP
+
+////////////////////////////////////////////////////////
+// STEPPER_STATUS: StepOut writes a snapshot (position, steprate, queue, override, state) into a double buffer (seqlock)
+//                 => GetStatus reads it without CCriticalRegion, see STEPPER_STATUS below for 32 bit
+
 ////////////////////////////////////////////////////////
 
 #define REDUCED_SIZE_virtual virtual				// only virtual for "full" version
@@ -92,7 +119,7 @@ typedef FLSTR cncerror_t;
 
 #define NUM_AXIS			5
 
-#define STEPBUFFERSIZE		128		// size 2^x but not 256
+#define STEPBUFFERSIZE		128		// size 2^x
 #define MOVEMENTBUFFERSIZE	64
 
 ////////////////////////////////////////////////////////
@@ -104,7 +131,7 @@ typedef FLSTR cncerror_t;
 #undef use32bit
 #define use16bit
 
-#define STEPBUFFERSIZE		16		// size 2^x but not 256
+#define STEPBUFFERSIZE		16		// size 2^x
 #define MOVEMENTBUFFERSIZE	8
 
 #define NUM_AXIS 4
@@ -127,8 +154,16 @@ typedef FLSTR cncerror_t;
 
 #define NUM_AXIS			6
 
-#define STEPBUFFERSIZE		128		// size 2^x but not 256
+#if defined(__SAMD21G18A__)
+#define STEPBUFFERSIZE		128		// size 2^x
 #define MOVEMENTBUFFERSIZE	64
+#elif defined(__SAM3X8E__)
+#define STEPBUFFERSIZE		512		// size 2^x, > 128 => 16 bit index
+#define MOVEMENTBUFFERSIZE	128
+#else
+#define STEPBUFFERSIZE		1024	// size 2^x, > 128 => 16 bit index
+#define MOVEMENTBUFFERSIZE	256
+#endif
 
 ////////////////////////////////////////////////////////
 
@@ -144,7 +179,7 @@ typedef unsigned long long uint64_t;
 #undef use16bit
 #define use32bit
 
-#define STEPBUFFERSIZE		16		// size 2^x but not 256
+#define STEPBUFFERSIZE		16		// size 2^x
 #define MOVEMENTBUFFERSIZE	8
 
 //#define NUM_AXIS 5
@@ -155,10 +190,29 @@ typedef unsigned long long uint64_t;
 
 #define MOVEMENTINFOSIZE	128
 
+#define STEPPER_SCURVE				// no change of the trapezoid without SetRampJerk
+
 //#define REDUCED_SIZE
 
 ////////////////////////////////////////////////////////
 
+#elif defined (__linux__)
+
+// host environment (gcc/clang), same settings as msvc test environment
+
+#undef use16bit
+#define use32bit
+
+#define STEPBUFFERSIZE		16		// size 2^x
+#define MOVEMENTBUFFERSIZE	8
+
+#define NUM_AXIS 3
+
+#undef REFERENCESTABLETIME
+#define REFERENCESTABLETIME	0
+
+////////////////////////////////////////////////////////
+
 #else
 ToDo;
 #endif
@@ -174,7 +228,7 @@ ToDo;
 
 #define STEPRATE_MAX		(65535l)		// see range for steprate_t
 
-typedef uint16_t timer_t;			// timer type (16bit)
+typedef uint16_t stepper_timer_t;			// timer type (16bit)
 typedef uint16_t mdist_t;			// type for one movement (16bit)
 typedef uint16_t steprate_t;		// type for speed (Hz), Steps/sec
 
@@ -193,7 +247,7 @@ typedef int32_t  intXX_t;	// 16 => 32;
 
 #define STEPRATE_MAX		(128000l)	// limit steprate_t
 
-typedef uint32_t timer_t;    // timer type (32bit)
+typedef uint32_t stepper_timer_t;    // timer type (32bit)
 typedef uint32_t mdist_t;    // type for one movement (32bit)
 typedef uint32_t steprate_t; // type for speed (Hz), Steps/sec
 
@@ -203,11 +257,31 @@ typedef uint32_t steprate_t; // type for speed (Hz), Steps/sec
 typedef uint64_t uintXX_t;		// 32 => 64 
 typedef int64_t  intXX_t;		// 32 => 64
 
+#define STEPPER_STATUS
+
+#endif
+
+#if !defined(__linux__)
+typedef stepper_timer_t timer_t;	// former name, posix already defines timer_t (glibc)
+#endif
+
+////////////////////////////////////////////////////////
+
+#if STEPBUFFERSIZE > 128
+typedef uint16_t stepbufferidx_t;	// index type of step buffer (ringbuffer)
+#else
+typedef uint8_t stepbufferidx_t;
+#endif
+
+#if MOVEMENTBUFFERSIZE > 128
+typedef uint16_t movementidx_t;	// index type of movement queue (ringbuffer)
+#else
+typedef uint8_t movementidx_t;
 #endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-#ifdef _MSC_VER
+#if defined(_MSC_VER) || defined(__linux__)
 
 #define EnumAsByte(a) a
 #define debugvirtual virtual
@@ -42,8 +42,67 @@ CHAL::HALEvent CHAL::_TimerEvent2 = IgnoreIrq;
 
 #endif
 
-#ifdef _MSC_VER
+#if defined(_MSC_VER) || defined(__linux__)
 
 std::function<uint8_t(int16_t)> digitalReadEvent = nullptr;
 
+////////////////////////////////////////////////////////
+
+CHAL::SVirtualTimer CHAL::_virtualTimer[3] = { { 0, 0 } };
+uint64_t            CHAL::_timerClock      = 0;
+
+////////////////////////////////////////////////////////
+
+void CHAL::StartVirtualTimer(uint8_t timerNo, stepper_timer_t timer, bool periodic)
+{
+	// virtual clock runs with TIMER1FREQUENCE
+
+	uint32_t scale = timerNo == 1 ? 1 : (timerNo == 0 ? TIMER1FREQUENCE / TIMER0FREQUENCE : TIMER1FREQUENCE / TIMER2FREQUENCE);
+	uint32_t ticks = (timer ? uint32_t(timer) : 1) * scale;
+
+	CCriticalRegion crit;
+
+	_virtualTimer[timerNo]._due    = _timerClock + ticks;
+	_virtualTimer[timerNo]._period = periodic ? ticks : 0;
+}
+
+////////////////////////////////////////////////////////
+
+bool CHAL::DispatchTimer(uint64_t maxClock)
+{
+	CCriticalRegion crit;
+
+	uint8_t timerNo = 0xff;
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		if (_virtualTimer[i]._due != 0 && (timerNo == 0xff || _virtualTimer[i]._due < _virtualTimer[timerNo]._due))
+		{
+			timerNo = i;
+		}
+	}
+
+	if (timerNo == 0xff || _virtualTimer[timerNo]._due > maxClock)
+	{
+		return false;
+	}
+
+	SVirtualTimer& virtualTimer = _virtualTimer[timerNo];
+
+	_timerClock       = virtualTimer._due;
+	virtualTimer._due = virtualTimer._period ? virtualTimer._due + virtualTimer._period : 0;
+
+	switch (timerNo)
+	{
+		case 0: _TimerEvent0();
+			break;
+		case 1: _TimerEvent1();
+			break;
+		default: _TimerEvent2();
+			break;
+	}
+
+	return true;
+}
+
 #endif
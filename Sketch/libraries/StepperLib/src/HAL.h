@@ -42,15 +42,15 @@
 
 ////////////////////////////////////////////////////////
 
-#define TIMER0VALUE(freq)	((timer_t)((uint32_t)TIMER0FREQUENCE/(uint32_t)(freq)))
-#define TIMER1VALUE(freq)	((timer_t)((uint32_t)TIMER1FREQUENCE/(uint32_t)(freq)))
-#define TIMER2VALUE(freq)	((timer_t)((uint32_t)TIMER2FREQUENCE/(uint32_t)(freq)))
-//#define TIMER3VALUE(freq)	((timer_t)((uint32_t)TIMER3FREQUENCE/(uint32_t)freq))
-//#define TIMER4VALUE(freq)	((timer_t)((uint32_t)TIMER4FREQUENCE/(uint32_t)freq))
-//#define TIMER5VALUE(freq)	((timer_t)((uint32_t)TIMER5FREQUENCE/(uint32_t)freq))
+#define TIMER0VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER0FREQUENCE/(uint32_t)(freq)))
+#define TIMER1VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER1FREQUENCE/(uint32_t)(freq)))
+#define TIMER2VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER2FREQUENCE/(uint32_t)(freq)))
+//#define TIMER3VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER3FREQUENCE/(uint32_t)freq))
+//#define TIMER4VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER4FREQUENCE/(uint32_t)freq))
+//#define TIMER5VALUE(freq)	((stepper_timer_t)((uint32_t)TIMER5FREQUENCE/(uint32_t)freq))
 
 #define TIMER2MICROSEC					(1.0/(float) TIMER2FREQUENCE*1000000.0)
-#define TIMER2VALUEFROMMICROSEC(msec)	((timer_t)((msec) / TIMER2MICROSEC))
+#define TIMER2VALUEFROMMICROSEC(msec)	((stepper_timer_t)((msec) / TIMER2MICROSEC))
 
 ////////////////////////////////////////////////////////
 
@@ -133,13 +133,13 @@ public:
 	// min 8 bit, AVR: HW Timer 0
 	static void InitTimer0(HALEvent evt);
 	static void RemoveTimer0();
-	static void StartTimer0(timer_t timer);
+	static void StartTimer0(stepper_timer_t timer);
 	static void StopTimer0();
 
 	// min 16 bit (AVR: 2MHZ, HW Timer1) 
 	static void InitTimer1OneShot(HALEvent evt);
 	static void RemoveTimer1();
-	static void StartTimer1OneShot(timer_t timer);
+	static void StartTimer1OneShot(stepper_timer_t timer);
 	static void StopTimer1();
 
 	static HALEvent _TimerEvent0;
@@ -150,8 +150,8 @@ public:
 	// min 8 bit, (AVR: HW Timer5) 
 	static void InitTimer2OneShot(HALEvent evt);
 	static void RemoveTimer2();
-	static void StartTimer2OneShot(timer_t   timer);
-	static void ReStartTimer2OneShot(timer_t timer);
+	static void StartTimer2OneShot(stepper_timer_t timer);
+	static void ReStartTimer2OneShot(stepper_timer_t timer);
 	static void StopTimer2();
 
 	static HALEvent _TimerEvent2;
@@ -245,12 +245,40 @@ public:
 
 	static uint32_t* GetEepromBaseAdr() ALWAYSINLINE;
 
-#if defined(_MSC_VER)
+#if defined(_MSC_VER) || defined(__linux__)
 
 	static void SetEepromFilename(const char* fileName) { _eepromFileName = fileName; }
 
+	// virtual clock in TIMER1FREQUENCE ticks, timer ISRs are called by DispatchTimer (or the timer thread on linux)
+	// without timer thread: call DispatchTimer in CStepper::OnWait, with timer thread: yield in OnWait
+
+	static uint64_t GetTimerClock() { return _timerClock; }
+
+	static bool DispatchTimer(uint64_t maxClock = uint64_t(-1));	// call next pending timer ISR, false if none is pending until maxClock
+
+#if defined(__linux__)
+
+	static void StartTimerThread();
+	static void StopTimerThread();
+
+	static void EnterCriticalRegion();
+	static void LeaveCriticalRegion();
+
+#endif
+
 private:
 
+	struct SVirtualTimer
+	{
+		uint64_t _due;				// 0 => stopped
+		uint32_t _period;			// 0 => one shot
+	};
+
+	static SVirtualTimer _virtualTimer[3];
+	static uint64_t      _timerClock;
+
+	static void StartVirtualTimer(uint8_t timerNo, stepper_timer_t timer, bool periodic);
+
 	static const char* _eepromFileName;
 	static uint32_t    _eepromBuffer[2048];
 
@@ -261,7 +289,7 @@ private:
 
 //////////////////////////////////////////
 
-#if !defined(ESP32)
+#if !defined(ESP32) && !defined(__linux__)
 
 class CCriticalRegion
 {
@@ -283,5 +311,6 @@ public:
 #include "HAL_SamD21g18a.h"
 #include "HAL_Esp32.h"
 #include "HAL_Msvc.h"
+#include "HAL_Posix.h"
 
 //////////////////////////////////////////
@@ -87,7 +87,7 @@ inline void  CHAL::InitTimer0(HALEvent evt)
 
 ////////////////////////////////////////////////////////
 
-inline void CHAL::StartTimer0(timer_t)
+inline void CHAL::StartTimer0(stepper_timer_t)
 {
 	// shared with millis => set only interrupt mask!
 	TIMSK0 |= (1<<OCIE0B);  
@@ -116,7 +116,7 @@ inline void  CHAL::InitTimer1OneShot(HALEvent evt)
 
 ////////////////////////////////////////////////////////
 
-inline void CHAL::StartTimer1OneShot(timer_t timer)
+inline void CHAL::StartTimer1OneShot(stepper_timer_t timer)
 {
 	TCNT1  = 0 - timer;  
 	TIMSK1 |= (1<<TOIE1);					// Aktiviert Interrupt beim Overflow des Timers 1
@@ -153,14 +153,14 @@ inline void  CHAL::InitTimer2OneShot(HALEvent evt)
 
 ////////////////////////////////////////////////////////
 
-inline void CHAL::StartTimer2OneShot(timer_t timer)
+inline void CHAL::StartTimer2OneShot(stepper_timer_t timer)
 {
 	ReStartTimer2OneShot(timer);
 	TIMSK5 |= (1<<TOIE5);					// Aktiviert Interrupt beim Overflow des Timers 
 	TCCR5B |= (1<<CS51);					// timer laeuft mit 1/8 des CPU Takt.
 }
 
-inline void CHAL::ReStartTimer2OneShot(timer_t timer)
+inline void CHAL::ReStartTimer2OneShot(stepper_timer_t timer)
 {
 	TCNT5 = 0 - timer;
 	TIFR5 |= (1 << TOV5);					// clear the overflow flag
@@ -186,7 +186,7 @@ inline void  CHAL::RemoveTimer0()
 	timerEnd(_hwTimer[0]);
 }
 
-inline void CHAL::StartTimer0(timer_t delay)
+inline void CHAL::StartTimer0(stepper_timer_t delay)
 {
 	timerAlarm(_hwTimer[0], delay, true, 0);
 }
@@ -209,7 +209,7 @@ inline void  CHAL::RemoveTimer1()
 	timerEnd(_hwTimer[1]);
 }
 
-inline void CHAL::StartTimer1OneShot(timer_t delay)
+inline void CHAL::StartTimer1OneShot(stepper_timer_t delay)
 {
 	if (delay > 65556)		// limit timer value to 65556
 	{
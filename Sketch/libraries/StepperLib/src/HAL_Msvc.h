@@ -68,37 +68,39 @@ inline void       CHAL::SetSREG(irqflags_t a) { SREG = a; }
 
 #define __asm__(a)
 
+// timer ISRs are called by CHAL::DispatchTimer only (virtual clock, e.g. StepperSimulator), the unit tests call the ISR (CMsvcStepper)
+
 inline void CHAL::InitTimer0(HALEvent evt) { _TimerEvent0 = evt; }
 
-inline void CHAL::RemoveTimer0() {}
-inline void CHAL::StartTimer0(timer_t) {}
-inline void CHAL::StopTimer0() {}
+inline void CHAL::RemoveTimer0() { StopTimer0(); }
+inline void CHAL::StartTimer0(stepper_timer_t timer) { StartVirtualTimer(0, timer, true); }
+inline void CHAL::StopTimer0() { _virtualTimer[0]._due = 0; }
 
 inline void CHAL::InitTimer1OneShot(HALEvent evt) { _TimerEvent1 = evt; }
-inline void CHAL::RemoveTimer1() {}
-inline void CHAL::StartTimer1OneShot(timer_t) {}
+inline void CHAL::RemoveTimer1() { StopTimer1(); }
+inline void CHAL::StartTimer1OneShot(stepper_timer_t timer) { StartVirtualTimer(1, timer, false); }
 
-inline void CHAL::StopTimer1() {}
+inline void CHAL::StopTimer1() { _virtualTimer[1]._due = 0; }
 inline void CHAL::InitTimer2OneShot(HALEvent evt) { _TimerEvent2 = evt; }
-inline void CHAL::RemoveTimer2() {}
-inline void CHAL::StartTimer2OneShot(timer_t  ) {}
-inline void CHAL::ReStartTimer2OneShot(timer_t) {}
-inline void CHAL::StopTimer2() {}
+inline void CHAL::RemoveTimer2() { StopTimer2(); }
+inline void CHAL::StartTimer2OneShot(stepper_timer_t timer) { StartVirtualTimer(2, timer, false); }
+inline void CHAL::ReStartTimer2OneShot(stepper_timer_t timer) { StartVirtualTimer(2, timer, false); }
+inline void CHAL::StopTimer2() { _virtualTimer[2]._due = 0; }
 
 /*
 inline void CHAL::InitTimer3(HALEvent evt){ _TimerEvent3 = evt; }
 inline void CHAL::RemoveTimer3()			{}
-inline void CHAL::StartTimer3(timer_t)		{}
+inline void CHAL::StartTimer3(stepper_timer_t)		{}
 inline void CHAL::StopTimer3()				{}
 
 inline void CHAL::InitTimer4(HALEvent evt){ _TimerEvent4 = evt; }
 inline void CHAL::RemoveTimer4()			{}
-inline void CHAL::StartTimer4(timer_t)		{}
+inline void CHAL::StartTimer4(stepper_timer_t)		{}
 inline void CHAL::StopTimer4()				{}
 
 inline void CHAL::InitTimer5(HALEvent evt){ _TimerEvent5 = evt; }
 inline void CHAL::RemoveTimer5()			{}
-inline void CHAL::StartTimer5(timer_t)		{}
+inline void CHAL::StartTimer5(stepper_timer_t)		{}
 inline void CHAL::StopTimer5()				{}
 */
 #define HALFastdigitalRead(a) CHAL::digitalRead(a)
@@ -238,7 +238,7 @@ inline void CHAL::DelayMicroseconds0250()
 
 inline void  CHAL::RemoveTimer0() {}
 
-inline void CHAL::StartTimer0(timer_t timer_count)
+inline void CHAL::StartTimer0(stepper_timer_t timer_count)
 {
 	if (timer_count == 0) timer_count = 1;
 	TC_SetRC(DUETIMER0_TC, DUETIMER0_CHANNEL, timer_count);
@@ -276,7 +276,7 @@ inline void CHAL::StopTimer0()
 
 inline void  CHAL::RemoveTimer1() {}
 
-inline void CHAL::StartTimer1OneShot(timer_t delay)
+inline void CHAL::StartTimer1OneShot(stepper_timer_t delay)
 {
 	if (delay > 65556)		// limit timer value to 65556
 	{
@@ -327,7 +327,7 @@ inline void CHAL::StopTimer1()
 
 inline void  CHAL::RemoveTimer2() {}
 
-inline void CHAL::StartTimer2OneShot(timer_t delay)
+inline void CHAL::StartTimer2OneShot(stepper_timer_t delay)
 {
 	// convert old AVR timer delay value for SAM timers
 	delay *= 21;		// 2MhZ to 42MhZ
@@ -342,7 +342,7 @@ inline void CHAL::StartTimer2OneShot(timer_t delay)
 	TC_Start(DUETIMER2_TC, DUETIMER2_CHANNEL);
 }
 
-inline void CHAL::ReStartTimer2OneShot(timer_t delay)
+inline void CHAL::ReStartTimer2OneShot(stepper_timer_t delay)
 {
 	StartTimer2OneShot(delay);
 }
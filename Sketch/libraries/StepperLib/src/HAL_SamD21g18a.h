@@ -254,7 +254,7 @@ inline TcCount16* GetTimer0Struct() { return (TcCount16*)TC5; }
 
 inline void  CHAL::RemoveTimer0() {}
 
-inline void CHAL::StartTimer0(timer_t delay)
+inline void CHAL::StartTimer0(stepper_timer_t delay)
 {
 	// do not use 32bit
 
@@ -314,7 +314,7 @@ inline TcCount16* GetTimer1Struct() { return (TcCount16*)TC4; }
 
 inline void  CHAL::RemoveTimer1() {}
 
-inline void CHAL::StartTimer1OneShot(timer_t delay)
+inline void CHAL::StartTimer1OneShot(stepper_timer_t delay)
 {
 	if (delay > 65556)		// limit timer value to 65556
 	{
@@ -21,14 +21,26 @@
 #include "HAL.h"
 
 //////////////////////////////////////////
+// maxSize must be 2^n => wrap of an index is a "&" (mask) and not a "%"
+// index_t is uint8_t (default) or uint16_t (for large buffers on 32 bit boards)
+// the max value of index_t is used as "no index" (NoIdx(), RINGBUFFER_NOIDX for uint8_t) and Count() must be able to return maxSize
+// => maxSize <= (max of index_t + 1) / 2 (e.g. 128 for uint8_t)
 
 #define RINGBUFFER_NOIDX uint8_t(255)
 
-template <class T, const uint8_t maxSize> // do not use maxSize > 254 (255 is used internal)
-class CRingBufferQueue                    // maxSize should be 2^n (because of % operation)
+#define RINGBUFFER_STATIC_ASSERT(maxSize, index_t) \
+	static_assert(maxSize > 0 && (maxSize & (maxSize - 1)) == 0, "maxSize must be 2^n"); \
+	static_assert(maxSize <= index_t(~index_t(0)) / 2 + 1, "maxSize too large for index_t")
+
+template <class T, const uint16_t maxSize, class index_t = uint8_t>
+class CRingBufferQueue
 {
+	RINGBUFFER_STATIC_ASSERT(maxSize, index_t);
+
 public:
 
+	static index_t NoIdx() { return index_t(~index_t(0)); }	// result of H2T, T2H iteration if done
+
 	CRingBufferQueue()
 	{
 		Clear();
@@ -54,7 +66,7 @@ public:
 		Enqueue();
 	}
 
-	void EnqueueCount(uint8_t cnt)
+	void EnqueueCount(index_t cnt)
 	{
 		CCriticalRegion criticalRegion;
 		_nextTail = NextIndex(_nextTail, cnt);
@@ -68,7 +80,7 @@ public:
 		_empty    = _head == _nextTail;
 	}
 
-	void RemoveTail(uint8_t tail)
+	void RemoveTail(index_t tail)
 	{
 		CCriticalRegion criticalRegion;
 		_nextTail = NextIndex(tail);
@@ -85,30 +97,22 @@ public:
 		return !_empty && _head == _nextTail;
 	}
 
-	uint8_t Count() const
+	index_t Count() const
 	{
-		if (_empty)
-		{
-			return 0;
-		}
-
-		if (_head < _nextTail)
-		{
-			return _nextTail - _head;
-		}
-		return maxSize - _head + _nextTail;
+		// full: _head == _nextTail => (-1 & mask) + 1 = maxSize
+		return _empty ? 0 : index_t(ToIndex(_nextTail - _head - 1) + 1);
 	}
 
-	uint8_t FreeCount() const
+	index_t FreeCount() const
 	{
 		return maxSize - Count();
 	}
 
-	T* InsertTail(uint8_t insertAt)
+	T* InsertTail(index_t insertAt)
 	{
 		if (IsInQueue(insertAt))
 		{
-			for (uint8_t idx = T2HInit(); T2HTest(idx); idx = T2HInc(idx))
+			for (index_t idx = T2HInit(); T2HTest(idx); idx = T2HInc(idx))
 			{
 				Buffer[NextIndex(idx)] = Buffer[idx];
 				if (insertAt == idx)
@@ -133,18 +137,18 @@ public:
 	T& Head() { return Buffer[GetHeadPos()]; }
 	T& Tail() { return Buffer[GetTailPos()]; }
 	T& NextTail() { return Buffer[GetNextTailPos()]; }
-	T& NextTail(uint8_t ofs) { return Buffer[NextIndex(GetNextTailPos(), ofs)]; }
+	T& NextTail(index_t ofs) { return Buffer[NextIndex(GetNextTailPos(), ofs)]; }
 
 	T* SaveTail() { return IsEmpty() ? 0 : &Tail(); }
 	T* SaveHead() { return IsEmpty() ? 0 : &Head(); }
 
-	T* GetNext(uint8_t idx)
+	T* GetNext(index_t idx)
 	{
 		idx = NextIndex(idx);
 		return idx != _nextTail && IsInQueue(idx) ? &Buffer[idx] : NULL;
 	}
 
-	T* GetPrev(uint8_t idx)
+	T* GetPrev(index_t idx)
 	{
 		if (idx == _head)
 		{
@@ -154,56 +158,258 @@ public:
 		return IsInQueue(idx) ? &Buffer[idx] : NULL;
 	}
 
-	uint8_t GetHeadPos() const { return _head; }
-	uint8_t GetNextTailPos() const { return _nextTail; }
-	uint8_t GetTailPos() const { return PrevIndex(_nextTail); }
+	index_t GetHeadPos() const { return _head; }
+	index_t GetNextTailPos() const { return _nextTail; }
+	index_t GetTailPos() const { return PrevIndex(_nextTail); }
+
+	bool IsInQueue(index_t idx) const
+	{
+		return idx < maxSize && ToIndex(idx - _head) < Count();
+	}
+
+	// iteration from head to tail (H2T)
+	index_t H2TInit() const { return _empty ? NoIdx() : _head; }
+	bool    H2TTest(index_t idx) const { return idx != NoIdx(); }
+
+	index_t H2TInc(index_t idx) const
+	{
+		idx = NextIndex(idx);
+		return idx == _nextTail ? NoIdx() : idx;
+	}
+
+	// iteration from tail to head (T2H)
+	index_t T2HInit() const { return _empty ? NoIdx() : GetTailPos(); }
+	bool    T2HTest(index_t idx) const { return idx != NoIdx(); }
+	index_t T2HInc(index_t  idx) const { return idx == _head ? NoIdx() : PrevIndex(idx); }
+
+	void Clear()
+	{
+		CCriticalRegion criticalRegion;
+		_head     = 0;
+		_nextTail = 0;
+		_empty    = true;
+	}
+
+private:
+	// often accessed members first => is faster
+
+	volatile index_t _head;     // index of head of queue
+	volatile index_t _nextTail; // index of next free tail (NOT tail position)
+	volatile bool    _empty;    // distinguish between full and empty
+
+	static index_t ToIndex(unsigned int idx) { return index_t(idx & (maxSize - 1)); }
+
+public:
+
+	T Buffer[maxSize];
+
+	////////////////////////////////////////////////////////
+
+	static index_t NextIndex(index_t idx)
+	{
+		return ToIndex(idx + 1);
+	}
+
+	static index_t NextIndex(index_t idx, index_t count)
+	{
+		return ToIndex(idx + count);
+	}
+
+	static index_t PrevIndex(index_t idx)
+	{
+		return ToIndex(idx - 1);
+	}
+
+	static index_t PrevIndex(index_t idx, index_t count)
+	{
+		return ToIndex(idx - count);
+	}
+};
+
+//////////////////////////////////////////
+// single producer / single consumer queue
+// Enqueue is called by one "thread" (e.g. loop) only, Dequeue by one other (e.g. ISR)
+// => no CCriticalRegion required for Enqueue/Dequeue
+// _head and _nextTail are free running counters (index = counter & mask), no _empty flag required:
+//   Count = _nextTail - _head (index_t arithmetic), empty if _head == _nextTail
+// only the producer writes _nextTail, only the consumer writes _head
+// RemoveTail, Clear and InsertTail modify both ends => still use CCriticalRegion
+// index_t must be accessed atomically (uint8_t on AVR)
+
+#if defined(_MSC_VER)
+// msvc: volatile read has acquire, volatile write release semantic (/volatile:ms)
+#define RINGBUFFER_LOAD_ACQUIRE(a)		(a)
+#define RINGBUFFER_STORE_RELEASE(a,v)	((a) = (v))
+#else
+// gcc (AVR, ARM, ESP32, linux): the builtins add the required barriers (AVR: compiler barrier only)
+#define RINGBUFFER_LOAD_ACQUIRE(a)		__atomic_load_n(&(a), __ATOMIC_ACQUIRE)
+#define RINGBUFFER_STORE_RELEASE(a,v)	__atomic_store_n(&(a), (v), __ATOMIC_RELEASE)
+#endif
+
+template <class T, const uint16_t maxSize, class index_t = uint8_t>
+class CRingBufferQueueSPSC
+{
+	RINGBUFFER_STATIC_ASSERT(maxSize, index_t);
+
+public:
+
+	static index_t NoIdx() { return index_t(~index_t(0)); }	// result of H2T, T2H iteration if done
+
+	CRingBufferQueueSPSC()
+	{
+		Clear();
+	}
+
+	// consumer
+
+	void Dequeue()
+	{
+		RINGBUFFER_STORE_RELEASE(_head, index_t(_head + 1));
+	}
+
+	// producer
+
+	void Enqueue()
+	{
+		RINGBUFFER_STORE_RELEASE(_nextTail, index_t(_nextTail + 1));
+	}
+
+	void Enqueue(T value)
+	{
+		Buffer[GetNextTailPos()] = value;
+		Enqueue();
+	}
+
+	void EnqueueCount(index_t cnt)
+	{
+		RINGBUFFER_STORE_RELEASE(_nextTail, index_t(_nextTail + cnt));
+	}
+
+	// modify both ends
 
-	bool IsInQueue(uint8_t idx) const
+	void RemoveTail()
 	{
-		if (_empty)
+		CCriticalRegion criticalRegion;
+		_nextTail = index_t(_nextTail - 1);
+	}
+
+	void RemoveTail(index_t tail)
+	{
+		CCriticalRegion criticalRegion;
+		_nextTail = index_t(_head + ToIndex(tail - _head) + 1);
+	}
+
+	bool IsEmpty() const
+	{
+		return RINGBUFFER_LOAD_ACQUIRE(_head) == RINGBUFFER_LOAD_ACQUIRE(_nextTail);
+	}
+
+	bool IsFull() const
+	{
+		return Count() == maxSize;
+	}
+
+	index_t Count() const
+	{
+		index_t head = RINGBUFFER_LOAD_ACQUIRE(_head);
+		return index_t(RINGBUFFER_LOAD_ACQUIRE(_nextTail) - head);
+	}
+
+	index_t FreeCount() const
+	{
+		return maxSize - Count();
+	}
+
+	T* InsertTail(index_t insertAt)
+	{
+		CCriticalRegion criticalRegion;
+
+		if (IsInQueue(insertAt))
 		{
-			return false;
+			for (index_t idx = T2HInit(); T2HTest(idx); idx = T2HInc(idx))
+			{
+				Buffer[NextIndex(idx)] = Buffer[idx];
+				if (insertAt == idx)
+				{
+					break;
+				}
+			}
 		}
-		if (_nextTail == _head)
+		else
 		{
-			return true;
+			// add tail
+			insertAt = GetNextTailPos();
 		}
-		if (_nextTail > _head)
+
+		Enqueue();
+		return &Buffer[insertAt];
+	}
+
+	// next functions no check if empty or full
+
+	T& Head() { return Buffer[GetHeadPos()]; }
+	T& Tail() { return Buffer[GetTailPos()]; }
+	T& NextTail() { return Buffer[GetNextTailPos()]; }
+	T& NextTail(index_t ofs) { return Buffer[NextIndex(GetNextTailPos(), ofs)]; }
+
+	T* SaveTail() { return IsEmpty() ? 0 : &Tail(); }
+	T* SaveHead() { return IsEmpty() ? 0 : &Head(); }
+
+	T* GetNext(index_t idx)
+	{
+		idx = NextIndex(idx);
+		return idx != GetNextTailPos() && IsInQueue(idx) ? &Buffer[idx] : NULL;
+	}
+
+	T* GetPrev(index_t idx)
+	{
+		if (idx == GetHeadPos())
 		{
-			return idx >= _head && idx < _nextTail;
+			return nullptr;
 		}
-		return idx >= _head || idx < _nextTail;
+		idx = PrevIndex(idx);
+		return IsInQueue(idx) ? &Buffer[idx] : NULL;
+	}
+
+	index_t GetHeadPos() const { return ToIndex(_head); }
+	index_t GetNextTailPos() const { return ToIndex(_nextTail); }
+	index_t GetTailPos() const { return ToIndex(_nextTail - 1); }
+
+	bool IsInQueue(index_t idx) const
+	{
+		index_t head = RINGBUFFER_LOAD_ACQUIRE(_head);
+		return idx < maxSize && ToIndex(idx - head) < index_t(RINGBUFFER_LOAD_ACQUIRE(_nextTail) - head);
 	}
 
 	// iteration from head to tail (H2T)
-	uint8_t H2TInit() const { return _empty ? RINGBUFFER_NOIDX : _head; }
-	bool    H2TTest(uint8_t idx) const { return idx != RINGBUFFER_NOIDX; }
+	index_t H2TInit() const { return IsEmpty() ? NoIdx() : GetHeadPos(); }
+	bool    H2TTest(index_t idx) const { return idx != NoIdx(); }
 
-	uint8_t H2TInc(uint8_t idx) const
+	index_t H2TInc(index_t idx) const
 	{
 		idx = NextIndex(idx);
-		return idx == _nextTail ? RINGBUFFER_NOIDX : idx;
+		return idx == GetNextTailPos() ? NoIdx() : idx;
 	}
 
 	// iteration from tail to head (T2H)
-	uint8_t T2HInit() const { return _empty ? RINGBUFFER_NOIDX : GetTailPos(); }
-	bool    T2HTest(uint8_t idx) const { return idx != RINGBUFFER_NOIDX; }
-	uint8_t T2HInc(uint8_t  idx) const { return idx == _head ? RINGBUFFER_NOIDX : PrevIndex(idx); }
+	index_t T2HInit() const { return IsEmpty() ? NoIdx() : GetTailPos(); }
+	bool    T2HTest(index_t idx) const { return idx != NoIdx(); }
+	index_t T2HInc(index_t  idx) const { return idx == GetHeadPos() ? NoIdx() : PrevIndex(idx); }
 
 	void Clear()
 	{
 		CCriticalRegion criticalRegion;
 		_head     = 0;
 		_nextTail = 0;
-		_empty    = true;
 	}
 
 private:
 	// often accessed members first => is faster
 
-	volatile uint8_t _head;     // index of head of queue
-	volatile uint8_t _nextTail; // index of next free tail (NOT tail position)
-	volatile bool    _empty;    // distinguish between full and empty
+	volatile index_t _head;     // free running counter of head (written by consumer only)
+	volatile index_t _nextTail; // free running counter of next free tail (written by producer only)
+
+	static index_t ToIndex(unsigned int counter) { return index_t(counter & (maxSize - 1)); }
 
 public:
 
@@ -211,23 +417,23 @@ public:
 
 	////////////////////////////////////////////////////////
 
-	static uint8_t NextIndex(uint8_t idx)
+	static index_t NextIndex(index_t idx)
 	{
-		return uint8_t((idx + 1)) % (maxSize);
+		return ToIndex(idx + 1);
 	}
 
-	static uint8_t NextIndex(uint8_t idx, uint8_t count)
+	static index_t NextIndex(index_t idx, index_t count)
 	{
-		return uint8_t((idx + count)) % (maxSize);
+		return ToIndex(idx + count);
 	}
 
-	static uint8_t PrevIndex(uint8_t idx)
+	static index_t PrevIndex(index_t idx)
 	{
-		return idx == 0 ? (maxSize - 1) : (idx - 1);
+		return ToIndex(idx - 1);
 	}
 
-	static uint8_t PrevIndex(uint8_t idx, uint8_t count)
+	static index_t PrevIndex(index_t idx, index_t count)
 	{
-		return (idx >= count) ? idx - count : (maxSize) - (count - idx);
+		return ToIndex(idx - count);
 	}
 };
@@ -24,6 +24,9 @@
 #include "Stepper.h"
 #include "PushValue.h"
 #include "UtilitiesStepperLib.h"
+#ifdef STEPPER_RAMPLOOKUP
+#include "LinearLookUp.h"
+#endif
 
 ////////////////////////////////////////////////////////
 
@@ -48,6 +51,11 @@ void CStepper::InitMemVar()
 
 	_pod = POD(); //POD init object with 0
 
+#ifdef STEPPER_STATUS
+	memset(_status, 0, sizeof(_status));
+	_statusSeq = 0;
+#endif
+
 	// look to ASM => more for() are faster an smaller
 
 #if USESLIP
@@ -63,7 +71,7 @@ void CStepper::InitMemVar()
 	for (i = 0; i < NUM_REFERENCE; i++) { _pod._referenceHitValue[i] = 255; }
 
 	_pod._checkReference = true;
-	_pod._timerBacklash  = timer_t(-1);
+	_pod._timerBacklash  = stepper_timer_t(-1);
 
 	_pod._limitCheck = true;
 	_pod._idleLevel  = LevelOff;
@@ -75,7 +83,9 @@ void CStepper::InitMemVar()
 	SetDefaultMaxSpeed(28000, 350, 380);
 	for (i = 0; i < NUM_AXIS; i++) { SetJerkSpeed(i, 1000); }
 
-	for (i = 0; i < MOVEMENTBUFFERSIZE; i++) _movements._queue.Buffer[i]._state = SMovement::StateDone;
+	for (movementidx_t idx = 0; idx < MOVEMENTBUFFERSIZE; idx++) _movements._queue.Buffer[idx]._state = SMovement::StateDone;
+	_movements._idxPlanned      = _movements._queue.GetHeadPos();
+	_movements._optimizeTouched = 0;
 
 #ifdef _MSC_VER
 	MSCInfo = "";
@@ -139,7 +149,7 @@ void CStepper::AddEvent(StepperEvent event, uintptr_t eventParam, SEvent& oldEve
 
 ////////////////////////////////////////////////////////
 
-void CStepper::StartTimer(timer_t timer)
+void CStepper::StartTimer(stepper_timer_t timer)
 {
 	_pod._timerRunning = true;
 	CHAL::StartTimer1OneShot(timer);
@@ -155,11 +165,11 @@ void CStepper::SetIdleTimer()
 
 ////////////////////////////////////////////////////////
 
-void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax, uint8_t stepMult)
+void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], stepper_timer_t timerMax, uint8_t stepMult)
 {
 	//DumpArray<mdist_t,NUM_AXIS>(F("QueueMove"),dist,false);
 	//DumpArray<bool,NUM_AXIS>(F("Dir"),directionUp,false);
-	//DumpType<timer_t>(F("tm"),timerMax,true);
+	//DumpType<stepper_timer_t>(F("tm"),timerMax,true);
 
 	mdist_t steps = 0;
 
@@ -194,6 +204,10 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 
 	steps *= stepMult;
 
+	// io of MoveIoControl => applied at start of the first (backlash) move
+	bool hasIo           = _pod._moveIoPending;
+	_pod._moveIoPending = false;
+
 	if (IsSetBacklash())
 	{
 		if ((_pod._lastDirection & directionMask) != direction)
@@ -225,6 +239,8 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 
 				_movements._queue.NextTail().InitMove(this, GetPrevMovement(_movements._queue.GetNextTailPos()), backlashSteps, backlashDist, directionUp, _pod._timerBacklash);
 				_movements._queue.NextTail().SetBacklash();
+				_movements._queue.NextTail().SetIo(hasIo, _pod._moveIo);
+				hasIo = false;
 
 				EnqueueAndStartTimer(false);
 			}
@@ -240,14 +256,16 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 	WaitUntilCanQueue();
 
 	_movements._queue.NextTail().InitMove(this, GetPrevMovement(_movements._queue.GetNextTailPos()), steps, dist, directionUp, timerMax);
+	_movements._queue.NextTail().SetIo(hasIo, _pod._moveIo);
 
 	EnqueueAndStartTimer(true);
 }
 
 ////////////////////////////////////////////////////////
 
-void CStepper::QueueWait(const mdist_t dist, timer_t timerMax, uint32_t clock, bool checkWaitConditional)
+void CStepper::QueueWait(const mdist_t dist, stepper_timer_t timerMax, uint32_t clock, bool checkWaitConditional)
 {
+	FlushMoveIo();
 	WaitUntilCanQueue();
 	_movements._queue.NextTail().InitWait(this, dist, timerMax, clock, checkWaitConditional);
 
@@ -271,7 +289,7 @@ bool CStepper::StartMovement()
 	_movements._queue.Head().CalcNextSteps(false);
 	if (_movements._queue.Head().IsFinished())
 	{
-		_movements._queue.Dequeue();
+		DequeueMovement();
 		return false;
 	}
 	return true;
@@ -333,7 +351,7 @@ void CStepper::EnqueueAndStartTimer(bool waitFinish)
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t steps, const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax)
+void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t steps, const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], stepper_timer_t timerMax)
 {
 	axis_t i;
 
@@ -343,6 +361,7 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 	_pod._move._timerMax = timerMax;
 
 	_backlash = false;
+	_hasIo    = false;
 
 	_steps = steps;
 	memcpy(_distance_, dist, sizeof(_distance_));
@@ -361,7 +380,7 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 			uint32_t axisTimer = MulDivU32(_pod._move._timerMax, _steps, d);
 			if (axisTimer < uint32_t(stepper->_pod._timerMax[i]))
 			{
-				timerMax             = timer_t(MulDivU32(stepper->_pod._timerMax[i], d, _steps));
+				timerMax             = stepper_timer_t(MulDivU32(stepper->_pod._timerMax[i], d, _steps));
 				_pod._move._timerMax = max(timerMax, _pod._move._timerMax);
 			}
 		}
@@ -377,13 +396,13 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 		mdist_t d = dist[i];
 		if (d)
 		{
-			auto accDec = timer_t(MulDivU32(stepper->_pod._timerAcc[i], d, _steps));
+			auto accDec = stepper_timer_t(MulDivU32(stepper->_pod._timerAcc[i], d, _steps));
 			if (accDec > _pod._move._timerAcc)
 			{
 				_pod._move._timerAcc = accDec;
 			}
 
-			accDec = timer_t(MulDivU32(stepper->_pod._timerDec[i], d, _steps));
+			accDec = stepper_timer_t(MulDivU32(stepper->_pod._timerDec[i], d, _steps));
 			if (accDec > _pod._move._timerDec)
 			{
 				_pod._move._timerDec = accDec;
@@ -391,9 +410,38 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 		}
 	}
 
+#ifdef STEPPER_SCURVE
+	// and jerk: axis with the lowest jerk (scaled to the steps of the movement), 0 => no limit
+
+	_pod._move._rampJerk = 0;
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		mdist_t  d    = dist[i];
+		uint32_t jerk = stepper->_pod._rampJerk[i];
+		if (d && jerk)
+		{
+			uint64_t mvJerk = uint64_t(jerk) * _steps / d;
+			if (mvJerk > 0xfffffffful)
+			{
+				mvJerk = 0xfffffffful;
+			}
+			if (_pod._move._rampJerk == 0 || mvJerk < _pod._move._rampJerk)
+			{
+				_pod._move._rampJerk = uint32_t(mvJerk);
+			}
+		}
+	}
+#endif
+
 	// calculate StepMultiplier and adjust distance
 
+#ifdef STEPPER_DDA
+	// no multiplier per axis => distance is not adjusted, steps per ISR are calculated in CalcNextSteps
+	uint8_t maxMultiplier = 1;
+#else
 	uint8_t maxMultiplier = CStepper::GetStepMultiplier(_pod._move._timerMax);
+#endif
 	_lastStepDirCount     = 0;
 	_dirCount             = 0;
 
@@ -484,6 +532,10 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 		_lastStepDirCount = _dirCount;
 	}
 
+#ifdef STEPPER_DDA
+	CalcDDAIncrement();
+#endif
+
 	_pod._move._ramp._timerStart = GetUpTimerAcc();
 	_pod._move._ramp._timerStop  = GetUpTimerDec();
 	_pod._move._timerRun         = _pod._move._timerMax;
@@ -496,21 +548,21 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 
 	_state = StateReadyMove;
 
-	_pod._move._timerJunctionToPrev = timer_t(-1); // force optimization
+	_pod._move._timerJunctionToPrev = stepper_timer_t(-1); // force optimization
 
 	bool prevIsMove = mvPrev && mvPrev->IsActiveMove();
 	if (prevIsMove)
 	{
 		CalcMaxJunctionSpeed(mvPrev);
-		_pod._move._timerEndPossible = timer_t(-1);
+		_pod._move._timerEndPossible = stepper_timer_t(-1);
 	}
 	else
 	{
-		_pod._move._timerEndPossible = _stepper->GetTimer(_steps, GetUpTimerAcc());
+		_pod._move._timerEndPossible = _stepper->GetTimer(GetPlanSteps(), GetUpTimerAcc());
 	}
 
-	_pod._move._ramp.RampUp(this, _pod._move._timerRun, timer_t(-1));
-	_pod._move._ramp.RampDown(this, timer_t(-1));
+	_pod._move._ramp.RampUp(this, _pod._move._timerRun, stepper_timer_t(-1));
+	_pod._move._ramp.RampDown(this, stepper_timer_t(-1));
 	_pod._move._ramp.RampRun(this);
 
 	//stepper->Dump(DumpAll);
@@ -518,17 +570,24 @@ void CStepper::SMovement::InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::InitStop(SMovement* mvPrev, timer_t timer, timer_t decTimer)
+void CStepper::SMovement::InitStop(SMovement* mvPrev, stepper_timer_t timer, stepper_timer_t decTimer)
 {
 	// must be a copy off current (executing) move
 	*this = *mvPrev;
 
 	mvPrev->_steps = _stepper->_movementState._n; // stop now
 
+	_hasIo = false;	// io is already set at start of mvPrev
+
 	_pod._move._timerDec = decTimer;
 
 	mdist_t downSteps = CStepper::GetDecSteps(timer, decTimer);
 
+#ifdef STEPPER_SCURVE
+	// the S-curve is longer by the jerk phase (see InitSCurve)
+	downSteps += GetSCurveSteps(uint32_t(_stepper->TimerToSpeed(timer)) + _stepper->TimerToSpeed(decTimer), decTimer);
+#endif
+
 	for (uint8_t i = 0; i < NUM_AXIS; i++)
 	{
 		_distance_[i] = mdist_t(RoundMulDivUInt(_distance_[i], downSteps, _steps));
@@ -538,15 +597,62 @@ void CStepper::SMovement::InitStop(SMovement* mvPrev, timer_t timer, timer_t dec
 
 	_steps = downSteps;
 
+#ifdef STEPPER_DDA
+	CalcDDAIncrement();
+#endif
+
 	_pod._move._ramp._timerRun = timer;
 
 	_pod._move._ramp.RampUp(this, timer, timer);
-	_pod._move._ramp.RampDown(this, timer_t(-1));
+	_pod._move._ramp.RampDown(this, stepper_timer_t(-1));
+
+#ifdef STEPPER_SCURVE
+	_pod._move._ramp._downStartAt = 0;
+	_pod._move._ramp._downSteps   = _steps;
+#endif
 }
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::InitWait(CStepper* stepper, mdist_t steps, timer_t timer, uint32_t clock, bool checkWaitConditional)
+#ifdef STEPPER_DDA
+
+void CStepper::SMovement::CalcDDAIncrement()
+{
+	// increment = 2^32 * distance / steps (distance <= steps)
+	// bitwise division => no 64 bit arithmetic (AVR)
+
+	for (axis_t i = 0; i < NUM_AXIS; i++)
+	{
+		uint32_t rest      = _distance_[i];
+		uint32_t increment = 0;
+
+		if (rest >= _steps)
+		{
+			increment = rest ? 0xfffffffful : 0;
+		}
+		else
+		{
+			for (uint8_t bit = 0; bit < 32; bit++)
+			{
+				bool overflow = (rest & 0x80000000ul) != 0;
+				rest <<= 1;
+				increment <<= 1;
+				if (overflow || rest >= _steps)
+				{
+					rest -= _steps;
+					increment |= 1;
+				}
+			}
+		}
+		_ddaIncrement[i] = increment;
+	}
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
+void CStepper::SMovement::InitWait(CStepper* stepper, mdist_t steps, stepper_timer_t timer, uint32_t clock, bool checkWaitConditional)
 {
 	//this is no POD because of methods => *this = SMovement();		
 	memset(this, 0, sizeof(SMovement)); // init with 0
@@ -609,10 +715,10 @@ uint8_t CStepper::SMovement::GetMaxStepMultiplier() const
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::SRamp::RampUp(SMovement* movement, timer_t timerRun, timer_t timerJunction)
+void CStepper::SMovement::SRamp::RampUp(SMovement* movement, stepper_timer_t timerRun, stepper_timer_t timerJunction)
 {
 	_timerRun           = timerRun;
-	timer_t timerAccDec = movement->GetUpTimerAcc();
+	stepper_timer_t timerAccDec = movement->GetUpTimerAcc();
 
 	if (timerJunction >= timerAccDec) // check from v0=0
 	{
@@ -641,10 +747,10 @@ void CStepper::SMovement::SRamp::RampUp(SMovement* movement, timer_t timerRun, t
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::SRamp::RampDown(SMovement* movement, timer_t timerJunction)
+void CStepper::SMovement::SRamp::RampDown(SMovement* movement, stepper_timer_t timerJunction)
 {
 	mdist_t steps       = movement->_steps;
-	timer_t timerAccDec = movement->GetDownTimerDec();
+	stepper_timer_t timerAccDec = movement->GetDownTimerDec();
 	if (timerJunction >= timerAccDec)
 	{
 		_timerStop   = max(timerAccDec, _timerRun); // to v=0
@@ -680,6 +786,19 @@ void CStepper::SMovement::SRamp::RampRun(SMovement* movement)
 {
 	mdist_t steps = movement->_steps;
 
+#ifdef STEPPER_SCURVE
+	// the S-curve ramp is longer by the jerk phase (see InitSCurve) => plan the trapezoid without these steps
+	// calculated with _timerRun => enough steps if the plateau is cut
+
+	CStepper* stepper       = movement->_stepper;
+	mdist_t   upJerkSteps   = _upSteps ? movement->GetSCurveSteps(uint32_t(stepper->TimerToSpeed(_timerStart)) + stepper->TimerToSpeed(_timerRun), movement->GetUpTimer(_timerStart > _timerRun)) : 0;
+	mdist_t   downJerkSteps = _downSteps ? movement->GetSCurveSteps(uint32_t(stepper->TimerToSpeed(_timerStop)) + stepper->TimerToSpeed(_timerRun), movement->GetDownTimer(_timerStop < _timerRun)) : 0;
+
+	downJerkSteps = min(downJerkSteps, steps);
+	upJerkSteps   = min(upJerkSteps, mdist_t(steps - downJerkSteps));
+	steps -= upJerkSteps + downJerkSteps;
+#endif
+
 	if (_upSteps > steps || steps - _upSteps < _downSteps)
 	{
 		// we cant reach vMax for this movement, cut plateau.
@@ -697,8 +816,8 @@ void CStepper::SMovement::SRamp::RampRun(SMovement* movement)
 		}
 		else
 		{
-			timer_t upTimer   = movement->GetUpTimer(_timerStart > _timerRun);
-			timer_t downTimer = movement->GetUpTimer(_timerStop < _timerRun);
+			stepper_timer_t upTimer   = movement->GetUpTimer(_timerStart > _timerRun);
+			stepper_timer_t downTimer = movement->GetUpTimer(_timerStop < _timerRun);
 
 			uint32_t sqUp   = uint32_t(upTimer) * uint32_t(upTimer);
 			uint32_t sqDown = uint32_t(downTimer) * uint32_t(downTimer);
@@ -727,7 +846,22 @@ void CStepper::SMovement::SRamp::RampRun(SMovement* movement)
 		}
 
 		_downStartAt = steps - _downSteps;
+
+#ifdef STEPPER_SCURVE
+		if (movement->_pod._move._rampJerk != 0 && _timerStart > _timerRun)
+		{
+			// the S-curve ends the up ramp at _timerRun => set the speed reachable with _upSteps
+			stepper_timer_t timerPeak = movement->_stepper->GetTimer(_nUpOffset + _upSteps, movement->GetUpTimerAcc());
+			_timerRun         = min(max(timerPeak, _timerRun), _timerStart);
+		}
+#endif
 	}
+
+#ifdef STEPPER_SCURVE
+	_upSteps += upJerkSteps;
+	_downSteps += downJerkSteps;
+	_downStartAt = movement->_steps - _downSteps;
+#endif
 }
 
 ////////////////////////////////////////////////////////
@@ -760,10 +894,13 @@ bool CStepper::SMovement::Ramp(SMovement* mvNext)
 
 ////////////////////////////////////////////////////////
 // drill down the junction speed if speed at junction point is not possible
+// return true if the junction speed to the next movement can't change any more (max junction speed, accelerating or ramp fixed by ISR)
 
-void CStepper::SMovement::AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* mvNext)
+bool CStepper::SMovement::AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* mvNext)
 {
-	if (!IsActiveMove()) return; // Move became inactive by ISR or "WaitState"/"IoControl"
+	if (!IsActiveMove()) return IsActiveWait(); // Move became inactive by ISR or "WaitState"/"IoControl"
+
+	bool isPlanned = false;
 
 	if (mvPrev == nullptr || IsRunOrDownMove()) // no prev or processing (can be if the ISR has switched to the next move)
 	{
@@ -778,7 +915,7 @@ void CStepper::SMovement::AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* m
 			else
 			{
 				// just continue accelerate to the end of the move
-				_pod._move._timerEndPossible = _stepper->GetTimerAccelerating(_steps, _pod._move._ramp._timerStart, GetUpTimerAcc());
+				_pod._move._timerEndPossible = _stepper->GetTimerAccelerating(GetPlanSteps(), _pod._move._ramp._timerStart, GetUpTimerAcc());
 			}
 		}
 		else
@@ -786,7 +923,7 @@ void CStepper::SMovement::AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* m
 	}
 	else
 	{
-		_pod._move._timerEndPossible = _stepper->GetTimerAccelerating(_steps, mvPrev->IsActiveMove() ? (mvPrev->IsProcessingMove() ? mvPrev->_pod._move._ramp._timerStop : mvPrev->_pod._move._timerEndPossible) : -1, GetUpTimerAcc());
+		_pod._move._timerEndPossible = _stepper->GetTimerAccelerating(GetPlanSteps(), mvPrev->IsActiveMove() ? (mvPrev->IsProcessingMove() ? mvPrev->_pod._move._ramp._timerStop : mvPrev->_pod._move._timerEndPossible) : -1, GetUpTimerAcc());
 
 		if (_pod._move._timerEndPossible > _pod._move._timerMax)
 		{
@@ -802,15 +939,25 @@ void CStepper::SMovement::AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* m
 #endif
 		// next element available, calculate junction speed
 		mvNext->_pod._move._timerJunctionToPrev = max(mvNext->_pod._move._timerMaxJunction, max(_pod._move._timerEndPossible, mvNext->_pod._move._timerJunctionToPrev));
-		_pod._move._timerEndPossible            = mvNext->_pod._move._timerJunctionToPrev;
+
+		// limited by max junction speed or by acceleration => a faster start possible of the next movement will not change the junction
+		isPlanned = mvNext->_pod._move._timerJunctionToPrev == mvNext->_pod._move._timerMaxJunction || mvNext->_pod._move._timerJunctionToPrev == _pod._move._timerEndPossible;
+
+		_pod._move._timerEndPossible = mvNext->_pod._move._timerJunctionToPrev;
 	}
 
 	if (!Ramp(mvNext))
 	{
 		// modify of ramp failed => do not modify _pod._move._timerEndPossible
 		_pod._move._timerEndPossible = _pod._move._ramp._timerStop;
-		if (mvNext != nullptr) mvNext->_pod._move._timerJunctionToPrev = _pod._move._ramp._timerStop;
+		if (mvNext != nullptr)
+		{
+			mvNext->_pod._move._timerJunctionToPrev = _pod._move._ramp._timerStop;
+			isPlanned                               = true;
+		}
 	}
+
+	return isPlanned;
 }
 
 ////////////////////////////////////////////////////////
@@ -824,13 +971,13 @@ bool CStepper::SMovement::AdjustJunctionSpeedT2H(SMovement* mvPrev, SMovement* m
 	if (mvNext == nullptr)
 	{
 		// last element in queue, v(end) = 0, we have to stop
-		_stepper->_movements._timerStartPossible = _stepper->GetTimer(_steps, GetDownTimerDec());
+		_stepper->_movements._timerStartPossible = _stepper->GetTimer(GetPlanSteps(), GetDownTimerDec());
 	}
 	else
 	{
 		// calculate new speed at start of move
 		// assume _timerStartPossible (of next move) at end
-		_stepper->_movements._timerStartPossible = _stepper->GetTimerAccelerating(_steps, _stepper->_movements._timerStartPossible, GetDownTimerDec());
+		_stepper->_movements._timerStartPossible = _stepper->GetTimerAccelerating(GetPlanSteps(), _stepper->_movements._timerStartPossible, GetDownTimerDec());
 	}
 
 	if (mvPrev != nullptr)
@@ -841,7 +988,7 @@ bool CStepper::SMovement::AdjustJunctionSpeedT2H(SMovement* mvPrev, SMovement* m
 			return true; // waitState => no optimize, break here
 
 		// prev element available, calculate junction speed
-		timer_t junctionToPrev = max(_pod._move._timerMaxJunction, _stepper->_movements._timerStartPossible);
+		stepper_timer_t junctionToPrev = max(_pod._move._timerMaxJunction, _stepper->_movements._timerStartPossible);
 		if (junctionToPrev == _pod._move._timerJunctionToPrev)
 			return true; // nothing changed (prev movements do not change)
 
@@ -867,8 +1014,8 @@ void CStepper::SMovement::CalcMaxJunctionSpeed(SMovement* mvPrev)
 
 	// default => fastest move (no jerk)
 	_pod._move._timerMaxJunction = min(mvPrev->_pod._move._timerMax, _pod._move._timerMax);
-	timer_t timerMaxJunction;
-	timer_t timerMaxJunctionAcc = mvPrev->GetUpTimerAcc();
+	stepper_timer_t timerMaxJunction;
+	stepper_timer_t timerMaxJunctionAcc = mvPrev->GetUpTimerAcc();
 
 	mdist_t s1 = mvPrev->_steps;
 	mdist_t s2 = _steps;
@@ -884,7 +1031,7 @@ void CStepper::SMovement::CalcMaxJunctionSpeed(SMovement* mvPrev)
 		}
 	}
 
-	timer_t moveTimerMaxJunction = _pod._move._timerMaxJunction;
+	stepper_timer_t moveTimerMaxJunction = _pod._move._timerMaxJunction;
 	/*
 		printf("H: s1=%i s2=%i\n", (int)s1, (int)s2);
 		for (int ii = 0; ii < NUM_AXIS; ii++)
@@ -957,7 +1104,7 @@ void CStepper::SMovement::CalcMaxJunctionSpeed(SMovement* mvPrev)
 
 ////////////////////////////////////////////////////////
 
-CStepper::SMovement* CStepper::GetNextMovement(uint8_t idx)
+CStepper::SMovement* CStepper::GetNextMovement(movementidx_t idx)
 {
 	// get next movement which can be optimized (no IOControl)
 
@@ -983,7 +1130,7 @@ CStepper::SMovement* CStepper::GetNextMovement(uint8_t idx)
 
 ////////////////////////////////////////////////////////
 
-CStepper::SMovement* CStepper::GetPrevMovement(uint8_t idx)
+CStepper::SMovement* CStepper::GetPrevMovement(movementidx_t idx)
 {
 	// get previous movement which can be optimized (no IOControl)
 
@@ -1010,19 +1157,33 @@ CStepper::SMovement* CStepper::GetPrevMovement(uint8_t idx)
 
 void CStepper::OptimizeMovementQueue(bool /* force */)
 {
+	// planned movement is advanced by ISR if finished (DequeueMovement)
+
+	movementidx_t idxPlanned = _movements._idxPlanned;
+
+	if (!_movements._queue.IsInQueue(idxPlanned))
+	{
+		idxPlanned = _movements._queue.H2TInit();
+	}
+
+	_movements._optimizeTouched = 0;
+
 	if (_movements._queue.IsEmpty() || _movements._queue.Count() < 2)
 	{
 		return;
 	}
 
-	uint8_t idx;
-	uint8_t idxNoChange = _movements._queue.H2TInit();
+	movementidx_t idx;
+	movementidx_t idxNoChange = idxPlanned;
 
 	////////////////////////////////////
 	// calculate junction (max) speed!
+	// stop at planned movement, all previous junctions will not change
 
-	for (idx = _movements._queue.T2HInit(); _movements._queue.T2HTest(idx); idx = _movements._queue.T2HInc(idx))
+	for (idx = _movements._queue.T2HInit(); _movements._queue.T2HTest(idx) && idx != idxPlanned; idx = _movements._queue.T2HInc(idx))
 	{
+		_movements._optimizeTouched++;
+
 		if (_movements._queue.Buffer[idx].AdjustJunctionSpeedT2H(GetPrevMovement(idx), GetNextMovement(idx)))
 		{
 			idxNoChange = idx;
@@ -1036,7 +1197,25 @@ void CStepper::OptimizeMovementQueue(bool /* force */)
 
 	for (idx = idxNoChange; _movements._queue.H2TTest(idx); idx = _movements._queue.H2TInc(idx))
 	{
-		_movements._queue.Buffer[idx].AdjustJunctionSpeedH2T(GetPrevMovement(idx), GetNextMovement(idx));
+		_movements._optimizeTouched++;
+
+		SMovement* mvNext = GetNextMovement(idx);
+
+		if (_movements._queue.Buffer[idx].AdjustJunctionSpeedH2T(GetPrevMovement(idx), mvNext) && idx == idxPlanned)
+		{
+			// junction to next movement is final => advance planned
+			movementidx_t idxNext = mvNext != nullptr ? movementidx_t(mvNext - _movements._queue.Buffer) : _movements._queue.H2TInc(idx);
+			if (_movements._queue.H2TTest(idxNext))
+			{
+				idxPlanned = idxNext;
+			}
+		}
+	}
+
+	CCriticalRegion criticalRegion;
+	if (_movements._queue.IsInQueue(idxPlanned)) // else: finished by ISR in the meantime
+	{
+		_movements._idxPlanned = idxPlanned;
 	}
 }
 
@@ -1102,6 +1281,8 @@ void CStepper::OnInfo(cncerror_t info)
 
 void CStepper::WaitBusy()
 {
+	FlushMoveIo();
+
 	while (IsBusy())
 	{
 		// wait until finish all movements
@@ -1127,7 +1308,7 @@ uint32_t CStepper::GetAccelerationFromTimer(mdist_t timerV0)
 ////////////////////////////////////////////////////////
 // reverse calc n from timerValue
 
-timer_t CStepper::GetTimer(mdist_t steps, timer_t timerStart)
+stepper_timer_t CStepper::GetTimer(mdist_t steps, stepper_timer_t timerStart)
 {
 	// original v = sqrt(v0^2 + 2 a d)
 	// because of int estimation: use factor
@@ -1135,6 +1316,9 @@ timer_t CStepper::GetTimer(mdist_t steps, timer_t timerStart)
 	// v = sqrt((v0^2 + 2 a d) / factor^2)
 	// v0 = 0
 
+#ifdef STEPPER_RAMPLOOKUP
+	return GetTimerFromLookup(steps, timerStart);
+#else
 	if (steps > MAXACCDECSTEPS)
 	{
 		steps = MAXACCDECSTEPS;
@@ -1151,18 +1335,24 @@ timer_t CStepper::GetTimer(mdist_t steps, timer_t timerStart)
 	auto     v  = steprate_t((_ulsqrt(((ad) / 93) * 85)));
 
 	return SpeedToTimer(v) + 1; // +1 	empiric tested to get better results
+#endif
 }
 
 ////////////////////////////////////////////////////////
 // reverse calc n from timerValue
 
-timer_t CStepper::GetTimerAccelerating(mdist_t steps, timer_t timerV0, timer_t timerStart)
+stepper_timer_t CStepper::GetTimerAccelerating(mdist_t steps, stepper_timer_t timerV0, stepper_timer_t timerStart)
 {
 	// original v = sqrt(v0^2 + 2 a d)
 	// because of int estimation: use factor
 	//
 	// v = sqrt((v0^2 + 2 a d) / factor^2)
 
+#ifdef STEPPER_RAMPLOOKUP
+	// continue the ramp (from v=0) at the step of v0
+	mdist_t n0 = timerV0 < timerStart ? GetAccSteps(timerV0, timerStart) : 0;
+	return GetTimerFromLookup(n0 + steps, timerStart);
+#else
 	if (steps > MAXACCDECSTEPS)
 	{
 		steps = MAXACCDECSTEPS;
@@ -1182,18 +1372,27 @@ timer_t CStepper::GetTimerAccelerating(mdist_t steps, timer_t timerV0, timer_t t
 	auto     v  = steprate_t((_ulsqrt(((sqv0 + ad) / 93) * 85)));
 
 	return SpeedToTimer(v) + 1; // +1 	empiric tested to get better results
+#endif
 }
 
 ////////////////////////////////////////////////////////
 // reverse calc n from timerValue
 
-timer_t CStepper::GetTimerDecelerating(mdist_t steps, timer_t timerV, timer_t timerStart)
+stepper_timer_t CStepper::GetTimerDecelerating(mdist_t steps, stepper_timer_t timerV, stepper_timer_t timerStart)
 {
 	// original v = sqrt(v0^2 + 2 a d)
 	// because of int estimation: use factor
 	//
 	// v = sqrt((v0^2 + 2 a d) / factor^2)
 
+#ifdef STEPPER_RAMPLOOKUP
+	mdist_t n0 = timerV < timerStart ? GetAccSteps(timerV, timerStart) : 0;
+	if (n0 < steps)
+	{
+		return stepper_timer_t(-1);
+	}
+	return GetTimerFromLookup(n0 - steps, timerStart);
+#else
 	if (steps > MAXACCDECSTEPS)
 	{
 		steps = MAXACCDECSTEPS;
@@ -1212,18 +1411,106 @@ timer_t CStepper::GetTimerDecelerating(mdist_t steps, timer_t timerV, timer_t ti
 	uint32_t ad = a2 * steps;
 	if (sqv0 < ad)
 	{
-		return timer_t(-1);
+		return stepper_timer_t(-1);
 	}
 
 	auto v = steprate_t((_ulsqrt(((sqv0 - ad) / 93) * 85)));
 
 	return SpeedToTimer(v) + 1; // +1 	empiric tested to get better results
+#endif
 }
 
 ////////////////////////////////////////////////////////
 // reverse calc n from timerValue
 
-mdist_t CStepper::GetAccSteps(timer_t timer, timer_t timerStart)
+#ifdef STEPPER_RAMPLOOKUP
+
+stepper_timer_t CStepper::GetTimerFromLookup(mdist_t steps, stepper_timer_t timerStart)
+{
+	// v = sqrt(2 a n) with a = (F/timerStart)^2 and the factor of GetTimer (85/93)
+	// => timer = timerStart / sqrt(2*n*85/93), independent of a => one table for all axis and movements
+	// ratio is Q24, table: n = 1..8 and 4 entries per octave => index and linear interpolation with shifts (no search, no division)
+
+	static const CLinearLookup<int32_t, int32_t>::SLookupTable rampTable[] PROGMEM =
+	{
+		{ 1, 12409004 }, { 2, 8774491 }, { 3, 7164342 }, { 4, 6204502 },
+		{ 5, 5549475 }, { 6, 5065954 }, { 7, 4690162 }, { 8, 4387245 },
+		{ 10, 3924071 }, { 12, 3582171 }, { 14, 3316446 }, { 16, 3102251 },
+		{ 20, 2774738 }, { 24, 2532977 }, { 28, 2345081 }, { 32, 2193623 },
+		{ 40, 1962036 }, { 48, 1791085 }, { 56, 1658223 }, { 64, 1551125 },
+		{ 80, 1387369 }, { 96, 1266489 }, { 112, 1172541 }, { 128, 1096811 },
+		{ 160, 981018 }, { 192, 895543 }, { 224, 829111 }, { 256, 775563 },
+		{ 320, 693684 }, { 384, 633244 }, { 448, 586270 }, { 512, 548406 },
+		{ 640, 490509 }, { 768, 447771 }, { 896, 414556 }, { 1024, 387781 },
+		{ 1280, 346842 }, { 1536, 316622 }, { 1792, 293135 }, { 2048, 274203 },
+		{ 2560, 245254 }, { 3072, 223886 }, { 3584, 207278 }, { 4096, 193891 },
+		{ 5120, 173421 }, { 6144, 158311 }, { 7168, 146568 }, { 8192, 137101 },
+		{ 10240, 122627 }, { 12288, 111943 }, { 14336, 103639 }, { 16384, 96945 },
+		{ 20480, 86711 }, { 24576, 79156 }, { 28672, 73284 }, { 32768, 68551 },
+		{ 40960, 61314 }, { 49152, 55971 }, { 57344, 51819 }, { 65536, 48473 },
+		{ 81920, 43355 }, { 98304, 39578 }, { 114688, 36642 }, { 131072, 34275 },
+		{ 163840, 30657 }, { 196608, 27986 }, { 229376, 25910 }, { 262144, 24236 },
+		{ 327680, 21678 }, { 393216, 19789 }, { 458752, 18321 }, { 524288, 17138 },
+		{ 655360, 15328 }, { 786432, 13993 }, { 917504, 12955 }, { 1048576, 12118 },
+		{ 1310720, 10839 }, { 1572864, 9894 }, { 1835008, 9160 }, { 2097152, 8569 },
+		{ 2621440, 7664 }, { 3145728, 6996 }, { 3670016, 6477 }, { 4194304, 6059 },
+		{ 5242880, 5419 }, { 6291456, 4947 }, { 7340032, 4580 }, { 8388608, 4284 },
+		{ 10485760, 3832 }, { 12582912, 3498 }, { 14680064, 3239 }, { 16777216, 3030 }
+	};
+
+	if (steps == 0)
+	{
+		return timerStart;
+	}
+
+	if (steps > MAXACCDECSTEPS)
+	{
+		steps = MAXACCDECSTEPS;
+	}
+
+	const uint8_t tableSize = sizeof(rampTable) / sizeof(CLinearLookup<int32_t, int32_t>::SLookupTable);
+
+	CLinearLookup<int32_t, int32_t> lookup(rampTable, tableSize);
+
+	uint32_t ratio;
+
+	if (steps <= 8)
+	{
+		ratio = uint32_t(lookup.GetOutput(uint8_t(steps - 1)));
+	}
+	else if (steps >= uint32_t(lookup.GetInput(tableSize - 1)))
+	{
+		ratio = uint32_t(lookup.GetOutput(tableSize - 1));
+	}
+	else
+	{
+		// steps in [2^octave, 2^(octave+1)), 4 entries with a distance of 2^(octave-2)
+		uint8_t octave = 3;
+		while ((uint32_t(steps) >> (octave + 1)) != 0)
+		{
+			octave++;
+		}
+
+		uint8_t  shift = octave - 2;
+		uint32_t rel   = uint32_t(steps) - (1ul << octave);
+		uint8_t  i     = uint8_t(7 + (octave - 3) * 4 + (rel >> shift));
+		uint32_t rest  = rel & ((1ul << shift) - 1);
+
+		ratio = uint32_t(lookup.GetOutput(i));
+		ratio -= ((ratio - uint32_t(lookup.GetOutput(i + 1))) * rest) >> shift;
+	}
+
+	// timerStart * ratio / 2^24 without overrun
+	uint32_t timer = (uint32_t(timerStart) * (ratio >> 12) + ((uint32_t(timerStart) * (ratio & 0xfff)) >> 12)) >> 12;
+
+	return timer < TIMER1VALUEMAXSPEED ? TIMER1VALUEMAXSPEED : stepper_timer_t(timer);
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
+mdist_t CStepper::GetAccSteps(stepper_timer_t timer, stepper_timer_t timerStart)
 {
 	// original: d = v^2 / v0^2
 	// tested with excel to fit to timer calculation with cn = cn-1 + (2*cn-1) / (4n+1) and use of "integer"
@@ -1251,14 +1538,14 @@ mdist_t CStepper::GetAccSteps(timer_t timer, timer_t timerStart)
 
 ////////////////////////////////////////////////////////
 
-mdist_t CStepper::GetAccSteps(timer_t timer1, timer_t timer2, timer_t timerStart)
+mdist_t CStepper::GetAccSteps(stepper_timer_t timer1, stepper_timer_t timer2, stepper_timer_t timerStart)
 {
 	// timer1 = v1 (slower) => timer1 greater
 	// timer2 = v2 (faster)
 
 	if (timer1 < timer2) // swap if wrong
 	{
-		timer_t tmp = timer1;
+		stepper_timer_t tmp = timer1;
 		timer1      = timer2;
 		timer2      = tmp;
 	}
@@ -1268,7 +1555,7 @@ mdist_t CStepper::GetAccSteps(timer_t timer1, timer_t timer2, timer_t timerStart
 
 ////////////////////////////////////////////////////////
 
-mdist_t CStepper::GetSteps(timer_t timer1, timer_t timer2, timer_t timerStart, timer_t timerStop)
+mdist_t CStepper::GetSteps(stepper_timer_t timer1, stepper_timer_t timer2, stepper_timer_t timerStart, stepper_timer_t timerStop)
 {
 	if (timer1 > timer2)
 	{
@@ -1292,7 +1579,7 @@ void CStepper::StopMove(steprate_t v0Dec)
 		}
 		else
 		{
-			timer_t decTimer = v0Dec != 0 ? SpeedToTimer(v0Dec) : mv.GetDownTimerDec();
+			stepper_timer_t decTimer = v0Dec != 0 ? SpeedToTimer(v0Dec) : mv.GetDownTimerDec();
 
 			{
 				CCriticalRegion critical;
@@ -1309,6 +1596,7 @@ void CStepper::StopMove(steprate_t v0Dec)
 				SubTotalSteps();
 
 				_movements._queue.RemoveTail(_movements._queue.GetHeadPos());
+				_movements._idxPlanned = _movements._queue.GetHeadPos();
 				_movements._queue.NextTail().InitStop(&mv, _movementState._timer, decTimer);
 				_movements._queue.Enqueue();
 			}
@@ -1328,7 +1616,10 @@ void CStepper::AbortMove()
 	SubTotalSteps();
 
 	_stepBuffer.Clear();
+	_speedMark.Clear();
 	_movements._queue.Clear();
+	_movements._idxPlanned = _movements._queue.GetHeadPos();
+	_pod._moveIoPending    = false;
 
 	memcpy(_pod._calculatedPos, _pod._current, sizeof(_pod._calculatedPos));
 
@@ -1347,7 +1638,7 @@ void CStepper::PauseMove()
 
 		// insert into queue (where jerk speed to stop move will not exceed) 
 
-		for (uint8_t idx = _movements._queue.H2TInit(); _movements._queue.H2TTest(idx); idx = _movements._queue.H2TInc(idx))
+		for (movementidx_t idx = _movements._queue.H2TInit(); _movements._queue.H2TTest(idx); idx = _movements._queue.H2TInc(idx))
 		{
 			SMovement& mv = _movements._queue.Buffer[idx];
 
@@ -1380,6 +1671,7 @@ void CStepper::PauseMove()
 			{
 				WaitUntilCanQueue();
 				_movements._queue.InsertTail(_movements._queue.NextIndex(idx))->InitWait(this, 0xffff, WAITTIMER1VALUE, 0, true);
+				_movements._idxPlanned = _movements._queue.GetHeadPos(); // queue is modified
 				return;
 			}
 		}
@@ -1406,7 +1698,7 @@ void CStepper::SubTotalSteps()
 
 	// sub all pending steps to _totalSteps
 
-	for (uint8_t idx = _movements._queue.T2HInit(); _movements._queue.T2HTest(idx); idx = _movements._queue.T2HInc(idx))
+	for (movementidx_t idx = _movements._queue.T2HInit(); _movements._queue.T2HTest(idx); idx = _movements._queue.T2HInc(idx))
 	{
 		SMovement& mv = _movements._queue.Buffer[idx];
 		if (mv.IsActiveMove())
@@ -1433,7 +1725,7 @@ void CStepper::EmergencyStopResurrect()
 
 ////////////////////////////////////////////////////////
 
-uint8_t CStepper::GetStepMultiplier(timer_t timerMax)
+uint8_t CStepper::GetStepMultiplier(stepper_timer_t timerMax)
 {
 	if (timerMax >= TIMER1VALUE(SPEED_MULTIPLIER_2)) return 1;
 	if (timerMax >= TIMER1VALUE(SPEED_MULTIPLIER_3)) return 2;
@@ -1453,11 +1745,14 @@ inline void CStepper::StepOut()
 
 	// calculate all axes and set PINS parallel - DRV 8225 requires 1.9us * 2 per step => sequential is too slow 
 
-	DirCount_t dir_count;
+	DirCount_t      dir_count;
+	stepper_timer_t timer;
+	uint8_t         stepMultiplier = 0;
 
 	{
 		auto stepBuffer = &_stepBuffer.Head();
-		StartTimer(stepBuffer->Timer - TIMEROVERHEAD);
+		timer           = stepBuffer->Timer;
+		StartTimer(timer - TIMEROVERHEAD);
 		dir_count = stepBuffer->DirStepCount;
 	}
 
@@ -1495,6 +1790,10 @@ inline void CStepper::StepOut()
 
 		axesCount[i] = byteDirCount & 7;
 		directionUp /= 2;
+		if (axesCount[i] > stepMultiplier)
+		{
+			stepMultiplier = axesCount[i];
+		}
 
 		if (axesCount[i])
 		{
@@ -1521,15 +1820,106 @@ inline void CStepper::StepOut()
 		}
 	}
 
+	if (!_speedMark.IsEmpty() && _speedMark.Head().Idx == _stepBuffer.GetHeadPos())
+	{
+		// first step of a movement => new reference for the speed level
+		_pod._speedTimerRun = _speedMark.Head().TimerRun;
+		_pod._speedTimer    = 0;
+		_speedMark.Dequeue();
+	}
+
+	if (_pod._speedEvent)
+	{
+		SetSpeedLevel(timer, stepMultiplier);
+	}
+
 	directionUp = directionUp ^ _pod._invertDirection;
 	Step(axesCount, directionUp, _pod._lastDirectionUp == directionUp);
 	_pod._lastDirectionUp = directionUp;
 
 	_stepBuffer.Dequeue();
+
+#ifdef STEPPER_STATUS
+	SetStatus(timer, stepMultiplier);
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+inline void CStepper::SetSpeedLevel(stepper_timer_t timer, uint8_t stepMultiplier)
+{
+	// called in interrupt: speed of the emitted step relative to the programmed speed of the movement (incl. speed override)
+	// timer is the time of stepMultiplier steps => divide only if it changed (not on the plateau)
+
+	if (timer != _pod._speedTimer || stepMultiplier != _pod._speedCount)
+	{
+		_pod._speedTimer = timer;
+		_pod._speedCount = stepMultiplier;
+
+		uint32_t level   = RoundMulDivU32(uint32_t(_pod._speedTimerRun) * stepMultiplier, 255, timer);
+		_pod._speedLevel = uint8_t(min(level, uint32_t(255)));
+	}
 }
 
 ////////////////////////////////////////////////////////
 
+#ifdef STEPPER_STATUS
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STATUS_FENCE_ACQUIRE()	_ReadWriteBarrier()
+#define STATUS_FENCE_RELEASE()	_ReadWriteBarrier()
+#else
+#define STATUS_FENCE_ACQUIRE()	__atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define STATUS_FENCE_RELEASE()	__atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+inline void CStepper::SetStatus(stepper_timer_t timer, uint8_t stepMultiplier)
+{
+	// called in interrupt (or with the timer stopped)
+	// write n+1 goes to the buffer not read by GetStatus (newest is n), _statusSeq is odd while writing
+
+	uint32_t seq = _statusSeq + 1;
+	_statusSeq   = seq;
+	STATUS_FENCE_RELEASE();
+
+	SStatus& status = _status[((seq + 1) / 2) & 1];
+
+	memcpy(status.Current, _pod._current, sizeof(status.Current));
+	status.Timer           = timer;
+	status.StepMultiplier  = stepMultiplier;
+	status.SpeedOverride   = _pod._speedOverride;
+	status.State           = _pod._emergencyStop ? StatusEmergencyStop : (_pod._pause ? StatusHold : (timer == 0 ? StatusIdle : StatusRun));
+	status.MovementCount   = _movements._queue.Count();
+	status.StepBufferCount = _stepBuffer.Count();
+
+	RINGBUFFER_STORE_RELEASE(_statusSeq, seq + 1);
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::GetStatus(SStatus& status) const
+{
+	// seqlock with two buffers: read the newest (n), retry only if the ISR started to overwrite it (write n+2)
+
+	for (;;)
+	{
+		uint32_t n = RINGBUFFER_LOAD_ACQUIRE(_statusSeq) / 2;
+
+		memcpy(&status, &_status[n & 1], sizeof(status));
+
+		STATUS_FENCE_ACQUIRE();
+		if (_statusSeq - 2 * n <= 2)
+		{
+			return;
+		}
+	}
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 static volatile bool _backgroundActive = false;
 
 void CStepper::StartBackground()
@@ -1590,7 +1980,7 @@ void CStepper::FillStepBuffer()
 
 		if (_movements._queue.Head().IsFinished())
 		{
-			_movements._queue.Dequeue();
+			DequeueMovement();
 		}
 	}
 
@@ -1644,10 +2034,35 @@ void CStepper::Background()
 
 void CStepper::GoIdle()
 {
+	// stopped (end of moves or buffer under run) => SpeedEventPoll reports 0
+	_pod._speedLevel = 0;
+	_pod._speedTimer = 0;
+
 	// start idle timer
 	_pod._timerStartOrOnIdle = millis();
 	SetIdleTimer();
 	OnIdle(0);
+
+#ifdef STEPPER_STATUS
+	SetStatus(0, 0);
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::SpeedEventPoll()
+{
+	// called in the foreground (e.g. in the idle poll of the control) => OnSpeedEvent may set a PWM (analogWrite)
+
+	if (_pod._speedEvent)
+	{
+		uint8_t level = _pod._speedLevel;
+		if (level != _pod._speedLevelEvent)
+		{
+			_pod._speedLevelEvent = level;
+			CallEvent(OnSpeedEvent, level);
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////
@@ -1706,7 +2121,8 @@ void CStepper::StepRequest(bool isr)
 #if defined (stepperstatic_)
 
 CStepper::SMovementState CStepper::_movementState;
-CRingBufferQueue<CStepper::SStepBuffer, STEPBUFFERSIZE> CStepper::_stepBuffer;
+CRingBufferQueueSPSC<CStepper::SStepBuffer, STEPBUFFERSIZE, stepbufferidx_t> CStepper::_stepBuffer;
+CRingBufferQueueSPSC<CStepper::SSpeedMark, SPEEDMARKSIZE, uint8_t> CStepper::_speedMark;
 CStepper::SMovements CStepper::_movements;
 CStepper* CStepper::SMovement::_stepper;
 
@@ -1729,23 +2145,37 @@ void CStepper::SMovementState::Init(SMovement* movement)
 		_timer = movement->_pod._wait._timer;
 	}
 
+#ifdef STEPPER_DDA
+	// start with 1/2 => steps are centered (like Bresenham)
+	// the sum of the phase increments is (2^32*distance - rest), rest < steps => the start phase must be >= steps to get exactly "distance" steps
+	uint32_t phase = uint32_t(steps) > 0x80000000ul ? 0xfffffffful : 0x80000000ul;
+
+	for (axis_t i = 0; i < NUM_AXIS; i++)
+	{
+		_phase[i] = phase;
+	}
+#else
 	steps = (steps / _count) >> 1;
 
 	for (axis_t i = 0; i < NUM_AXIS; i++)
 	{
 		_add[i] = steps;
 	}
+#endif
 
 	_n    = 0;
 	_rest = 0;
 #ifndef REDUCED_SIZE
 	_sumTimer = 0;
 #endif
+#ifdef STEPPER_SCURVE
+	_sJerkTime = 0;
+#endif
 }
 
 ////////////////////////////////////////////////////////
 
-bool CStepper::SMovementState::CalcTimerAcc(timer_t maxtimer, mdist_t n, uint8_t cnt)
+bool CStepper::SMovementState::CalcTimerAcc(stepper_timer_t maxtimer, mdist_t n, uint8_t cnt)
 {
 	// use for float: Cn = Cn-1 - 2*Cn-1 / (4*N + 1)
 	// use for INTEGER:
@@ -1773,7 +2203,47 @@ bool CStepper::SMovementState::CalcTimerAcc(timer_t maxtimer, mdist_t n, uint8_t
 
 ////////////////////////////////////////////////////////
 
-bool CStepper::SMovementState::CalcTimerDec(timer_t minTimer, mdist_t n, uint8_t cnt)
+#ifdef STEPPER_RAMPLOOKUP
+
+bool CStepper::SMovementState::CalcTimerLookup(stepper_timer_t timerAccDec, stepper_timer_t limitTimer, mdist_t n, bool acc)
+{
+	// absolute timer of step n of the ramp from (or to) v=0 => no division and no rest
+	// never reverse the current ramp (e.g. after the correction of the first step)
+
+	stepper_timer_t timer = CStepper::GetTimerFromLookup(n, timerAccDec);
+
+	if (acc)
+	{
+		if (timer <= limitTimer)
+		{
+			_timer = limitTimer;
+			return true;
+		}
+		if (timer < _timer)
+		{
+			_timer = timer;
+		}
+	}
+	else
+	{
+		if (timer >= limitTimer || n <= 1)
+		{
+			_timer = limitTimer;
+			return true;
+		}
+		if (timer > _timer)
+		{
+			_timer = timer;
+		}
+	}
+	return false;
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
+bool CStepper::SMovementState::CalcTimerDec(stepper_timer_t minTimer, mdist_t n, uint8_t cnt)
 {
 	// use for float: Cn = Cn-1 + 2*Cn-1 / (4*N - 1)
 	// use for INTEGER:
@@ -1803,6 +2273,156 @@ bool CStepper::SMovementState::CalcTimerDec(timer_t minTimer, mdist_t n, uint8_t
 
 ////////////////////////////////////////////////////////
 
+#ifdef STEPPER_SCURVE
+
+mdist_t CStepper::SMovement::GetSCurveSteps(uint32_t speedSum, stepper_timer_t timerAccDec) const
+{
+	// additional steps of a S-curve ramp (v0+v1 = speedSum) compared to the trapezoid
+	// the ramp is longer by the jerk phase tj = a/jerk => (v0+v1)/2 * tj
+
+	if (_pod._move._rampJerk == 0)
+	{
+		return 0;
+	}
+
+	uint64_t steps = uint64_t(speedSum) * _stepper->GetAccelerationFromTimer(timerAccDec) / (2 * uint64_t(_pod._move._rampJerk)) + 1;
+
+	return steps > mdist_t(-1) ? mdist_t(-1) : mdist_t(steps);
+}
+
+////////////////////////////////////////////////////////
+
+mdist_t CStepper::SMovement::GetPlanSteps() const
+{
+	// steps the planner can use for the trapezoid, the jerk phase is calculated with the max speed of the movement
+
+	mdist_t jerkSteps = GetSCurveSteps(2 * uint32_t(_stepper->TimerToSpeed(_pod._move._timerMax)), min(GetUpTimerAcc(), GetDownTimerDec()));
+
+	return _steps > jerkSteps ? _steps - jerkSteps : 1;
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::SMovementState::InitSCurve(stepper_timer_t timerTarget, mdist_t steps, uint32_t jerk)
+{
+	// S-curve from the current speed (_timer) to timerTarget within "steps"
+	// duration: T = 2*steps / (v0+v1)
+	// v(t) = v0 + dv*t^2/(2*tj*(T-tj))			0 <= t < tj		jerk
+	// v(t) = v0 + dv*(2*t-tj)/(2*(T-tj))		tj <= t < T-tj	const acc
+	// v(t) = v1 - dv*(T-t)^2/(2*tj*(T-tj))		T-tj <= t < T	jerk
+	// with a = jerk*tj and dv = a*(T-tj) => tj*(T-tj) = dv/jerk
+	// the ramp has the steps of the trapezoid and of the jerk phase (RampRun, GetSCurveSteps) => T >= dv/a + a/jerk => acceleration <= a
+
+	_sJerkTime    = 0;
+	_sTimerTarget = timerTarget;
+	_rest         = 0;
+
+	if (jerk == 0 || steps == 0)
+	{
+		return;
+	}
+
+	uint32_t v0 = TIMER1FREQUENCE / _timer;
+	uint32_t v1 = TIMER1FREQUENCE / timerTarget;
+
+	if (v0 == v1)
+	{
+		return;
+	}
+
+	_sV0   = v0;
+	_sDown = v1 < v0;
+	_sDv   = _sDown ? v0 - v1 : v1 - v0;
+	_sTime = 0;
+
+	uint64_t totalTime = uint64_t(2) * steps * TIMER1FREQUENCE / (v0 + v1);
+	uint64_t k         = uint64_t(_sDv) * TIMER1FREQUENCE * TIMER1FREQUENCE / jerk; // tj*(T-tj) in timer ticks^2
+
+	// 64 bit overrun in CalcTimerSCurve: dv*t^2 => t < 2^21
+
+	_sShift = 0;
+	while ((totalTime >> _sShift) >= (1ul << 21))
+	{
+		_sShift++;
+	}
+	totalTime >>= _sShift;
+	k >>= 2 * _sShift;
+
+	uint64_t halfTime = totalTime / 2;
+	uint64_t jerkTime;
+
+	if (halfTime == 0 || k / halfTime >= halfTime)
+	{
+		// jerk limit not possible within T => no const acc phase
+		jerkTime = halfTime;
+	}
+	else
+	{
+		// smaller root of tj^2 - T*tj + k = 0, iterate tj = k/(T-tj)
+		jerkTime = k / totalTime;
+		jerkTime = k / (totalTime - jerkTime);
+		jerkTime = k / (totalTime - jerkTime);
+	}
+
+	if (jerkTime == 0)
+	{
+		jerkTime = 1;
+	}
+
+	if (totalTime < 2)
+	{
+		return;
+	}
+
+	_sTotalTime = uint32_t(totalTime);
+	_sJerkTime  = uint32_t(jerkTime);
+}
+
+////////////////////////////////////////////////////////
+
+bool CStepper::SMovementState::CalcTimerSCurve(uint8_t cnt)
+{
+	// return true if end of ramp is reached
+
+	_sTime += uint32_t(_timer) * cnt;
+
+	uint32_t t = _sTime >> _sShift;
+
+	if (t >= _sTotalTime)
+	{
+		_timer     = _sTimerTarget;
+		_sJerkTime = 0;
+		return true;
+	}
+
+	uint32_t tj      = _sJerkTime;
+	uint32_t accTime = _sTotalTime - tj;
+	uint32_t dv;
+
+	if (t < tj)
+	{
+		dv = uint32_t(uint64_t(_sDv) * t * t / (uint64_t(2 * tj) * accTime));
+	}
+	else if (t < accTime)
+	{
+		dv = uint32_t(uint64_t(_sDv) * (2 * t - tj) / (uint64_t(2) * accTime));
+	}
+	else
+	{
+		t  = _sTotalTime - t;
+		dv = _sDv - uint32_t(uint64_t(_sDv) * t * t / (uint64_t(2 * tj) * accTime));
+	}
+
+	uint32_t timer = TIMER1FREQUENCE / (_sDown ? _sV0 - dv : _sV0 + dv);
+
+	_timer = stepper_timer_t(min(timer, uint32_t(TIMER1MAX)));
+	return false;
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 bool CStepper::SMovement::IsEndWait() const
 {
 	if (_pod._wait._checkWaitConditional)
@@ -1838,7 +2458,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 		if (
 			stepper->_stepBuffer.IsFull() ||
-			((_state == SMovement::StateReadyWait || _state == SMovement::StateReadyIo) && stepper->_stepBuffer.Count() > SYNC_STEPBUFFERCOUNT)
+			((_state == SMovement::StateReadyWait || _state == SMovement::StateReadyIo || (_state == SMovement::StateReadyMove && _hasIo)) && stepper->_stepBuffer.Count() > SYNC_STEPBUFFERCOUNT)
 			)
 		{
 			// cannot add to queue
@@ -1849,6 +2469,16 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 		{
 			// Start of move/wait
 
+			if (_state == SMovement::StateReadyMove && stepper->_pod._speedEvent && !stepper->_speedMark.IsFull())
+			{
+				// StepOut changes the reference of the speed level with the first step of the movement
+				// queue full (many short movements in the step buffer) => keep the previous reference
+				SSpeedMark& mark = stepper->_speedMark.NextTail();
+				mark.Idx         = stepper->_stepBuffer.GetNextTailPos();
+				mark.TimerRun    = _pod._move._timerRun;
+				stepper->_speedMark.Enqueue();
+			}
+
 			mvState->Init(this);
 
 			for (i = 0; i < NUM_AXIS; i++)
@@ -1871,6 +2501,10 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 					mvState->_n = _steps;
 				}
 			}
+			else if (_state == SMovement::StateReadyMove && _hasIo)
+			{
+				stepper->CallEvent(OnIoEvent, uintptr_t(&_moveIo));
+			}
 			if (_state == SMovement::StateReadyIo)
 			{
 				stepper->CallEvent(OnIoEvent, uintptr_t(&_pod._io));
@@ -1900,6 +2534,71 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 			return true;
 		}
 
+#ifdef STEPPER_DDA
+		{
+			// calculate f for step-buffer
+			// oversampling level: as few steps per ISR as possible, ISR rate <= MAXINTERRUPTSPEED
+
+			if (IsActiveMove())
+			{
+				count = 1;
+				for (stepper_timer_t t = mvState->_timer; t < TIMER1VALUE(MAXINTERRUPTSPEED) && count < 7; t += mvState->_timer)
+				{
+					count++;
+				}
+				mvState->_count = count;
+
+				if (_steps - n < count)
+				{
+					count = uint8_t(_steps - n); // must fit in unsigned char
+				}
+			}
+
+			DirCount_t stepCount = 0;
+			DirCount_t stepUnit  = 1;
+			DirCount_t dirMask   = 8;
+
+			if (_backlash)
+			{
+				DirCountByte_t x        = DirCountByte_t(); //POD
+				x.byte.byteInfo.nocount = 1;
+				stepCount += x.all;
+			}
+
+			for (i = 0;; i++)
+			{
+				uint32_t increment = _ddaIncrement[i];
+				if (increment != 0)
+				{
+					uint32_t phase     = mvState->_phase[i];
+					uint8_t  axisSteps = 0;
+
+					for (uint8_t c = 0; c < count; c++)
+					{
+						uint32_t oldPhase = phase;
+						phase += increment;
+						if (phase < oldPhase)
+						{
+							axisSteps++;
+						}
+					}
+					mvState->_phase[i] = phase;
+
+					if (axisSteps != 0)
+					{
+						stepCount += (_dirCount & dirMask) + stepUnit * axisSteps;
+					}
+				}
+				if (i == NUM_AXIS - 1)
+				{
+					break;
+				}
+				stepUnit *= 16;
+				dirMask *= 16;
+			}
+			stepper->_stepBuffer.NextTail().Init(stepCount);
+		}
+#else
 		{
 			// calculate f for step-buffer
 
@@ -1941,6 +2640,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 				stepper->_stepBuffer.NextTail().Init(stepCount);
 			}
 		}
+#endif
 
 		////////////////////////////////////
 		// calc new timer
@@ -1954,6 +2654,14 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 			else
 			{
 				_state = mvState->_timer > _pod._move._ramp._timerRun ? StateUpAcc : StateUpDec;
+#ifdef STEPPER_SCURVE
+				mvState->InitSCurve(_pod._move._ramp._timerRun, _pod._move._ramp._upSteps, _pod._move._rampJerk);
+				if (mvState->_sJerkTime != 0)
+				{
+					// S-curve: no correction of first step
+				}
+				else
+#endif
 				if (mvState->_count > 1 && _pod._move._ramp._nUpOffset == 0)
 				{
 					static const uint16_t corrTab[][2] PROGMEM =
@@ -1966,7 +2674,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 					};
 					uint16_t mul    = pgm_read_word(&corrTab[mvState->_count - 2][0]);
 					uint16_t div    = pgm_read_word(&corrTab[mvState->_count - 2][1]);
-					mvState->_timer = timer_t(MulDivU32(mvState->_timer, mul, div));
+					mvState->_timer = stepper_timer_t(MulDivU32(mvState->_timer, mul, div));
 				}
 				else if (mvState->_count <= 1 && _pod._move._ramp._nUpOffset == 0 && _state == StateUpDec)
 				{
@@ -1990,14 +2698,36 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 				{
 					mvState->_rest = 0;
 					_state         = _pod._move._ramp._timerStop > mvState->_timer ? StateDownDec : StateDownAcc;
+#ifdef STEPPER_SCURVE
+					mvState->InitSCurve(_pod._move._ramp._timerStop, _steps - n, _pod._move._rampJerk);
+#endif
 				}
 			}
 
+#ifdef STEPPER_SCURVE
+			if (mvState->_sJerkTime != 0 && _state != StateRun)
+			{
+				if (_state < StateRun && mvState->_sTimerTarget != _pod._move._ramp._timerRun)
+				{
+					// ramp changed while accelerating => continue with current speed
+					mvState->InitSCurve(_pod._move._ramp._timerRun, _pod._move._ramp._upSteps > n ? _pod._move._ramp._upSteps - n : 1, _pod._move._rampJerk);
+				}
+				if ((mvState->_sJerkTime == 0 || mvState->CalcTimerSCurve(count)) && _state < StateRun)
+				{
+					_state = StateRun;
+				}
+			}
+			else
+#endif
 			switch (_state)
 			{
 				case StateUpAcc:
 				{
+#ifdef STEPPER_RAMPLOOKUP
+					if (mvState->CalcTimerLookup(GetUpTimerAcc(), _pod._move._ramp._timerRun, n + _pod._move._ramp._nUpOffset, true))
+#else
 					if (mvState->CalcTimerAcc(_pod._move._ramp._timerRun, n + _pod._move._ramp._nUpOffset, count))
+#endif
 					{
 						_state = StateRun;
 					}
@@ -2006,7 +2736,11 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 				case StateUpDec:
 				{
+#ifdef STEPPER_RAMPLOOKUP
+					if (mvState->CalcTimerLookup(GetUpTimerDec(), _pod._move._ramp._timerRun, _pod._move._ramp._nUpOffset > n ? _pod._move._ramp._nUpOffset - n : 0, false))
+#else
 					if (mvState->CalcTimerDec(_pod._move._ramp._timerRun, _pod._move._ramp._nUpOffset - n, count))
+#endif
 					{
 						_state = StateRun;
 					}
@@ -2015,20 +2749,28 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 				case StateDownDec:
 				{
+#ifdef STEPPER_RAMPLOOKUP
+					mvState->CalcTimerLookup(GetDownTimerDec(), _pod._move._ramp._timerStop, _steps - n + _pod._move._ramp._nDownOffset, false);
+#else
 					mvState->CalcTimerDec(_pod._move._ramp._timerStop, _steps - n + _pod._move._ramp._nDownOffset, count);
+#endif
 					break;
 				}
 
 				case StateDownAcc:
 				{
+#ifdef STEPPER_RAMPLOOKUP
+					mvState->CalcTimerLookup(GetDownTimerAcc(), _pod._move._ramp._timerStop, _pod._move._ramp._nDownOffset - (_steps - n - 1), true);
+#else
 					mvState->CalcTimerAcc(_pod._move._ramp._timerStop, _pod._move._ramp._nDownOffset - (_steps - n - 1), count);
+#endif
 					break;
 				}
 				default: break;
 			}
 		}
 
-		timer_t t = mvState->_timer * count;
+		stepper_timer_t t = mvState->_timer * count;
 
 #ifndef REDUCED_SIZE
 		if (stepper->GetSpeedOverride() != CStepper::SpeedOverride100P)
@@ -2045,7 +2787,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 			}
 			else
 			{
-				t = timer_t(tl);
+				t = stepper_timer_t(tl);
 			}
 		}
 
@@ -2135,9 +2877,9 @@ void CStepper::QueueAndSplitStep(const udist_t dist[NUM_AXIS], const bool direct
 
 	uint8_t stepMult = 1;
 
-	timer_t timerMax = vMax == 0 ? _pod._timerMaxDefault : SpeedToTimer(vMax);
+	stepper_timer_t timerMax = vMax == 0 ? _pod._timerMaxDefault : SpeedToTimer(vMax);
 
-	while (timerMax == timer_t(-1))
+	while (timerMax == stepper_timer_t(-1))
 	{
 		stepMult++;
 		timerMax = SpeedToTimer(vMax * stepMult);
@@ -2204,6 +2946,7 @@ void CStepper::QueueAndSplitStep(const udist_t dist[NUM_AXIS], const bool direct
 
 bool CStepper::MoveUntil(TestContinueMove testContinue, uintptr_t param)
 {
+
 	while (IsBusy())
 	{
 		if (!testContinue(param))
@@ -2222,6 +2965,7 @@ bool CStepper::MoveUntil(uint8_t referenceId, bool referenceValue, uint16_t stab
 {
 	uint32_t time = 0;
 
+
 	while (IsBusy())
 	{
 		if (IsReferenceTest(referenceId) == referenceValue)
@@ -2273,7 +3017,7 @@ bool CStepper::MoveReference(axis_t axis, uint8_t referenceId, bool toMin, stepr
 	CPushValue<bool>    OldLimitCheck(&_pod._limitCheck, false);
 	CPushValue<bool>    OldWaitFinishMove(&_pod._waitFinishMove, false);
 	CPushValue<bool>    OldCheckForReference(&_pod._checkReference, false);
-	CPushValue<timer_t> OldBacklashEnabled(&_pod._timerBacklash, (timer_t(-1)));
+	CPushValue<stepper_timer_t> OldBacklashEnabled(&_pod._timerBacklash, (stepper_timer_t(-1)));
 
 	if (vMax == 0)
 	{
@@ -2391,6 +3135,51 @@ void CStepper::WaitClock(uint32_t clock)
 ////////////////////////////////////////////////////////
 
 void CStepper::IoControl(uint8_t tool, uint16_t level)
+{
+	FlushMoveIo();
+	QueueIoControl(tool, level);
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::MoveIoControl(uint8_t tool, uint16_t level)
+{
+	// a second io (of an other tool) without move in between => the first one needs its own queue entry
+	if (_pod._moveIoPending && _pod._moveIo._tool != tool)
+	{
+		FlushMoveIo();
+	}
+
+	_pod._moveIo._tool  = tool;
+	_pod._moveIo._level = level;
+	_pod._moveIoPending = true;
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::FlushMoveIo()
+{
+	if (_pod._moveIoPending)
+	{
+		_pod._moveIoPending = false;
+		QueueIoControl(_pod._moveIo._tool, _pod._moveIo._level);
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::MoveIoPoll()
+{
+	// stepper is idle => there is no next move yet, do not wait for it (e.g. laser off at the end of the program)
+	if (_pod._moveIoPending && !IsBusy())
+	{
+		FlushMoveIo();
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void CStepper::QueueIoControl(uint8_t tool, uint16_t level)
 {
 	WaitUntilCanQueue();
 	_movements._queue.NextTail().InitIoControl(this, tool, level);
@@ -2523,6 +3312,10 @@ void CStepper::SetPosition(axis_t axis, udist_t pos)
 #endif
 	_pod._current[axis]       = pos;
 	_pod._calculatedPos[axis] = pos;
+
+#ifdef STEPPER_STATUS
+	SetStatus(0, 0);
+#endif
 }
 
 ////////////////////////////////////////////////////////
@@ -2538,25 +3331,25 @@ void CStepper::SetSlip(int d[NUM_AXIS])
 
 ////////////////////////////////////////////////////////
 
-timer_t CStepper::SpeedToTimer(steprate_t speed) const
+stepper_timer_t CStepper::SpeedToTimer(steprate_t speed) const
 {
 	if (speed == 0)
 	{
-		return timer_t(-1);
+		return stepper_timer_t(-1);
 	}
 
 	uint32_t timer = TIMER1FREQUENCE / speed;
-	if (timer > (timer_t(-1)))
+	if (timer > (stepper_timer_t(-1)))
 	{
-		return timer_t(-1);
+		return stepper_timer_t(-1);
 	}
 
-	return timer_t(timer);
+	return stepper_timer_t(timer);
 }
 
 ////////////////////////////////////////////////////////
 
-steprate_t CStepper::TimerToSpeed(timer_t timer) const
+steprate_t CStepper::TimerToSpeed(stepper_timer_t timer) const
 {
 	return SpeedToTimer(timer);
 }
@@ -2627,7 +3420,7 @@ void CStepper::Dump(uint8_t options)
 
 		//		DumpArray<EnumAsByte(EStepMode), NUM_AXIS>(F("StepMode"), _stepMode, true);
 
-		DumpType<timer_t>(F("TimerMaxDefault"), _pod._timerMaxDefault, false);
+		DumpType<stepper_timer_t>(F("TimerMaxDefault"), _pod._timerMaxDefault, false);
 
 		DumpArray<steprate_t, NUM_AXIS>(F("MaxJerkSpeed"), _pod._maxJerkSpeed, false);
 		DumpArray<steprate_t, NUM_AXIS>(F("TimerMax"), _pod._timerMax, false);
@@ -2637,19 +3430,19 @@ void CStepper::Dump(uint8_t options)
 
 	if (options & DumpMovements)
 	{
-		uint8_t idxNoChange = _movements._queue.H2TInit();
+		movementidx_t idxNoChange = _movements._queue.H2TInit();
 
-		i = 0;
-		for (uint8_t idx = idxNoChange; _movements._queue.H2TTest(idx); idx = _movements._queue.H2TInc(idx))
+		movementidx_t mvNo = 0;
+		for (movementidx_t idx = idxNoChange; _movements._queue.H2TTest(idx); idx = _movements._queue.H2TInc(idx))
 		{
-			_movements._queue.Buffer[idx].Dump(i++, options);
+			_movements._queue.Buffer[idx].Dump(mvNo++, options);
 		}
 
 		/*
-		DumpType<uint8_t>(F("StepsHead"), _stepBuffer.GetHeadPos(), false);
-		DumpType<uint8_t>(F("Tail"), _stepBuffer.GetTailPos(), false);
+		DumpType<stepbufferidx_t>(F("StepsHead"), _stepBuffer.GetHeadPos(), false);
+		DumpType<stepbufferidx_t>(F("Tail"), _stepBuffer.GetTailPos(), false);
 
-		for (uint8_t idx = 0; idx < STEPBUFFERSIZE; idx++)
+		for (uint16_t idx = 0; idx < STEPBUFFERSIZE; idx++)
 		{
 			_stepBuffer.Buffer[idx].Dump(options);
 		}
@@ -2660,12 +3453,12 @@ void CStepper::Dump(uint8_t options)
 
 ////////////////////////////////////////////////////////
 
-void CStepper::SMovement::Dump(uint8_t idx, uint8_t options)
+void CStepper::SMovement::Dump(movementidx_t idx, uint8_t options)
 {
 #ifdef _NO_DUMP
 	(void) idx; (void) options;
 #else
-	DumpType<uint8_t>(F("Idx"), idx, false);
+	DumpType<movementidx_t>(F("Idx"), idx, false);
 	if (idx == 0)
 	{
 		_stepper->_movementState.Dump(options);
@@ -2685,6 +3478,11 @@ void CStepper::SMovement::Dump(uint8_t idx, uint8_t options)
 	}
 	else
 	{
+		if (_hasIo)
+		{
+			DumpType<mdist_t>(F("tool"), _moveIo._tool, false);
+			DumpType<mdist_t>(F("level"), _moveIo._level, false);
+		}
 		DumpType<DirCount_t>(F("DirCount"), _dirCount, false);
 		DumpType<DirCount_t>(F("LastDirCount"), _lastStepDirCount, false);
 		DumpArray<mdist_t, NUM_AXIS>(F("Dist"), _distance_, false);
@@ -2695,18 +3493,18 @@ void CStepper::SMovement::Dump(uint8_t idx, uint8_t options)
 		DumpType<mdist_t>(F("UpOffset"), _pod._move._ramp._nUpOffset, false);
 		DumpType<mdist_t>(F("DownOffset"), _pod._move._ramp._nDownOffset, false);
 
-		DumpType<timer_t>(F("tMax"), _pod._move._timerMax, false);
-		DumpType<timer_t>(F("tRun"), _pod._move._ramp._timerRun, false);
-		DumpType<timer_t>(F("tStart"), _pod._move._ramp._timerStart, false);
-		DumpType<timer_t>(F("tStop"), _pod._move._ramp._timerStop, false);
-		DumpType<timer_t>(F("tEndPossible"), _pod._move._timerEndPossible, false);
-		DumpType<timer_t>(F("tJunctionToPrev"), _pod._move._timerJunctionToPrev, false);
-		DumpType<timer_t>(F("tMaxJunction"), _pod._move._timerMaxJunction, false);
+		DumpType<stepper_timer_t>(F("tMax"), _pod._move._timerMax, false);
+		DumpType<stepper_timer_t>(F("tRun"), _pod._move._ramp._timerRun, false);
+		DumpType<stepper_timer_t>(F("tStart"), _pod._move._ramp._timerStart, false);
+		DumpType<stepper_timer_t>(F("tStop"), _pod._move._ramp._timerStop, false);
+		DumpType<stepper_timer_t>(F("tEndPossible"), _pod._move._timerEndPossible, false);
+		DumpType<stepper_timer_t>(F("tJunctionToPrev"), _pod._move._timerJunctionToPrev, false);
+		DumpType<stepper_timer_t>(F("tMaxJunction"), _pod._move._timerMaxJunction, false);
 
 		if (options & DumpDetails)
 		{
-			DumpType<timer_t>(F("TimerAcc"), _pod._move._timerAcc, false);
-			DumpType<timer_t>(F("TimerDec"), _pod._move._timerDec, false);
+			DumpType<stepper_timer_t>(F("TimerAcc"), _pod._move._timerAcc, false);
+			DumpType<stepper_timer_t>(F("TimerDec"), _pod._move._timerDec, false);
 		}
 	}
 
@@ -2720,11 +3518,20 @@ void CStepper::SMovementState::Dump(uint8_t /* options */)
 {
 #ifndef _NO_DUMP
 	DumpType<mdist_t>(F("n"), _n, false);
-	DumpType<timer_t>(F("t"), _timer, false);
-	DumpType<timer_t>(F("r"), _rest, false);
+	DumpType<stepper_timer_t>(F("t"), _timer, false);
+	DumpType<stepper_timer_t>(F("r"), _rest, false);
 	DumpType<uint32_t>(F("sum"), _sumTimer, false);
+#ifdef STEPPER_DDA
+	DumpArray<uint32_t, NUM_AXIS>(F("p"), _phase, false);
+#else
 	DumpArray<mdist_t, NUM_AXIS>(F("a"), _add, false);
 #endif
+#ifdef STEPPER_SCURVE
+	DumpType<uint32_t>(F("st"), _sTime, false);
+	DumpType<uint32_t>(F("sT"), _sTotalTime, false);
+	DumpType<uint32_t>(F("sj"), _sJerkTime, false);
+#endif
+#endif
 }
 
 ////////////////////////////////////////////////////////
@@ -2733,6 +3540,6 @@ void CStepper::SStepBuffer::Dump(uint8_t /* options */)
 {
 #ifndef _NO_DUMP
 	DumpType<DirCount_t>(F("d"), DirStepCount, false);
-	DumpType<timer_t>(F("t"), Timer, false);
+	DumpType<stepper_timer_t>(F("t"), Timer, false);
 #endif
 }
\ No newline at end of file
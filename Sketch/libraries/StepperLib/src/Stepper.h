@@ -59,8 +59,9 @@ public:
 		OnWarningEvent,
 		OnInfoEvent,
 		OnIoEvent,
+		OnSpeedEvent,											// speed level changed (0..255, current/programmed speed), called by SpeedEventPoll, see SetSpeedEvent
 
-		LastStepperEvent = OnIoEvent
+		LastStepperEvent = OnSpeedEvent
 	};
 
 #define LevelToPercent(a) ((a)*100/255)
@@ -186,21 +187,32 @@ public:
 
 	void SetJerkSpeed(axis_t axis, steprate_t vMaxJerk) { _pod._maxJerkSpeed[axis] = vMaxJerk; }
 
+#ifdef STEPPER_SCURVE
+	void SetRampJerk(axis_t axis, uint32_t jerk) { _pod._rampJerk[axis] = jerk; }
+#endif
+
 	void SetWaitFinishMove(bool wait) { _pod._waitFinishMove = wait; }
 	bool IsWaitFinishMove() const { return _pod._waitFinishMove; }
 
+	void SetSpeedEvent(bool speedEvent) { _pod._speedEvent = speedEvent; }
+	bool IsSpeedEvent() const { return _pod._speedEvent; }
+
+	void    SpeedEventPoll();									// call OnSpeedEvent if the speed level changed (not in ISR), see SetSpeedEvent
+	uint8_t GetSpeedLevel() const { return _pod._speedLevelEvent; }	// level of the last OnSpeedEvent
+
 	void SetCheckForReference(bool check) { _pod._checkReference = check; }
 	bool IsCheckForReference() const { return _pod._checkReference; }
 
 	void       SetBacklash(steprate_t speed) { _pod._timerBacklash = SpeedToTimer(speed); }
-	bool       IsSetBacklash() const { return timer_t(-1) != _pod._timerBacklash; }
+	bool       IsSetBacklash() const { return stepper_timer_t(-1) != _pod._timerBacklash; }
 	steprate_t GetBacklash() const { return TimerToSpeed(_pod._timerBacklash); }
 
 	bool IsBusy() const { return _pod._timerRunning; }
 	void WaitBusy();
 
 	bool    CanQueueMovement() const { return !_movements._queue.IsFull(); }
-	uint8_t QueuedMovements() const { return _movements._queue.Count(); }
+	movementidx_t QueuedMovements() const { return _movements._queue.Count(); }
+	uint16_t OptimizeTouchedMovements() const { return _movements._optimizeTouched; }	// movements touched by last OptimizeMovementQueue
 
 	uint16_t GetEnableTimeout() const { return _pod._timeOutEnableAll; }
 	void     SetEnableTimeout(uint16_t sec) { _pod._timeOutEnableAll = sec; }
@@ -264,7 +276,10 @@ public:
 	void WaitConditional(unsigned int sec100);						// wait specified time with check condition
 	void WaitClock(uint32_t clock);									// wait until clock
 	void WaitClockConditional(uint32_t clock);						// wait until clock swith check condition
-	void IoControl(uint8_t tool, uint16_t level);
+	void IoControl(uint8_t tool, uint16_t level);					// queue io as own entry (stop at the end of the previous move)
+	void MoveIoControl(uint8_t tool, uint16_t level);				// set io at the start of the next move (no queue entry, no stop)
+	void MoveIoPoll();												// queue the io of MoveIoControl if the stepper is idle (no next move), call while waiting for input
+	bool IsMoveIoPending() const { return _pod._moveIoPending; }		// MoveIoControl called, io not queued yet
 
 	bool MoveUntil(TestContinueMove testContinue, uintptr_t param);
 
@@ -286,6 +301,33 @@ public:
 		return (*const_cast<volatile udist_t*>(&_pod._current[axis]));
 	}
 
+#ifdef STEPPER_STATUS
+
+	enum EStatusState
+	{
+		StatusIdle = 0,
+		StatusRun,
+		StatusHold,
+		StatusEmergencyStop
+	};
+
+	struct SStatus
+	{
+		udist_t                    Current[NUM_AXIS];	// see GetCurrentPositions
+		stepper_timer_t            Timer;				// of last step, 0 if idle
+		uint8_t                    StepMultiplier;		// max steps of an axis in the last step
+		EnumAsByte(ESpeedOverride) SpeedOverride;
+		EnumAsByte(EStatusState)   State;
+		movementidx_t              MovementCount;
+		stepbufferidx_t            StepBufferCount;
+
+		steprate_t GetStepRate() const { return Timer == 0 ? 0 : steprate_t(TIMER1FREQUENCE / Timer) * StepMultiplier; }
+	};
+
+	void GetStatus(SStatus& status) const;			// consistent snapshot, no CCriticalRegion (may be called often)
+
+#endif
+
 	udist_t GetLimitMax(axis_t axis) const { return _pod._limitMax[axis]; }
 #ifdef REDUCED_SIZE
 	udist_t GetLimitMin(axis_t ) const							{ return 0; }
@@ -302,6 +344,9 @@ public:
 	steprate_t GetAcc(axis_t axis) const { return TimerToSpeed(_pod._timerAcc[axis]); }
 	steprate_t GetDec(axis_t axis) const { return TimerToSpeed(_pod._timerDec[axis]); }
 	steprate_t GetJerkSpeed(axis_t axis) const { return _pod._maxJerkSpeed[axis]; }
+#ifdef STEPPER_SCURVE
+	uint32_t GetRampJerk(axis_t axis) const { return _pod._rampJerk[axis]; }
+#endif
 
 #ifndef REDUCED_SIZE
 	uint32_t     GetTotalSteps() const { return _pod._totalSteps; }
@@ -329,10 +374,23 @@ public:
 private:
 	bool SetEnableSafe(axis_t i, uint8_t level, bool force);
 
-	void QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax, uint8_t stepMult);
-	void QueueWait(const mdist_t dist, timer_t timerMax, uint32_t clock, bool checkWaitConditional);
+	void QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], stepper_timer_t timerMax, uint8_t stepMult);
+	void QueueWait(const mdist_t dist, stepper_timer_t timerMax, uint32_t clock, bool checkWaitConditional);
+	void QueueIoControl(uint8_t tool, uint16_t level);
+	void FlushMoveIo();
 
 	void EnqueueAndStartTimer(bool waitFinish);
+
+	void DequeueMovement()
+	{
+		// planned movement is finished => next is planned
+		if (_movements._idxPlanned == _movements._queue.GetHeadPos())
+		{
+			_movements._idxPlanned = _movements._queue.NextIndex(_movements._idxPlanned);
+		}
+		_movements._queue.Dequeue();
+	}
+
 	void WaitUntilCanQueue();
 	bool StartMovement();
 
@@ -346,7 +404,11 @@ private:
 	}
 
 	inline void StepOut();
+	inline void SetSpeedLevel(stepper_timer_t timer, uint8_t stepMultiplier);
 	inline void StartBackground();
+#ifdef STEPPER_STATUS
+	inline void SetStatus(stepper_timer_t timer, uint8_t stepMultiplier);
+#endif
 	inline void FillStepBuffer();
 	void        Background();
 
@@ -367,25 +429,29 @@ protected:
 
 	////////////////////////////////////////////////////////
 
-	timer_t GetTimer(mdist_t steps, timer_t timerStart);										// calc "speed" after steps with constant a (from v0 = 0)
-	timer_t GetTimerAccelerating(mdist_t steps, timer_t timerV0, timer_t timerStart);			// calc "speed" after steps accelerating with constant a 
-	timer_t GetTimerDecelerating(mdist_t steps, timer_t timerV, timer_t timerStart);			// calc "speed" after steps decelerating with constant a 
+	stepper_timer_t GetTimer(mdist_t steps, stepper_timer_t timerStart);										// calc "speed" after steps with constant a (from v0 = 0)
+	stepper_timer_t GetTimerAccelerating(mdist_t steps, stepper_timer_t timerV0, stepper_timer_t timerStart);			// calc "speed" after steps accelerating with constant a 
+	stepper_timer_t GetTimerDecelerating(mdist_t steps, stepper_timer_t timerV, stepper_timer_t timerStart);			// calc "speed" after steps decelerating with constant a 
 
-	static mdist_t GetAccSteps(timer_t timer, timer_t timerStart);										// from v=0
-	static mdist_t GetDecSteps(timer_t timer, timer_t timerStop) { return GetAccSteps(timer, timerStop); } // to v=0
+	static mdist_t GetAccSteps(stepper_timer_t timer, stepper_timer_t timerStart);										// from v=0
+	static mdist_t GetDecSteps(stepper_timer_t timer, stepper_timer_t timerStop) { return GetAccSteps(timer, timerStop); } // to v=0
 
-	static mdist_t GetAccSteps(timer_t timer1, timer_t timer2, timer_t timerStart);				// from v1 to v2 (v1<v2)
-	static mdist_t GetDecSteps(timer_t timer1, timer_t timer2, timer_t timerStop) { return GetAccSteps(timer2, timer1, timerStop); }
+	static mdist_t GetAccSteps(stepper_timer_t timer1, stepper_timer_t timer2, stepper_timer_t timerStart);				// from v1 to v2 (v1<v2)
+	static mdist_t GetDecSteps(stepper_timer_t timer1, stepper_timer_t timer2, stepper_timer_t timerStop) { return GetAccSteps(timer2, timer1, timerStop); }
 
-	static mdist_t GetSteps(timer_t timer1, timer_t timer2, timer_t timerStart, timer_t timerStop);		// from v1 to v2 (v1<v2 uses acc, dec otherwise)
+	static mdist_t GetSteps(stepper_timer_t timer1, stepper_timer_t timer2, stepper_timer_t timerStart, stepper_timer_t timerStop);		// from v1 to v2 (v1<v2 uses acc, dec otherwise)
 
 	uint32_t GetAccelerationFromTimer(mdist_t timerV0);
 	uint32_t GetAccelerationFromSpeed(steprate_t speedV0) { return GetAccelerationFromTimer(SpeedToTimer(speedV0)); }
 
-	timer_t    SpeedToTimer(steprate_t speed) const;
-	steprate_t TimerToSpeed(timer_t timer) const;
+	stepper_timer_t SpeedToTimer(steprate_t speed) const;
+	steprate_t TimerToSpeed(stepper_timer_t timer) const;
+
+	static uint8_t GetStepMultiplier(stepper_timer_t timerMax);
 
-	static uint8_t GetStepMultiplier(timer_t timerMax);
+#ifdef STEPPER_RAMPLOOKUP
+	static stepper_timer_t GetTimerFromLookup(mdist_t steps, stepper_timer_t timerStart);						// timer after steps with constant a (from v0 = 0), table index and interpolation with shifts => no sqrt and division
+#endif
 
 protected:
 	//////////////////////////////////////////
@@ -403,14 +469,24 @@ protected:
 		bool _waitFinishMove;
 		bool _limitCheck;
 
-		timer_t _timerBacklash;								// -1 or 0 for temporary enable/disable backlash without setting _backlash to 0
+		bool             _speedEvent;						// calculate the speed level for OnSpeedEvent (e.g. laser power)
+		volatile uint8_t _speedLevel;						// level of the last emitted step (set in StepOut), 0 => idle
+		uint8_t          _speedLevelEvent;					// last level of OnSpeedEvent (SpeedEventPoll)
+		uint8_t          _speedCount;						// StepOut: step multiplier of _speedLevel
+		stepper_timer_t  _speedTimer;						// StepOut: timer of _speedLevel (no division if unchanged)
+		stepper_timer_t  _speedTimerRun;					// StepOut: programmed speed of the emitted movement (level 255)
+
+		bool       _moveIoPending;							// MoveIoControl called, _moveIo is added to the next move
+		SIoControl _moveIo;
+
+		stepper_timer_t _timerBacklash;								// -1 or 0 for temporary enable/disable backlash without setting _backlash to 0
 
 #ifndef REDUCED_SIZE
 		uint32_t     _totalSteps;							// total steps since start
 		unsigned int _timerISRBusy;							// ISR while in ISR
 #endif
 
-		timer_t _timerMaxDefault;							// timerValue of vMax (if vMax = 0)
+		stepper_timer_t _timerMaxDefault;							// timerValue of vMax (if vMax = 0)
 
 		udist_t _current[NUM_AXIS];							// update in ISR
 		udist_t _calculatedPos[NUM_AXIS];					// calculated in advanced (use movement queue)
@@ -419,9 +495,13 @@ protected:
 
 		steprate_t _maxJerkSpeed[NUM_AXIS];					// immediate change of speed without ramp (in junction)
 
-		timer_t _timerMax[NUM_AXIS];						// maximum speed of axis
-		timer_t _timerAcc[NUM_AXIS];						// acc timer start
-		timer_t _timerDec[NUM_AXIS];						// dec timer start
+		stepper_timer_t _timerMax[NUM_AXIS];						// maximum speed of axis
+		stepper_timer_t _timerAcc[NUM_AXIS];						// acc timer start
+		stepper_timer_t _timerDec[NUM_AXIS];						// dec timer start
+
+#ifdef STEPPER_SCURVE
+		uint32_t _rampJerk[NUM_AXIS];						// jerk of acc/dec ramp (steps/sec^3), 0 => trapezoid
+#endif
 
 #ifndef REDUCED_SIZE
 		udist_t _limitMin[NUM_AXIS];
@@ -494,17 +574,24 @@ protected:
 
 		EnumAsByte(EMovementState) _state;				// enums are 16 bit in gcc => force byte
 		bool                       _backlash;			// move is backlash
+		bool                       _hasIo;				// call OnIoEvent with _moveIo at the start of the move
+
+		struct SIoControl _moveIo;
 
 		DirCount_t _dirCount;
 		DirCount_t _lastStepDirCount;
 
 		mdist_t _distance_[NUM_AXIS];					// distance adjusted with stepMultiplier => use GetDistance(axis)
 
+#ifdef STEPPER_DDA
+		uint32_t _ddaIncrement[NUM_AXIS];				// phase increment per step: 2^32 * distance / steps
+#endif
+
 		struct SRamp									// only modify in CCriticalRegion
 		{
-			timer_t _timerStart;						// start ramp with speed (timerValue)
-			timer_t _timerRun;
-			timer_t _timerStop;							// stop  ramp with speed (timerValue)
+			stepper_timer_t _timerStart;						// start ramp with speed (timerValue)
+			stepper_timer_t _timerRun;
+			stepper_timer_t _timerStop;							// stop  ramp with speed (timerValue)
 
 			mdist_t _upSteps;							// steps needed for accelerating from v0
 			mdist_t _downSteps;							// steps needed for decelerating to v0
@@ -513,8 +600,8 @@ protected:
 			mdist_t _nUpOffset;							// offset of n ramp calculation(acc) 
 			mdist_t _nDownOffset;						// offset of n ramp calculation(dec)
 
-			void RampUp(SMovement* movement, timer_t timerRun, timer_t timerJunction);
-			void RampDown(SMovement* movement, timer_t timerJunction);
+			void RampUp(SMovement* movement, stepper_timer_t timerRun, stepper_timer_t timerJunction);
+			void RampDown(SMovement* movement, stepper_timer_t timerJunction);
 			void RampRun(SMovement* movement);
 		};
 
@@ -522,22 +609,25 @@ protected:
 		{
 			struct SMove
 			{
-				timer_t _timerMax;								// timer for max requested speed
-				timer_t _timerRun;								// copy of _ramp. => modify during ramp calc
+				stepper_timer_t _timerMax;								// timer for max requested speed
+				stepper_timer_t _timerRun;								// copy of _ramp. => modify during ramp calc
 
-				timer_t _timerEndPossible;						// timer possible at end of last movement
-				timer_t _timerJunctionToPrev;					// used to calculate junction speed, stored in "next" step
-				timer_t _timerMaxJunction;						// max possible junction speed, stored in "next" step
+				stepper_timer_t _timerEndPossible;						// timer possible at end of last movement
+				stepper_timer_t _timerJunctionToPrev;					// used to calculate junction speed, stored in "next" step
+				stepper_timer_t _timerMaxJunction;						// max possible junction speed, stored in "next" step
 
 				struct SRamp _ramp;								// only modify in CCriticalRegion
 
-				timer_t _timerAcc;								// timer for calc of acceleration while "up" state - depend on axis
-				timer_t _timerDec;								// timer for calc of decelerating while "down" state - depend on axis
+				stepper_timer_t _timerAcc;								// timer for calc of acceleration while "up" state - depend on axis
+				stepper_timer_t _timerDec;								// timer for calc of decelerating while "down" state - depend on axis
+#ifdef STEPPER_SCURVE
+				uint32_t _rampJerk;								// jerk of acc/dec ramp (steps/sec^3) - depend on axis, 0 => trapezoid
+#endif
 			}           _move;
 
 			struct SWait
 			{
-				timer_t  _timer;
+				stepper_timer_t _timer;
 				bool     _checkWaitConditional;					// wait only if Stepper.SetConditionalWait is set
 				uint32_t _endTime;								// wait until "clock" time
 			}            _wait;
@@ -547,14 +637,14 @@ protected:
 
 		stepperstatic CStepper* _stepper;						// give access to stepper (not static if multi instance)  
 
-		timer_t GetUpTimerAcc() const { return _pod._move._timerAcc; }
-		timer_t GetUpTimerDec() const { return _pod._move._timerDec; }
+		stepper_timer_t GetUpTimerAcc() const { return _pod._move._timerAcc; }
+		stepper_timer_t GetUpTimerDec() const { return _pod._move._timerDec; }
 
-		timer_t GetDownTimerAcc() const { return _pod._move._timerAcc; }
-		timer_t GetDownTimerDec() const { return _pod._move._timerDec; }
+		stepper_timer_t GetDownTimerAcc() const { return _pod._move._timerAcc; }
+		stepper_timer_t GetDownTimerDec() const { return _pod._move._timerDec; }
 
-		timer_t GetUpTimer(bool acc) const { return acc ? GetUpTimerAcc() : GetUpTimerDec(); }
-		timer_t GetDownTimer(bool acc) const { return acc ? GetDownTimerAcc() : GetDownTimerDec(); }
+		stepper_timer_t GetUpTimer(bool acc) const { return acc ? GetUpTimerAcc() : GetUpTimerDec(); }
+		stepper_timer_t GetDownTimer(bool acc) const { return acc ? GetDownTimerAcc() : GetDownTimerDec(); }
 
 		mdist_t GetDistance(axis_t axis) const;
 		uint8_t GetStepMultiplier(axis_t axis) const { return (_dirCount >> (axis * 4)) % 8; }
@@ -563,13 +653,24 @@ protected:
 
 		bool Ramp(SMovement* mvNext);
 
+#ifdef STEPPER_SCURVE
+		mdist_t GetSCurveSteps(uint32_t speedSum, stepper_timer_t timerAccDec) const;	// additional steps of the jerk phase
+		mdist_t GetPlanSteps() const;											// steps for the trapezoid (junction speed)
+#else
+		mdist_t GetPlanSteps() const { return _steps; }
+#endif
+
 		void CalcMaxJunctionSpeed(SMovement* mvPrev);
 
 		bool AdjustJunctionSpeedT2H(SMovement* mvPrev, SMovement* mvNext);
-		void AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* mvNext);
+		bool AdjustJunctionSpeedH2T(SMovement* mvPrev, SMovement* mvNext);
 
 		bool CalcNextSteps(bool continues);
 
+#ifdef STEPPER_DDA
+		void CalcDDAIncrement();
+#endif
+
 	private:
 		bool IsEndWait() const;									// immediately end wait 
 
@@ -590,15 +691,20 @@ protected:
 
 		bool IsSkipForOptimizing() const { return IsActiveIo(); }								// skip the entry when optimizing queue
 
-		void InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t steps, const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax);
-		void InitWait(CStepper* stepper, mdist_t steps, timer_t timer, uint32_t clock, bool checkWaitConditional);
+		void InitMove(CStepper* stepper, SMovement* mvPrev, mdist_t steps, const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], stepper_timer_t timerMax);
+		void InitWait(CStepper* stepper, mdist_t steps, stepper_timer_t timer, uint32_t clock, bool checkWaitConditional);
 		void InitIoControl(CStepper* stepper, uint8_t tool, uint16_t level);
 
-		void InitStop(SMovement* mvPrev, timer_t timer, timer_t decTimer);
+		void InitStop(SMovement* mvPrev, stepper_timer_t timer, stepper_timer_t decTimer);
 
 		void SetBacklash() { _backlash = true; }
+		void SetIo(bool hasIo, const SIoControl& io)
+		{
+			_hasIo  = hasIo;
+			_moveIo = io;
+		}
 
-		void Dump(uint8_t idx, uint8_t options);
+		void Dump(movementidx_t idx, uint8_t options);
 
 #ifdef _MSC_VER
 		char _mvMSCInfo[MOVEMENTINFOSIZE];
@@ -607,12 +713,15 @@ protected:
 
 	struct SMovements
 	{
-		timer_t                                         _timerStartPossible;					// timer for fastest possible start (break at the end)
-		CRingBufferQueue<SMovement, MOVEMENTBUFFERSIZE> _queue;
+		stepper_timer_t                                     _timerStartPossible;					// timer for fastest possible start (break at the end)
+		volatile movementidx_t                              _idxPlanned;							// junction speed to this (and all previous) movement can't change any more => optimize starts here
+		uint16_t                                            _optimizeTouched;						// movements touched by last OptimizeMovementQueue
+		CRingBufferQueueSPSC<SMovement, MOVEMENTBUFFERSIZE, movementidx_t> _queue;
 	};
 
 	stepperstatic struct SMovements _movements;
 
+
 	/////////////////////////////////////////////////////////////////////
 	// internal state of move (used in ISR)
 
@@ -625,8 +734,8 @@ protected:
 		// static for performance on arduino => only one instance allowed
 
 		mdist_t _n;				// step within movement (1-_steps)
-		timer_t _timer;			// current timer
-		timer_t _rest;			// rest of ramp calculation
+		stepper_timer_t _timer;			// current timer
+		stepper_timer_t _rest;			// rest of ramp calculation
 
 		uint8_t _count;			// increment of _n
 		char    _dummyAlignment;
@@ -635,12 +744,38 @@ protected:
 		uint32_t _sumTimer;		// for debug
 #endif
 
+#ifdef STEPPER_DDA
+		uint32_t _phase[NUM_AXIS];	// DDA phase accumulator, overflow => step
+#else
 		mdist_t _add[NUM_AXIS];
+#endif
+
+#ifdef STEPPER_SCURVE
+		// S-curve of current ramp, time in timer ticks
+
+		uint32_t _sTime;			// elapsed time since start of ramp
+		uint32_t _sTotalTime;		// duration of ramp (T)
+		uint32_t _sJerkTime;		// duration of jerk phase (tj), 0 => no S-curve, use CalcTimerAcc/Dec
+		uint32_t _sV0;				// speed at start of ramp (steps/sec)
+		uint32_t _sDv;				// speed change of ramp (steps/sec)
+		stepper_timer_t _sTimerTarget;		// timer at end of ramp
+		uint8_t  _sShift;			// shift of time to avoid overrun
+		bool     _sDown;			// decelerate => dv is negative
+#endif
 
 		void Init(SMovement* movement);
 
-		bool CalcTimerAcc(timer_t maxTimer, mdist_t n, uint8_t cnt);
-		bool CalcTimerDec(timer_t minTimer, mdist_t n, uint8_t cnt);
+		bool CalcTimerAcc(stepper_timer_t maxTimer, mdist_t n, uint8_t cnt);
+		bool CalcTimerDec(stepper_timer_t minTimer, mdist_t n, uint8_t cnt);
+
+#ifdef STEPPER_RAMPLOOKUP
+		bool CalcTimerLookup(stepper_timer_t timerAccDec, stepper_timer_t limitTimer, mdist_t n, bool acc);
+#endif
+
+#ifdef STEPPER_SCURVE
+		void InitSCurve(stepper_timer_t timerTarget, mdist_t steps, uint32_t jerk);
+		bool CalcTimerSCurve(uint8_t cnt);
+#endif
 
 	public:
 		void Dump(uint8_t options);
@@ -655,7 +790,7 @@ protected:
 	{
 	public:
 		DirCount_t DirStepCount;								// direction and count
-		timer_t    Timer;
+		stepper_timer_t Timer;
 #ifdef _MSC_VER
 		mdist_t                   _distance[NUM_AXIS];			// to calculate relative speed
 		mdist_t                   _steps;
@@ -673,7 +808,20 @@ protected:
 		void Dump(uint8_t options);
 	};
 
-	stepperstatic CRingBufferQueue<SStepBuffer, STEPBUFFERSIZE> _stepBuffer;
+	stepperstatic CRingBufferQueueSPSC<SStepBuffer, STEPBUFFERSIZE, stepbufferidx_t> _stepBuffer;
+
+	struct SSpeedMark
+	{
+		stepbufferidx_t Idx;								// first entry of the movement in the step buffer
+		stepper_timer_t TimerRun;							// programmed speed of the movement
+	};
+
+	stepperstatic CRingBufferQueueSPSC<SSpeedMark, SPEEDMARKSIZE, uint8_t> _speedMark;	// written by CalcNextSteps, read by StepOut, only with SetSpeedEvent
+
+#ifdef STEPPER_STATUS
+	SStatus           _status[2];			// written in ISR: _status[(n+1)&1] while _statusSeq == 2n+1, see SetStatus
+	volatile uint32_t _statusSeq;			// 2 * count of written status (+1 while writing)
+#endif
 
 public:
 #ifdef _MSC_VER
@@ -683,8 +831,8 @@ public:
 	//////////////////////////////////////////
 
 private:
-	SMovement* GetNextMovement(uint8_t idx);
-	SMovement* GetPrevMovement(uint8_t idx);
+	SMovement* GetNextMovement(movementidx_t idx);
+	SMovement* GetPrevMovement(movementidx_t idx);
 
 
 protected:
@@ -733,7 +881,7 @@ protected:
 	debugvirtual void InitTimer() { CHAL::InitTimer1OneShot(HandleInterrupt); }
 	debugvirtual void RemoveTimer() { CHAL::RemoveTimer1(); }
 
-	debugvirtual void StartTimer(timer_t timer);
+	debugvirtual void StartTimer(stepper_timer_t timer);
 	debugvirtual void SetIdleTimer();
 
 	static void HandleInterrupt() { GetInstance()->StepRequest(true); }
@@ -66,7 +66,7 @@
 #else
 #define MASH6050S_SDSS_PIN			53
 #endif
-#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER)
+#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER) || defined(__linux__)
 
 #define MASH6050S_INPUTPINMODE		INPUT_PULLUP
 
@@ -22,7 +22,7 @@
 
 ////////////////////////////////////////////////////////
 
-#if defined(__AVR_ATmega2560__) || defined(_MSC_VER) || defined(__SAM3X8E__)
+#if defined(__AVR_ATmega2560__) || defined(_MSC_VER) || defined(__linux__) || defined(__SAM3X8E__)
 
 // only available on Arduino Mega or due
 
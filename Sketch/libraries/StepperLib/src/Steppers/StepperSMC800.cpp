@@ -29,7 +29,7 @@
 #define SMC800_REFININ 40
 #define SMC800_STROBEPIN 41
 
-#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER)
+#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER) || defined(__linux__)
 
 #define SMC800_REFININ 11
 #define SMC800_STROBEPIN 10
@@ -82,7 +82,7 @@ void CStepperSMC800::OutSMC800Cmd(const uint8_t val)
 	PORTD = (PORTD & 3) + (val << 2);
 	PORTB = (PORTB & 0b11111100) + (val >> 6);
 
-#elif defined(_MSC_VER)
+#elif defined(_MSC_VER) || defined(__linux__)
 	val;
 #else
 	ToDo
@@ -114,7 +114,7 @@ void CStepperSMC800::Init()
 	DDRD = (DDRD & 3) + 0b11111100;
 	DDRB = (DDRB & 0b11111100) + 3;
 
-#elif defined(_MSC_VER)
+#elif defined(_MSC_VER) || defined(__linux__)
 
 #else
 	ToDo
@@ -139,7 +139,7 @@ void CStepperSMC800::Remove()
 	DDRD = DDRD & 3;
 	DDRB = DDRB & 0b11111100;
 
-#elif defined(_MSC_VER)
+#elif defined(_MSC_VER) || defined(__linux__)
 
 #else
 	ToDo
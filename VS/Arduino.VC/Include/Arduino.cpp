@@ -50,6 +50,7 @@ uint8_t digitalRead(int16_t pin)
 
 uint8_t digitalReadFromFile(int16_t pin)
 {
+#ifdef _MSC_VER
 	char tmpName[_MAX_PATH];
 	char fileName[_MAX_PATH];
 	::GetTempPathA(_MAX_PATH, tmpName);
@@ -57,6 +58,13 @@ uint8_t digitalReadFromFile(int16_t pin)
 
 	FILE* fin;
 	fopen_s(&fin, fileName, "rt");
+#else
+	const char* tmpName = getenv("TMPDIR");
+	char        fileName[512];
+	snprintf(fileName, sizeof(fileName), "%s/CNCLib_digitalReadFor_%i.txt", tmpName ? tmpName : "/tmp", int(pin));
+
+	FILE* fin = fopen(fileName, "rt");
+#endif
 	if (fin)
 	{
 		char buffer[512];
@@ -16,15 +16,28 @@
 
 #pragma once
 
+#ifdef _MSC_VER
 #pragma comment (lib, "StepperSystem.lib")
+#endif
 
 #include <stdio.h>
 #include <ctype.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
+#ifdef _MSC_VER
 #include <conio.h>
 #include <io.h>
 #include <windows.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#endif
 #include "trace.h"
 #include <assert.h>
 
@@ -73,7 +86,11 @@
 #define strcpy_P(a,b) strcpy(a,b)
 #define strcat_P(a,b) strcat(a,b)
 #define strcmp_P(a,b) strcmp(a,b)
+#ifdef _MSC_VER
 #define strcasecmp_P(a,b) _stricmp(a,b)
+#else
+#define strcasecmp_P(a,b) strcasecmp(a,b)
+#endif
 
 #define memcpy_P(a,b,c) memcpy(a,b,c)
 
@@ -86,6 +103,9 @@ inline uint8_t  eeprom_read_byte(const uint8_t*   __p) { return *__p; }
 
 #define __FlashStringHelper char
 #define F(a) a
+#ifndef _MSC_VER
+#define PSTR(a) ((const char*)(a))
+#endif
 #define PROGMEM 
 inline char         pgm_read_byte(const char* p) { return *p; }
 typedef const char* PGM_P;
@@ -234,6 +254,8 @@ inline uint16_t    pgm_read_word(const void*  p) { return *(uint16_t*)(p); }
 inline uint8_t     pgm_read_byte(const void*  p) { return *(uint8_t*)(p); }
 inline const void* pgm_read_ptr(const void*   p) { return *((void **)(p)); }
 
+#ifdef _MSC_VER
+
 //extern unsigned int GetTickCount();
 #pragma warning(suppress: 28159)
 inline uint32_t millis() { return GetTickCount(); }
@@ -241,6 +263,50 @@ inline uint32_t millis() { return GetTickCount(); }
 //extern void Sleep(unsigned int ms);
 inline void delay(uint32_t ms) { Sleep(ms); }
 
+#else
+
+inline uint32_t millis()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint32_t(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+inline void delay(uint32_t ms) { usleep(ms * 1000); }
+
+// msvc runtime functions used by Stream
+
+inline int  _isatty(int fd) { return isatty(fd); }
+inline int  _getwch() { return getchar(); }
+inline int  _fgetchar() { return getchar(); }
+inline int  _putch(int ch) { return putchar(ch); }
+
+inline int _kbhit()
+{
+	pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+	return poll(&pfd, 1, 0) > 0;
+}
+
+inline char* ltoa(long value, char* str, int radix)
+{
+	if (radix == 16)
+	{
+		sprintf(str, "%lx", value);
+	}
+	else
+	{
+		sprintf(str, "%ld", value);
+	}
+	return str;
+}
+
+inline char* itoa(int value, char* str, int radix) { return ltoa(value, str, radix); }
+
+template <typename T1, typename T2> inline T1 min(T1 a, T2 b) { return a <= T1(b) ? a : T1(b); }
+template <typename T1, typename T2> inline T1 max(T1 a, T2 b) { return a >= T1(b) ? a : T1(b); }
+
+#endif
+
 #define STDIO 0
 #define HEX 16
 
@@ -271,6 +337,10 @@ public:
 
 	void print(const char* s) { printf("%s", s); };
 	void print(float       f) { printf("%f", f); };
+#ifndef _MSC_VER
+	void print(long          l) { printf("%li", l); };
+	void print(unsigned long ul) { printf("%lu", ul); };
+#endif
 
 	void println() { printf("\n"); };
 	void println(unsigned int ui) { printf("%u\n", ui); };
@@ -288,6 +358,10 @@ public:
 	};
 	void println(const char* s) { printf("%s\n", s); };
 	void println(float       f) { printf("%f\n", f); };
+#ifndef _MSC_VER
+	void println(long          l) { printf("%li\n", l); };
+	void println(unsigned long ul) { printf("%lu\n", ul); };
+#endif
 
 	void begin(int) { };
 
@@ -355,4 +429,6 @@ class CSerial : public HardwareSerial {};
 
 extern CSerial Serial;
 
+#ifdef _MSC_VER
 #define __attribute__
+#endif
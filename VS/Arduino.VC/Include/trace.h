@@ -16,12 +16,25 @@
 
 #pragma once
 
+#ifdef _MSC_VER
 #include <crtdbg.h>
+#endif
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
-#ifdef _DEBUG
+#if defined(_DEBUG) && !defined(_MSC_VER)
+
+inline void Trace(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+#define TraceEx Trace
+
+#elif defined(_DEBUG)
 #define TRACEMAXSTRING 1024
 
 inline void Trace(const char* format, ...)
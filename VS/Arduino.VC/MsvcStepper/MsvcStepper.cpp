@@ -31,6 +31,7 @@ CMsvcStepper::CMsvcStepper()
 	DelayOptimization = true;;
 	SplitFile         = true;
 	UseSpeedSign      = false;
+	StreamTrace       = false;
 	_TimerEvents      = nullptr;
 	CacheSize         = _STORETIMEVALUES;
 	_oldCacheSize     = -1;
@@ -138,7 +139,7 @@ bool CMsvcStepper::MoveReference(axis_t axis, uint8_t referenceId, bool toMin, s
 
 ////////////////////////////////////////////////////////////
 
-void CMsvcStepper::StartTimer(timer_t timerB)
+void CMsvcStepper::StartTimer(stepper_timer_t timerB)
 {
 	timerB += TIMEROVERHEAD;
 	_TimerEvents[_eventIdx].TimerValues = timerB;
@@ -164,8 +165,11 @@ void CMsvcStepper::StepRequest(bool isr)
 
 void CMsvcStepper::StepBegin(const SStepBuffer* stepBuffer)
 {
-	_TimerEvents[_eventIdx].Steps = stepBuffer->_steps;
-	_TimerEvents[_eventIdx].Count = stepBuffer->_count;
+	_TimerEvents[_eventIdx].Steps        = stepBuffer->_steps;
+	_TimerEvents[_eventIdx].Count        = stepBuffer->_count;
+	_TimerEvents[_eventIdx].DirStepCount = stepBuffer->DirStepCount;
+	_TimerEvents[_eventIdx].State        = stepBuffer->_state;
+	_TimerEvents[_eventIdx].N            = stepBuffer->_n;
 
 	int multiplier = stepBuffer->DirStepCount;
 
@@ -195,8 +199,18 @@ void CMsvcStepper::Step(const uint8_t steps[NUM_AXIS], axisArray_t directionUp,
 	{
 		_TimerEvents[_eventIdx].Axis[axis].MoveAxis = (directionUp & ((1 << axis))) != 0 ? steps[axis] : -steps[axis];
 	}
+	_TimerEvents[_eventIdx].SpeedLevel = _pod._speedLevel;
 
 	_TotalSteps++;
+
+	if (_trace.IsOpen())
+	{
+		// stream => reuse the first event
+		_trace.Add(_TimerEvents[_eventIdx]);
+		memset(&_TimerEvents[_eventIdx], 0, sizeof(STimerEvent));
+		return;
+	}
+
 	_eventIdx++;
 
 	if (_eventIdx < CacheSize) { }
@@ -240,29 +254,25 @@ void CMsvcStepper::InitTest(const char* fileName)
 	ContinueMove();
 
 	_TotalSteps = 1;
-	_exportIdx  = 1;
 
-	for (axis_t x = 0; x < NUM_AXIS_MVC; x++)
+	for (axis_t x = 0; x < NUM_AXIS; x++)
 	{
-		if (x < NUM_AXIS)
-		{
-			SetJerkSpeed(x, 500);
-			SetPosition(x, 0);
-		}
-		_sumTime[x]  = 0;
-		_count[x]    = 0;
-		_sumTime[x]  = 0;
-		_total[x]    = 0;
-		_speed[x][0] = 0;
+		SetJerkSpeed(x, 500);
+		SetPosition(x, 0);
 	}
-	_totalTime = 0;
-	_lastTimer = 0;
+	_csv.Init();
 
 	MSCInfo = "";
 
 	SetWaitConditional(false);
 
 	InitCache();
+
+	_trace.Close();
+	if (StreamTrace && fileName != nullptr)
+	{
+		_trace.Open(fileName);
+	}
 }
 
 ////////////////////////////////////////////////////////////
@@ -274,6 +284,12 @@ void CMsvcStepper::EndTest(const char* fileName)
 	OptimizeMovementQueue(true);
 	WaitBusy();
 
+	if (_trace.IsOpen())
+	{
+		_trace.Close();
+		return;
+	}
+
 	WriteTestResults(_fileName);
 }
 
@@ -303,79 +319,7 @@ void CMsvcStepper::WriteTestResults(const char* fileName)
 
 	FILE* f = fopen(fname, append ? "at" : "wt");
 
-	int timerconstant = 65536 * 32;
-
-	for (int i = 0; i < _eventIdx; i++)
-	{
-		int outtotaltime = int(_totalTime / 1000);
-		int timer        = _TimerEvents[i].TimerValues;
-		if (timer == 0)
-		{
-			timer = _lastTimer;
-		}
-		else
-		{
-			int stepidx;
-			for (stepidx = 1; i + stepidx < _eventIdx; stepidx++)
-			{
-				if (_TimerEvents[i + stepidx].TimerValues)
-				{
-					break;
-				}
-			}
-			_lastTimer = timer / stepidx;
-			timer      = _lastTimer;
-		}
-
-		for (int x = 0; x < NUM_AXIS; x++)
-		{
-			int outspeed = 10 * (timerconstant / timer) * _TimerEvents[i].Axis[x].Multiplier;
-			_total[x] += _TimerEvents[i].Axis[x].MoveAxis;
-			_sumTime[x] += outspeed;
-			_count[x] += 1;
-			if (_TimerEvents[i].Axis[x].MoveAxis != 0)
-			{
-				//				speed[j] = sumtime[j] / count[j];
-				//				sprintf(speed[j],"%i",outspeed / count[j]);
-				int speed = int(__int64(outspeed) * __int64(_TimerEvents[i].Axis[x].Distance) / __int64(_TimerEvents[i].Steps));
-				if (UseSpeedSign && _TimerEvents[i].Axis[x].MoveAxis < 0)
-				{
-					speed = -speed;
-				}
-				sprintf(_speed[x], "%i", speed);
-				_count[x]   = 0;
-				_sumTime[x] = 0;
-			}
-			else
-			{
-				_speed[x][0] = 0;
-			}
-		}
+	_csv.Write(f, _TimerEvents, _eventIdx, UseSpeedSign);
 
-		int sysspeed = 10 * (timerconstant / timer) * _TimerEvents[i].Count;
-
-		fprintf(f, "%i;%i;%i;%i;%s;%s;%s;%s;%s;%i;%i;%i;%i;%i;%i;%i;%i;%i;%i;%s\n",
-		        _exportIdx++,
-		        _TimerEvents[i].TimerValues,
-		        outtotaltime,
-		        sysspeed,
-		        _speed[0],
-		        _speed[1],
-		        _speed[2],
-		        _speed[3],
-		        _speed[4],
-		        _TimerEvents[i].Axis[0].MoveAxis,
-		        _TimerEvents[i].Axis[1].MoveAxis,
-		        _TimerEvents[i].Axis[2].MoveAxis,
-		        _TimerEvents[i].Axis[3].MoveAxis,
-		        _TimerEvents[i].Axis[4].MoveAxis,
-		        _total[0],
-		        _total[1],
-		        _total[2],
-		        _total[3],
-		        _total[4],
-		        _TimerEvents[i].MSCInfo);
-		_totalTime += timer;
-	}
 	fclose(f);
 }
@@ -26,8 +26,9 @@
 #include "..\..\..\Sketch\libraries\CNCLib\src\GCodeParserBase.h"
 #include "..\..\..\Sketch\libraries\CNCLib\src\DecimalAsInt.h"
 
+#include "StepTrace.h"
+
 #define _STORETIMEVALUES	100000
-#define NUM_AXIS_MVC		5
 
 class CMsvcStepper : public CStepper
 {
@@ -85,7 +86,7 @@ private:
 
 public:
 
-	virtual void StartTimer(timer_t timerB) override; // 0 => set idle timer (==Timer not running)
+	virtual void StartTimer(stepper_timer_t timerB) override; // 0 => set idle timer (==Timer not running)
 	virtual void SetIdleTimer() override;             // set idle Timer
 
 	virtual void OptimizeMovementQueue(bool force) override;
@@ -99,8 +100,17 @@ public:
 	bool DelayOptimization;
 	bool SplitFile;
 	bool UseSpeedSign;
+	bool StreamTrace;		// write binary trace (see CStepTraceWriter) to the file of InitTest, no limit of events
 	int  CacheSize;
 
+	int                GetTimerEventCount() const { return _eventIdx; }		// events of the last test (cache)
+	const STimerEvent& GetTimerEvent(int idx) const { return _TimerEvents[idx]; }
+
+	static bool ConvertTraceToCsv(const char* traceFileName, const char* csvFileName, bool useSpeedSign = false)
+	{
+		return CStepTraceWriter::ConvertToCsv(traceFileName, csvFileName, useSpeedSign);
+	}
+
 private:
 
 	void WriteTestResults(const char* fileName);
@@ -108,22 +118,6 @@ private:
 	const char* _fileName;
 	int         _flushCount;
 
-	struct STimerEvent
-	{
-		timer_t TimerValues;
-		int     Steps;
-		int     Count;
-
-		struct SAxis
-		{
-			int Multiplier;
-			int MoveAxis;
-			int Distance;
-		}       Axis[NUM_AXIS_MVC];
-
-		char MSCInfo[MOVEMENTINFOSIZE];
-	};
-
 	int _TotalSteps;
 
 	void InitCache()
@@ -132,18 +126,14 @@ private:
 		memset(_TimerEvents, 0, sizeof(STimerEvent) * CacheSize);
 	}
 
-	int          _exportIdx;
 	int          _eventIdx;
 	STimerEvent* _TimerEvents;
 	int          _oldCacheSize;
 
-	int     _sumTime[NUM_AXIS_MVC];
-	int     _count[NUM_AXIS_MVC];
-	int     _total[NUM_AXIS_MVC];
-	char    _speed[NUM_AXIS_MVC][20];
-	int64_t _totalTime;
-	int     _lastTimer;
-	int     _refMoveStart;
+	CStepTraceCsv    _csv;
+	CStepTraceWriter _trace;
+
+	int _refMoveStart;
 
 	bool    _isReferenceMove;
 	uint8_t _isReferenceId;
@@ -0,0 +1,398 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "StepTrace.h"
+
+////////////////////////////////////////////////////////////
+
+#define STEPTRACEVERSION		1
+#define STEPTRACECSVEVENTS		100000		// events converted at once (same as _STORETIMEVALUES of CMsvcStepper)
+
+static const char _stepTraceMagic[4] = { 'S', 'T', 'R', 'C' };
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceCsv::Init()
+{
+	_exportIdx = 1;
+
+	for (int x = 0; x < NUM_AXIS_MVC; x++)
+	{
+		_sumTime[x]  = 0;
+		_count[x]    = 0;
+		_total[x]    = 0;
+		_speed[x][0] = 0;
+	}
+	_totalTime = 0;
+	_lastTimer = 0;
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceCsv::Write(FILE* f, const STimerEvent* events, int count, bool useSpeedSign)
+{
+	int timerconstant = 65536 * 32;
+
+	for (int i = 0; i < count; i++)
+	{
+		int outtotaltime = int(_totalTime / 1000);
+		int timer        = events[i].TimerValues;
+		if (timer == 0)
+		{
+			timer = _lastTimer;
+		}
+		else
+		{
+			int stepidx;
+			for (stepidx = 1; i + stepidx < count; stepidx++)
+			{
+				if (events[i + stepidx].TimerValues)
+				{
+					break;
+				}
+			}
+			_lastTimer = timer / stepidx;
+			timer      = _lastTimer;
+		}
+
+		for (int x = 0; x < NUM_AXIS; x++)
+		{
+			int outspeed = 10 * (timerconstant / timer) * events[i].Axis[x].Multiplier;
+			_total[x] += events[i].Axis[x].MoveAxis;
+			_sumTime[x] += outspeed;
+			_count[x] += 1;
+			if (events[i].Axis[x].MoveAxis != 0)
+			{
+				int speed = int(int64_t(outspeed) * int64_t(events[i].Axis[x].Distance) / int64_t(events[i].Steps));
+				if (useSpeedSign && events[i].Axis[x].MoveAxis < 0)
+				{
+					speed = -speed;
+				}
+				sprintf(_speed[x], "%i", speed);
+				_count[x]   = 0;
+				_sumTime[x] = 0;
+			}
+			else
+			{
+				_speed[x][0] = 0;
+			}
+		}
+
+		int sysspeed = 10 * (timerconstant / timer) * events[i].Count;
+
+		fprintf(f, "%i;%i;%i;%i;%s;%s;%s;%s;%s;%i;%i;%i;%i;%i;%i;%i;%i;%i;%i;%s\n",
+		        _exportIdx++,
+		        int(events[i].TimerValues),
+		        outtotaltime,
+		        sysspeed,
+		        _speed[0],
+		        _speed[1],
+		        _speed[2],
+		        _speed[3],
+		        _speed[4],
+		        events[i].Axis[0].MoveAxis,
+		        events[i].Axis[1].MoveAxis,
+		        events[i].Axis[2].MoveAxis,
+		        events[i].Axis[3].MoveAxis,
+		        events[i].Axis[4].MoveAxis,
+		        _total[0],
+		        _total[1],
+		        _total[2],
+		        _total[3],
+		        _total[4],
+		        events[i].MSCInfo);
+		_totalTime += timer;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+bool CStepTraceWriter::Open(const char* fileName)
+{
+	Close();
+
+	_file = fopen(fileName, "wb");
+	if (_file == nullptr)
+	{
+		return false;
+	}
+
+	SStepTraceHeader header;
+	memcpy(header.Magic, _stepTraceMagic, sizeof(header.Magic));
+	header.Version    = STEPTRACEVERSION;
+	header.RecordSize = sizeof(SStepTraceRecord);
+	fwrite(&header, sizeof(header), 1, _file);
+
+	_buffer[0] = new SStepTraceRecord[BufferRecords];
+	_buffer[1] = new SStepTraceRecord[BufferRecords];
+
+	_fillIdx     = 0;
+	_fillCount   = 0;
+	_writeCount  = 0;
+	_stop        = false;
+	_recordCount = 0;
+	_lastInfo[0] = 0;
+
+	_thread = std::thread(&CStepTraceWriter::WriteThread, this);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceWriter::Close()
+{
+	if (_file == nullptr)
+	{
+		return;
+	}
+
+	if (_fillCount > 0)
+	{
+		SwapBuffer();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	_thread.join();
+
+	fclose(_file);
+	_file = nullptr;
+
+	delete[] _buffer[0];
+	delete[] _buffer[1];
+	_buffer[0] = _buffer[1] = nullptr;
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceWriter::Add(const STimerEvent& ev)
+{
+	if (strcmp(_lastInfo, ev.MSCInfo) != 0)
+	{
+		strcpy(_lastInfo, ev.MSCInfo);
+
+		const char* text = ev.MSCInfo;
+		size_t      len  = strlen(text) + 1;	// incl. '\0'
+
+		while (len > 0)
+		{
+			SStepTraceInfoRecord info;
+			size_t               chunk = len < sizeof(info.Text) ? len : sizeof(info.Text);
+
+			memset(&info, 0, sizeof(info));
+			info.Kind = SStepTraceRecord::InfoRecord;
+			memcpy(info.Text, text, chunk);
+			AddRecord(&info);
+
+			text += chunk;
+			len -= chunk;
+		}
+	}
+
+	SStepTraceRecord record;
+	memset(&record, 0, sizeof(record));
+
+	record.Kind         = SStepTraceRecord::StepRecord;
+	record.Count        = uint8_t(ev.Count);
+	record.State        = uint8_t(ev.State);
+	record.Timer        = uint32_t(ev.TimerValues);
+	record.DirStepCount = uint32_t(ev.DirStepCount);
+	record.Steps        = uint32_t(ev.Steps);
+	record.N            = uint32_t(ev.N);
+
+	for (int x = 0; x < NUM_AXIS_MVC; x++)
+	{
+		record.MoveAxis[x] = int8_t(ev.Axis[x].MoveAxis);
+		record.Distance[x] = uint32_t(ev.Axis[x].Distance);
+	}
+
+	AddRecord(&record);
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceWriter::AddRecord(const void* record)
+{
+	memcpy(&_buffer[_fillIdx][_fillCount++], record, sizeof(SStepTraceRecord));
+	_recordCount++;
+
+	if (_fillCount >= BufferRecords)
+	{
+		SwapBuffer();
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceWriter::SwapBuffer()
+{
+	{
+		// wait until the previous buffer is written
+		std::unique_lock<std::mutex> lock(_mutex);
+		_cv.wait(lock, [this] { return _writeCount == 0; });
+
+		_writeIdx   = _fillIdx;
+		_writeCount = _fillCount;
+	}
+	_cv.notify_all();
+
+	_fillIdx   = 1 - _fillIdx;
+	_fillCount = 0;
+}
+
+////////////////////////////////////////////////////////////
+
+void CStepTraceWriter::WriteThread()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (true)
+	{
+		_cv.wait(lock, [this] { return _writeCount != 0 || _stop; });
+
+		if (_writeCount != 0)
+		{
+			int writeIdx   = _writeIdx;
+			int writeCount = _writeCount;
+
+			lock.unlock();
+			fwrite(_buffer[writeIdx], sizeof(SStepTraceRecord), writeCount, _file);
+			lock.lock();
+
+			_writeCount = 0;
+			_cv.notify_all();
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+bool CStepTraceWriter::ConvertToCsv(const char* traceFileName, const char* csvFileName, bool useSpeedSign)
+{
+	FILE* fin = fopen(traceFileName, "rb");
+	if (fin == nullptr)
+	{
+		return false;
+	}
+
+	SStepTraceHeader header;
+	if (fread(&header, sizeof(header), 1, fin) != 1 ||
+	    memcmp(header.Magic, _stepTraceMagic, sizeof(header.Magic)) != 0 ||
+	    header.Version != STEPTRACEVERSION ||
+	    header.RecordSize != sizeof(SStepTraceRecord))
+	{
+		fclose(fin);
+		return false;
+	}
+
+	FILE* fout = fopen(csvFileName, "wt");
+	if (fout == nullptr)
+	{
+		fclose(fin);
+		return false;
+	}
+
+	CStepTraceCsv csv;
+	csv.Init();
+
+	STimerEvent* events = new STimerEvent[STEPTRACECSVEVENTS];
+	int          count  = 0;
+
+	char   info[MOVEMENTINFOSIZE] = { 0 };
+	size_t infoLen                = 0;
+	bool   infoComplete           = true;
+
+	SStepTraceRecord record;
+
+	while (fread(&record, sizeof(record), 1, fin) == 1)
+	{
+		if (record.Kind == SStepTraceRecord::InfoRecord)
+		{
+			auto& infoRecord = reinterpret_cast<const SStepTraceInfoRecord&>(record);
+
+			if (infoComplete)
+			{
+				infoLen = 0;
+			}
+
+			for (size_t i = 0; i < sizeof(infoRecord.Text); i++)
+			{
+				if (infoLen < sizeof(info))
+				{
+					info[infoLen++] = infoRecord.Text[i];
+				}
+				if (infoRecord.Text[i] == 0)
+				{
+					break;
+				}
+			}
+			info[sizeof(info) - 1] = 0;
+			infoComplete           = memchr(infoRecord.Text, 0, sizeof(infoRecord.Text)) != nullptr;
+			continue;
+		}
+
+		STimerEvent& ev = events[count++];
+		memset(&ev, 0, sizeof(ev));
+
+		ev.TimerValues  = stepper_timer_t(record.Timer);
+		ev.Steps        = int(record.Steps);
+		ev.Count        = record.Count;
+		ev.DirStepCount = DirCount_t(record.DirStepCount);
+		ev.State        = record.State;
+		ev.N            = int(record.N);
+
+		uint32_t multiplier = record.DirStepCount;
+
+		for (int x = 0; x < NUM_AXIS_MVC; x++)
+		{
+			ev.Axis[x].MoveAxis = record.MoveAxis[x];
+			ev.Axis[x].Distance = int(record.Distance[x]);
+			if (x < NUM_AXIS)
+			{
+				ev.Axis[x].Multiplier = multiplier % 8;
+				multiplier            = multiplier / 16;
+			}
+		}
+		strcpy(ev.MSCInfo, info);
+
+		if (count >= STEPTRACECSVEVENTS)
+		{
+			csv.Write(fout, events, count, useSpeedSign);
+			count = 0;
+		}
+	}
+
+	csv.Write(fout, events, count, useSpeedSign);
+
+	delete[] events;
+	fclose(fout);
+	fclose(fin);
+
+	return true;
+}
@@ -0,0 +1,160 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "..\..\..\Sketch\libraries\StepperLib\src\StepperLib.h"
+
+#define NUM_AXIS_MVC		5
+
+////////////////////////////////////////////////////////
+// one step (ISR) of the CMsvcStepper
+
+struct STimerEvent
+{
+	stepper_timer_t TimerValues;
+	int        Steps;
+	int        Count;
+	DirCount_t DirStepCount;
+	int        State;
+	int        N;
+	uint8_t    SpeedLevel;		// _speedLevel of the step (only with SetSpeedEvent), not in the trace
+
+	struct SAxis
+	{
+		int Multiplier;
+		int MoveAxis;
+		int Distance;
+	}          Axis[NUM_AXIS_MVC];
+
+	char MSCInfo[MOVEMENTINFOSIZE];
+};
+
+////////////////////////////////////////////////////////
+// write STimerEvent as csv (format of VS/Tools/SpeedChart)
+
+class CStepTraceCsv
+{
+public:
+
+	void Init();
+	void Write(FILE* f, const STimerEvent* events, int count, bool useSpeedSign);
+
+private:
+
+	int     _exportIdx;
+	int     _sumTime[NUM_AXIS_MVC];
+	int     _count[NUM_AXIS_MVC];
+	int     _total[NUM_AXIS_MVC];
+	char    _speed[NUM_AXIS_MVC][20];
+	int64_t _totalTime;
+	int     _lastTimer;
+};
+
+////////////////////////////////////////////////////////
+// binary trace file: header followed by fixed size records
+// the MSCInfo is written (as InfoRecord) only if it changes, a text longer than one record continues in the next record (terminated by '\0')
+
+struct SStepTraceHeader
+{
+	char     Magic[4];		// "STRC"
+	uint16_t Version;
+	uint16_t RecordSize;
+};
+
+struct SStepTraceRecord
+{
+	enum EKind : uint8_t
+	{
+		StepRecord = 1,
+		InfoRecord = 2
+	};
+
+	uint8_t  Kind;
+	uint8_t  Count;
+	uint8_t  State;						// SMovement::EMovementState
+	int8_t   MoveAxis[NUM_AXIS_MVC];	// steps of this ISR, <0 => down
+	uint32_t Timer;
+	uint32_t DirStepCount;
+	uint32_t Steps;
+	uint32_t N;
+	uint32_t Distance[NUM_AXIS_MVC];
+};
+
+struct SStepTraceInfoRecord
+{
+	uint8_t Kind;
+	char    Text[sizeof(SStepTraceRecord) - 1];
+};
+
+static_assert(sizeof(SStepTraceRecord) == sizeof(SStepTraceInfoRecord), "info record must have the same size as a step record");
+
+////////////////////////////////////////////////////////
+// stream the trace to a file with a bounded double buffer:
+// Add fills one buffer while a background thread writes the other, Add waits if both buffers are full
+
+class CStepTraceWriter
+{
+public:
+
+	CStepTraceWriter()  = default;
+	~CStepTraceWriter() { Close(); }
+
+	bool Open(const char* fileName);
+	void Close();
+
+	bool IsOpen() const { return _file != nullptr; }
+
+	void Add(const STimerEvent& ev);
+
+	uint64_t GetRecordCount() const { return _recordCount; }
+
+	static bool ConvertToCsv(const char* traceFileName, const char* csvFileName, bool useSpeedSign);
+
+private:
+
+	enum
+	{
+		BufferRecords = 8192
+	};
+
+	void AddRecord(const void* record);
+	void SwapBuffer();
+	void WriteThread();
+
+	FILE*             _file      = nullptr;
+	SStepTraceRecord* _buffer[2] = { nullptr, nullptr };
+
+	int _fillIdx    = 0;	// buffer filled by Add
+	int _fillCount  = 0;
+	int _writeIdx   = 0;	// buffer written by thread
+	int _writeCount = 0;	// 0 => thread idle
+
+	bool                    _stop = false;
+	std::mutex              _mutex;
+	std::condition_variable _cv;
+	std::thread             _thread;
+
+	uint64_t _recordCount = 0;
+	char     _lastInfo[MOVEMENTINFOSIZE];
+};
@@ -0,0 +1,68 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+////////////////////////////////////////////////////////////
+// StepTraceToCsv: convert a binary step trace (CMsvcStepper::StreamTrace) to the csv of VS/Tools/SpeedChart
+//
+// usage: StepTraceToCsv [-s] trace.bin file.csv
+//   -s   speed with sign (see CMsvcStepper::UseSpeedSign)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "..\MsvcStepper\StepTrace.h"
+
+////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	const char* traceFileName = nullptr;
+	const char* csvFileName   = nullptr;
+	bool        useSpeedSign  = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-s") == 0)
+		{
+			useSpeedSign = true;
+		}
+		else if (traceFileName == nullptr)
+		{
+			traceFileName = argv[i];
+		}
+		else
+		{
+			csvFileName = argv[i];
+		}
+	}
+
+	if (traceFileName == nullptr || csvFileName == nullptr)
+	{
+		fprintf(stderr, "usage: StepTraceToCsv [-s] trace.bin file.csv\n");
+		return 2;
+	}
+
+	if (!CStepTraceWriter::ConvertToCsv(traceFileName, csvFileName, useSpeedSign))
+	{
+		fprintf(stderr, "cannot convert %s to %s\n", traceFileName, csvFileName);
+		return 1;
+	}
+
+	return 0;
+}
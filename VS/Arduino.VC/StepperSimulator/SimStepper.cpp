@@ -0,0 +1,136 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+
+#include <Arduino.h>
+#include "SimStepper.h"
+
+////////////////////////////////////////////////////////////
+
+static const char _axisName[] = "XYZABCUVW";
+
+////////////////////////////////////////////////////////////
+
+CSimStepper::CSimStepper()
+{
+	for (uint8_t& level : _level)
+	{
+		level = 0;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::SetTimelineFile(FILE* timeline)
+{
+	_timeline = timeline;
+
+	if (_timeline)
+	{
+		fprintf(_timeline, "Clock;Timer");
+		for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+		{
+			fprintf(_timeline, ";Step%c", _axisName[axis]);
+		}
+		for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+		{
+			fprintf(_timeline, ";Pos%c", _axisName[axis]);
+		}
+		fprintf(_timeline, "\n");
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::OnWait(EnumAsByte(EWaitType) wait)
+{
+	super::OnWait(wait);
+
+	// nothing will change if the timer is not running
+	if (IsBusy())
+	{
+		// call the next timer ISR (stepper or CControl::TimerInterrupt) => advance the virtual clock
+		hostclock_t::time_point start = hostclock_t::now();
+
+		CHAL::DispatchTimer();
+
+		_isrTime += hostclock_t::now() - start;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+uint8_t CSimStepper::GetReferenceValue(uint8_t referenceId)
+{
+	// never hit a reference
+	return _pod._referenceHitValue[referenceId] == LOW ? HIGH : LOW;
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::StartTimer(stepper_timer_t timer)
+{
+	_timerValue = timer;
+	_isrCount++;
+	super::StartTimer(timer);
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::SetIdleTimer()
+{
+	_timerValue = IDLETIMER1VALUE;
+	_isrCount++;
+	super::SetIdleTimer();
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::OptimizeMovementQueue(bool force)
+{
+	hostclock_t::time_point start = hostclock_t::now();
+
+	super::OptimizeMovementQueue(force);
+
+	_plannerTime += hostclock_t::now() - start;
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimStepper::Step(const uint8_t steps[NUM_AXIS], axisArray_t directionUp, bool /* isSameDirection */)
+{
+	for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+	{
+		_stepCount += steps[axis];
+	}
+
+	if (_timeline)
+	{
+		fprintf(_timeline, "%llu;%u", static_cast<unsigned long long>(GetClock()), static_cast<unsigned int>(_timerValue));
+		for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+		{
+			fprintf(_timeline, ";%i", (directionUp & (1 << axis)) != 0 ? int(steps[axis]) : -int(steps[axis]));
+		}
+		for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+		{
+			fprintf(_timeline, ";%u", static_cast<unsigned int>(GetCurrentPosition(axis)));
+		}
+		fprintf(_timeline, "\n");
+	}
+}
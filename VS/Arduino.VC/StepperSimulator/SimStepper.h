@@ -0,0 +1,81 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+
+#include <StepperLib.h>
+
+////////////////////////////////////////////////////////
+// Stepper without hardware and real time (POSIX HAL, see HAL_Posix.h):
+// the timer ISRs are called by CHAL::DispatchTimer in OnWait, the virtual clock of the HAL (TIMER1FREQUENCE ticks) is advanced to the due time of the timer
+// => the result (time, steps, timeline) does not depend on the host (deterministic)
+// the host CPU time of the planner and ISR is measured, too
+
+class CSimStepper : public CStepper
+{
+private:
+
+	typedef CStepper super;
+
+public:
+
+	CSimStepper();
+
+	virtual void OnWait(EnumAsByte(EWaitType) wait) override;
+
+	virtual uint8_t GetReferenceValue(uint8_t referenceId) override;
+	virtual bool    IsAnyReference() override { return false; }
+
+	void SetTimelineFile(FILE* timeline);	// write each step (ISR) as csv line, nullptr => off
+
+	uint64_t GetClock() const { return CHAL::GetTimerClock(); }							// virtual clock in TIMER1FREQUENCE ticks
+	double   GetMachiningTime() const { return double(GetClock()) / TIMER1FREQUENCE; }	// sec
+	uint64_t GetStepCount() const { return _stepCount; }						// sum of steps of all axes
+	uint64_t GetISRCount() const { return _isrCount; }
+	double   GetPlannerCPUTime() const { return _plannerTime.count(); }			// sec, host time in OptimizeMovementQueue
+	double   GetISRCPUTime() const { return _isrTime.count(); }					// sec, host time in timer ISRs (incl. FillStepBuffer and CControl::TimerInterrupt)
+
+protected:
+
+	virtual void Step(const uint8_t steps[NUM_AXIS], axisArray_t directionUp, bool isSameDirection) override;
+
+	virtual void    SetEnable(axis_t axis, uint8_t level, bool /* force */) override { _level[axis] = level; }
+	virtual uint8_t GetEnable(axis_t axis) override { return _level[axis]; }
+
+	virtual void StartTimer(stepper_timer_t timer) override;
+	virtual void SetIdleTimer() override;
+
+	virtual void OptimizeMovementQueue(bool force) override;
+
+private:
+
+	typedef std::chrono::steady_clock     hostclock_t;
+	typedef std::chrono::duration<double> seconds_t;
+
+	uint8_t _level[NUM_AXIS];
+
+	FILE* _timeline = nullptr;
+
+	stepper_timer_t _timerValue = 0;	// timer started by the (last) ISR => time until next ISR
+	uint64_t _stepCount  = 0;
+	uint64_t _isrCount   = 0;	// started timer (timer1) => stepper ISR
+
+	seconds_t _plannerTime = seconds_t(0);
+	seconds_t _isrTime     = seconds_t(0);
+};
@@ -0,0 +1,273 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+////////////////////////////////////////////////////////////
+// StepperSimulator: run a gcode file through CControl/CGCodeParser and CStepper on a virtual clock
+// => reproducible benchmark (time, steps/sec, ISR) for planner and parser changes
+//
+// usage: StepperSimulator [options] file.nc
+//   -t file.csv   write timeline (one line per step ISR)
+//   -o            print parser output (ok, error, ...)
+//   -s steps/mm   default 3200
+//   -r steprate   max steprate (steps/sec), default 27000
+//   -a acc        default 350
+//   -d dec        default 400
+//   -j jerk       default 1000
+//   -k rampjerk   jerk of acc/dec ramp (steps/sec^3), S-curve (STEPPER_SCURVE only), default 0 => trapezoid
+//
+// msvc:  StepperSimulator.vcxproj
+// linux: make (see Makefile)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include <Arduino.h>
+
+#include <CNCLib.h>
+#include <Control.h>
+#include <MotionControl.h>
+#include <GCodeParser.h>
+
+#include "SimStepper.h"
+
+////////////////////////////////////////////////////////////
+
+class CSimControl : public CControl
+{
+private:
+
+	typedef CControl super;
+
+public:
+
+	float      StepsPerMm    = 3200.0;
+	steprate_t MaxStepRate   = 27000;
+	steprate_t Acc           = 350;
+	steprate_t Dec           = 400;
+	steprate_t JerkSpeed     = 1000;
+	uint32_t   RampJerk      = 0;
+	mm1000_t   MachineSize   = 1000000;
+
+	bool Simulate(FILE* gcode, Stream* output);
+
+	uint32_t GetLineCount() const { return _lineCount; }
+	uint32_t GetErrorCount() const { return _errorCount; }
+
+protected:
+
+	virtual void Init() override;
+	virtual void Initialized() override;
+
+	virtual bool IsKill() override { return false; }
+
+private:
+
+	uint32_t _lineCount  = 0;
+	uint32_t _errorCount = 0;
+};
+
+////////////////////////////////////////////////////////////
+
+CSerial               Serial;
+CSimStepper           Stepper;
+CSimControl           Control;
+CMotionControlDefault MotionControl;
+#if defined (USEHARDWARESERIAL)
+HardwareSerial&       StepperSerial = Serial;
+#endif
+
+////////////////////////////////////////////////////////////
+
+void CSimControl::Init()
+{
+	super::Init();
+
+	CMotionControlBase::GetInstance()->InitConversionBestStepsPer(StepsPerMm / 1000.0f);
+
+	CStepper::GetInstance()->SetDefaultMaxSpeed(MaxStepRate, Acc, Dec, JerkSpeed);
+
+	for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+	{
+		CStepper::GetInstance()->SetLimitMax(axis, CMotionControlBase::GetInstance()->ToMachine(axis, MachineSize));
+#ifdef STEPPER_SCURVE
+		CStepper::GetInstance()->SetRampJerk(axis, RampJerk);
+#endif
+	}
+
+	CGCodeParserDefault::InitAndSetFeedRate(-STEPRATETOFEEDRATE(MaxStepRate), STEPRATETOFEEDRATE(MaxStepRate) / 2, STEPRATETOFEEDRATE(MaxStepRate));
+}
+
+////////////////////////////////////////////////////////////
+
+void CSimControl::Initialized()
+{
+	// no reference move
+	CMotionControlBase::GetInstance()->SetPositionFromMachine();
+}
+
+////////////////////////////////////////////////////////////
+
+bool CSimControl::Simulate(FILE* gcode, Stream* output)
+{
+	Init();
+	Initialized();
+
+	char line[SERIALBUFFERSIZE];
+
+	while (fgets(line, sizeof(line), gcode) != nullptr)
+	{
+		_lineCount++;
+
+		char* eol = strpbrk(line, "\r\n");
+		if (eol != nullptr)
+		{
+			*eol = 0;
+		}
+
+		if (!PostCommand(line, output))
+		{
+			_errorCount++;
+			fprintf(stderr, "error in line %u: %s\n", static_cast<unsigned int>(_lineCount), line);
+		}
+
+		if (IsKilled())
+		{
+			fprintf(stderr, "killed in line %u\n", static_cast<unsigned int>(_lineCount));
+			return false;
+		}
+	}
+
+	CMotionControlBase::GetInstance()->FlushArc();
+	CStepper::GetInstance()->WaitBusy();
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+static int Usage()
+{
+	fprintf(stderr, "usage: StepperSimulator [-t timeline.csv] [-o] [-s steps/mm] [-r steprate] [-a acc] [-d dec] [-j jerk] [-k rampjerk] file.nc\n");
+	return 2;
+}
+
+////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	const char* gcodeFileName    = nullptr;
+	const char* timelineFileName = nullptr;
+	bool        printOutput      = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+
+		if (arg[0] != '-')
+		{
+			gcodeFileName = arg;
+			continue;
+		}
+
+		if (arg[1] == 'o')
+		{
+			printOutput = true;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			return Usage();
+		}
+
+		const char* value = argv[++i];
+
+		switch (arg[1])
+		{
+			case 't': timelineFileName = value;
+				break;
+			case 's': Control.StepsPerMm = float(atof(value));
+				break;
+			case 'r': Control.MaxStepRate = steprate_t(atol(value));
+				break;
+			case 'a': Control.Acc = steprate_t(atol(value));
+				break;
+			case 'd': Control.Dec = steprate_t(atol(value));
+				break;
+			case 'j': Control.JerkSpeed = steprate_t(atol(value));
+				break;
+			case 'k': Control.RampJerk = uint32_t(atol(value));
+				break;
+			default: return Usage();
+		}
+	}
+
+	if (gcodeFileName == nullptr)
+	{
+		return Usage();
+	}
+
+	FILE* gcode = fopen(gcodeFileName, "rt");
+	if (gcode == nullptr)
+	{
+		fprintf(stderr, "cannot open %s\n", gcodeFileName);
+		return 2;
+	}
+
+	FILE* timeline = nullptr;
+	if (timelineFileName != nullptr)
+	{
+		timeline = fopen(timelineFileName, "wt");
+		if (timeline == nullptr)
+		{
+			fprintf(stderr, "cannot create %s\n", timelineFileName);
+			fclose(gcode);
+			return 2;
+		}
+	}
+
+	Stepper.SetTimelineFile(timeline);
+
+	auto start = std::chrono::steady_clock::now();
+
+	bool ok = Control.Simulate(gcode, printOutput ? &StepperSerial : nullptr);
+
+	std::chrono::duration<double> cpuTime = std::chrono::steady_clock::now() - start;
+
+	fclose(gcode);
+	if (timeline != nullptr)
+	{
+		fclose(timeline);
+	}
+
+	double machiningTime = Stepper.GetMachiningTime();
+
+	printf("lines:          %u\n", static_cast<unsigned int>(Control.GetLineCount()));
+	printf("errors:         %u\n", static_cast<unsigned int>(Control.GetErrorCount()));
+	printf("machining time: %.3f s\n", machiningTime);
+	printf("steps:          %llu\n", static_cast<unsigned long long>(Stepper.GetStepCount()));
+	printf("steps/sec:      %.0f\n", machiningTime > 0 ? double(Stepper.GetStepCount()) / machiningTime : 0.0);
+	printf("ISR:            %llu\n", static_cast<unsigned long long>(Stepper.GetISRCount()));
+	printf("ISR busy:       %u\n", Stepper.GetTimerISRBuys());
+	printf("planner cpu:    %.3f s\n", Stepper.GetPlannerCPUTime());
+	printf("ISR cpu:        %.3f s\n", Stepper.GetISRCPUTime());
+	printf("total cpu:      %.3f s\n", cpuTime.count());
+
+	return ok && Control.GetErrorCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#include "stdafx.h"
+
+#include <CutterRadiusCompensation.h>
+
+#include "CppUnitTest.h"
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	TEST_CLASS(CCutterRadiusCompensationTest)
+	{
+	public:
+
+		class CRecordCutterRadiusCompensation : public CCutterRadiusCompensation
+		{
+		public:
+
+			struct SMove
+			{
+				mm1000_t To[NUM_AXIS];
+				mm1000_t Offset0;
+				mm1000_t Offset1;
+				bool     IsArc;
+				bool     IsClockwise;
+			};
+
+			SMove   Moves[16];
+			uint8_t MoveCount = 0;
+
+		protected:
+
+			virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t) override
+			{
+				SMove& move = Moves[MoveCount++];
+				memcpy(move.To, to, sizeof(move.To));
+				move.IsArc = false;
+			}
+
+			virtual void MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, bool isClockwise, feedrate_t) override
+			{
+				SMove& move = Moves[MoveCount++];
+				memcpy(move.To, to, sizeof(move.To));
+				move.Offset0     = offset0;
+				move.Offset1     = offset1;
+				move.IsArc       = true;
+				move.IsClockwise = isClockwise;
+			}
+		};
+
+		static void Line(CCutterRadiusCompensation& crc, mm1000_t x, mm1000_t y, mm1000_t z = 0)
+		{
+			mm1000_t to[NUM_AXIS] = { 0 };
+			to[X_AXIS] = x;
+			to[Y_AXIS] = y;
+			to[Z_AXIS] = z;
+			crc.Line(to, 1000);
+		}
+
+		static void AssertMove(const CRecordCutterRadiusCompensation::SMove& move, mm1000_t x, mm1000_t y, mm1000_t z = 0)
+		{
+			Assert::IsFalse(move.IsArc);
+			Assert::AreEqual(long(x), long(move.To[X_AXIS]));
+			Assert::AreEqual(long(y), long(move.To[Y_AXIS]));
+			Assert::AreEqual(long(z), long(move.To[Z_AXIS]));
+		}
+
+		TEST_METHOD(CutterRadiusInsideCornerTest)
+		{
+			// G41 (left), counterclockwise square => all corners inside
+
+			CRecordCutterRadiusCompensation crc;
+			mm1000_t                        current[NUM_AXIS] = { 10000, 10000 };
+			crc.Init(1000, X_AXIS, Y_AXIS, current);
+
+			Line(crc, 20000, 10000);
+			Assert::AreEqual(uint8_t(0), crc.MoveCount);		// held back
+
+			Line(crc, 20000, 20000);
+			Line(crc, 10000, 20000);
+			Line(crc, 10000, 10000);
+			crc.Flush();
+
+			Assert::AreEqual(uint8_t(4), crc.MoveCount);
+			AssertMove(crc.Moves[0], 19000, 11000);
+			AssertMove(crc.Moves[1], 19000, 19000);
+			AssertMove(crc.Moves[2], 11000, 19000);
+			AssertMove(crc.Moves[3], 11000, 10000);
+		}
+
+		TEST_METHOD(CutterRadiusOutsideCornerTest)
+		{
+			// G41 (left), turn right => outside corner, arc around the programmed corner
+
+			CRecordCutterRadiusCompensation crc;
+			mm1000_t                        current[NUM_AXIS] = { 0 };
+			crc.Init(1000, X_AXIS, Y_AXIS, current);
+
+			Line(crc, 10000, 0);
+			Line(crc, 10000, -10000);
+			crc.Flush();
+
+			Assert::AreEqual(uint8_t(3), crc.MoveCount);
+			AssertMove(crc.Moves[0], 10000, 1000);
+
+			Assert::IsTrue(crc.Moves[1].IsArc);
+			Assert::IsTrue(crc.Moves[1].IsClockwise);
+			Assert::AreEqual(long(11000), long(crc.Moves[1].To[X_AXIS]));
+			Assert::AreEqual(long(0), long(crc.Moves[1].To[Y_AXIS]));
+			Assert::AreEqual(long(0), long(crc.Moves[1].Offset0));
+			Assert::AreEqual(long(-1000), long(crc.Moves[1].Offset1));
+
+			AssertMove(crc.Moves[2], 11000, -10000);
+		}
+
+		TEST_METHOD(CutterRadiusQueueTest)
+		{
+			// z move is queued behind the held back segment and moved at the compensated corner
+
+			CRecordCutterRadiusCompensation crc;
+			mm1000_t                        current[NUM_AXIS] = { 0 };
+			crc.Init(-1000, X_AXIS, Y_AXIS, current);
+
+			Line(crc, 10000, 0);
+			Line(crc, 10000, 0, 5000);
+			Assert::AreEqual(uint8_t(0), crc.MoveCount);
+			Assert::AreEqual(uint8_t(2), crc.GetQueueCount());
+
+			Line(crc, 10000, 10000, 5000);
+			crc.Flush();
+
+			// G42 (right), turn left => outside corner
+
+			Assert::AreEqual(uint8_t(4), crc.MoveCount);
+			AssertMove(crc.Moves[0], 10000, -1000);
+			AssertMove(crc.Moves[1], 10000, -1000, 5000);
+			Assert::IsTrue(crc.Moves[2].IsArc);
+			Assert::IsFalse(crc.Moves[2].IsClockwise);
+			Assert::AreEqual(long(11000), long(crc.Moves[2].To[X_AXIS]));
+			AssertMove(crc.Moves[3], 11000, 10000, 5000);
+		}
+
+		static uint8_t& CommandMoveCount()
+		{
+			static uint8_t moveCount;		// MoveCount when the command is called
+			return moveCount;
+		}
+
+		static CRecordCutterRadiusCompensation*& CommandCrc()
+		{
+			static CRecordCutterRadiusCompensation* crc;
+			return crc;
+		}
+
+		TEST_METHOD(CutterRadiusCommandTest)
+		{
+			// command (e.g. io) is queued behind the held back segment, called at the compensated inside corner
+
+			CRecordCutterRadiusCompensation crc;
+			mm1000_t                        current[NUM_AXIS] = { 0 };
+			crc.Init(1000, X_AXIS, Y_AXIS, current);
+
+			CommandCrc()       = &crc;
+			CommandMoveCount() = 0xff;
+
+			Line(crc, 10000, 0);
+			crc.Command([](uint32_t param0, uint32_t param1)
+			{
+				Assert::AreEqual(1l, long(param0));
+				Assert::AreEqual(2l, long(param1));
+				CommandMoveCount() = CommandCrc()->MoveCount;
+			}, 1, 2);
+
+			Assert::AreEqual(uint8_t(0xff), CommandMoveCount());
+			Assert::AreEqual(uint8_t(2), crc.GetQueueCount());
+
+			Line(crc, 10000, 10000);
+
+			Assert::AreEqual(uint8_t(1), CommandMoveCount());
+			AssertMove(crc.Moves[0], 9000, 1000);
+
+			// plane changed => flush, same plane => no flush
+
+			crc.SetPlane(X_AXIS, Y_AXIS);
+			Assert::AreEqual(uint8_t(1), crc.MoveCount);
+
+			crc.SetPlane(X_AXIS, Z_AXIS);
+			Assert::AreEqual(uint8_t(2), crc.MoveCount);
+			AssertMove(crc.Moves[1], 9000, 10000);
+			Assert::AreEqual(uint8_t(0), crc.GetQueueCount());
+		}
+
+		TEST_METHOD(CutterRadiusArcTest)
+		{
+			CRecordCutterRadiusCompensation crc;
+			mm1000_t                        current[NUM_AXIS] = { 0 };
+			mm1000_t                        to[NUM_AXIS]      = { 1000, 0 };
+
+			// G42 (right), clockwise arc with radius 500 => tool inside arc, too big
+
+			crc.Init(-1000, X_AXIS, Y_AXIS, current);
+			Assert::IsFalse(crc.Arc(to, 500, 0, true, 1000));
+
+			// G41 (left), same arc => tool outside arc, radius 1500
+
+			crc.Init(1000, X_AXIS, Y_AXIS, current);
+			Assert::IsTrue(crc.Arc(to, 500, 0, true, 1000));
+			crc.Flush();
+
+			Assert::AreEqual(uint8_t(2), crc.MoveCount);
+			AssertMove(crc.Moves[0], -1000, 0);				// entry to start of offset arc
+			Assert::IsTrue(crc.Moves[1].IsArc);
+			Assert::AreEqual(long(2000), long(crc.Moves[1].To[X_AXIS]));
+			Assert::AreEqual(long(0), long(crc.Moves[1].To[Y_AXIS]));
+			Assert::AreEqual(long(1500), long(crc.Moves[1].Offset0));
+			Assert::AreEqual(long(0), long(crc.Moves[1].Offset1));
+		}
+	};
+}
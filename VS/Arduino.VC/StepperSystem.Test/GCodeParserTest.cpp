@@ -0,0 +1,304 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "stdafx.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <Control.h>
+#include <MotionControlBase.h>
+#include <GCodeParser.h>
+
+#include "CppUnitTest.h"
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	TEST_CLASS(CGCodeParserTest)
+	{
+	public:
+
+		class CTestControl : public CControl
+		{
+		public:
+			virtual bool IsKill() override { return false; }
+		};
+
+		CMsvcStepper       Stepper;
+		CTestControl       Control;
+		CMotionControlBase MotionControl;
+		CGCodeTools        Tools;
+
+		struct SIoEvent
+		{
+			uint8_t  Tool;
+			uint16_t Level;
+			long     Position;
+		};
+
+		SIoEvent IoEvents[16];
+		int      IoEventCount = 0;
+
+		static bool IoEvent(CStepper* stepper, uintptr_t param, EnumAsByte(CStepper::EStepperEvent) eventType, uintptr_t addInfo)
+		{
+			auto test = reinterpret_cast<CGCodeParserTest*>(param);
+			if (eventType == CStepper::OnIoEvent && test->IoEventCount < 16)
+			{
+				auto io = reinterpret_cast<CStepper::SIoControl*>(addInfo);
+
+				test->IoEvents[test->IoEventCount++] = { io->_tool, io->_level, long(stepper->GetCurrentPosition(X_AXIS)) };
+			}
+			return true;
+		}
+
+		void AssertIoEvent(int idx, uint8_t tool, uint16_t level, long position)
+		{
+			Assert::AreEqual(int(tool), int(IoEvents[idx].Tool));
+			Assert::AreEqual(int(level), int(IoEvents[idx].Level));
+
+			// called when the step buffer is synchronized (SYNC_STEPBUFFERCOUNT steps before the position, in move direction)
+			Assert::IsTrue(IoEvents[idx].Position <= position + SYNC_STEPBUFFERCOUNT && IoEvents[idx].Position >= position - SYNC_STEPBUFFERCOUNT);
+		}
+
+		void Init()
+		{
+			Stepper.InitTest();
+			Stepper.UseSpeedSign = true;
+			Stepper.SetWaitFinishMove(false);
+
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+			{
+				Stepper.SetLimitMax(x, 0x100000);
+			}
+
+			MotionControl.InitConversion(
+				[](axis_t, sdist_t  val) { return mm1000_t(val); },
+				[](axis_t, mm1000_t val) { return sdist_t(val); }
+			);
+			MotionControl.SetPositionFromMachine();
+
+			CGCodeParser::Init();
+
+			CStepper::SEvent oldEvent;
+			Stepper.AddEvent(IoEvent, uintptr_t(this), oldEvent);
+		}
+
+		char        Buffer[SERIALBUFFERSIZE];
+		const char* ErrorLine = nullptr;
+
+		cncerror_t Parse(const char* line)
+		{
+			// the reader changes the line temporarily (see CStreamReader::CSetTemporary) => no literal
+			memcpy(Buffer, line, strlen(line) + 1);
+
+			CStreamReader reader;
+			CGCodeParser  parser(&reader, &Serial);
+
+			reader.Init(Buffer);
+			parser.ParseCommand();
+			ErrorLine = parser.GetErrorLine();
+			return parser.GetError();
+		}
+
+		TEST_METHOD(M170BytePerPixelTest)
+		{
+			Init();
+
+			Assert::IsNull(Parse("M3 S255"));
+			Assert::AreEqual(1, IoEventCount);
+
+			// power: 0 0 255 255 128
+			Assert::IsNull(Parse("M170 P0.1 F600 BAAD//4A="));
+
+			// off with the next move (a following M170 replaces it), WaitBusy queues it
+			Assert::IsTrue(Stepper.IsMoveIoPending());
+
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(500l, long(Stepper.GetCurrentPosition(X_AXIS)));
+
+			Assert::AreEqual(5, IoEventCount);
+			AssertIoEvent(0, CControl::SpindleCW, 255, 0);
+			AssertIoEvent(1, CControl::SpindleCW, 0, 0);
+			AssertIoEvent(2, CControl::SpindleCW, 255, 200);
+			AssertIoEvent(3, CControl::SpindleCW, 128, 400);
+			AssertIoEvent(4, CControl::SpindleCW, 0, 500);
+		}
+
+		TEST_METHOD(M170RunLengthTest)
+		{
+			Init();
+
+			Assert::IsNull(Parse("M3 S100"));
+			Assert::IsNull(Parse("G0 X1"));
+
+			// count,power: 2,0 3,255 in -X direction, power is scaled with S
+			Assert::IsNull(Parse("M170 P-0.1 F600 RAgAD/w=="));
+			Assert::IsTrue(Stepper.IsMoveIoPending());
+
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(500l, long(Stepper.GetCurrentPosition(X_AXIS)));
+
+			Assert::AreEqual(4, IoEventCount);
+			AssertIoEvent(0, CControl::SpindleCW, 100, 0);
+			AssertIoEvent(1, CControl::SpindleCW, 0, 1000);
+			AssertIoEvent(2, CControl::SpindleCW, 100, 800);
+			AssertIoEvent(3, CControl::SpindleCW, 0, 500);
+		}
+
+		TEST_METHOD(M170ContinueTest)
+		{
+			// a scanline sent with two M170: no off (and no stop) between
+
+			Init();
+
+			Assert::IsNull(Parse("M3 S255"));
+
+			Assert::IsNull(Parse("M170 P0.1 F600 B////"));		// power: 255 255 255
+			Assert::IsNull(Parse("M170 P0.1 F600 B////"));
+
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(600l, long(Stepper.GetCurrentPosition(X_AXIS)));
+
+			Assert::AreEqual(4, IoEventCount);
+			AssertIoEvent(0, CControl::SpindleCW, 255, 0);
+			AssertIoEvent(1, CControl::SpindleCW, 255, 0);
+			AssertIoEvent(2, CControl::SpindleCW, 255, 300);
+			AssertIoEvent(3, CControl::SpindleCW, 0, 600);
+		}
+
+		TEST_METHOD(M170InvalidDataTest)
+		{
+			Init();
+
+			Assert::IsNull(Parse("M3 S255"));
+			Assert::AreEqual(1, IoEventCount);
+
+			Assert::IsNotNull(Parse("M170 F600 BAAD//4A="));		// no pitch
+			Assert::IsNotNull(Parse("M170 P0.1 F600"));				// no data
+			Assert::IsNotNull(Parse("M170 P0.1 F600 B"));			// empty data
+			Assert::IsNotNull(Parse("M170 P0.1 F600 RAgAD"));		// short data: count without power
+			Assert::IsNotNull(Parse("M170 P0.1 F600 RAAA="));		// count 0
+
+			Assert::IsFalse(Stepper.IsMoveIoPending());
+
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(0l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(1, IoEventCount);
+		}
+
+		TEST_METHOD(CutterRadiusNoMotionTest)
+		{
+			// codes without motion (M3, M114) do not end the held back segment => inside corner
+
+			Init();
+
+			Assert::IsNull(Parse("G0 X20 Y20"));
+			Assert::IsNull(Parse("G41 D1"));			// radius 0.1mm
+			Assert::IsNull(Parse("G1 X50 Y20 F600"));
+			Assert::IsNull(Parse("M3 S100"));
+			Assert::IsNull(Parse("M114"));
+			Assert::AreEqual(0, IoEventCount);			// queued behind the held back segment
+			Assert::IsNull(Parse("G1 X50 Y50"));
+
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(49900l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(20100l, long(Stepper.GetCurrentPosition(Y_AXIS)));
+
+			Assert::AreEqual(1, IoEventCount);
+			AssertIoEvent(0, CControl::SpindleCW, 100, 49900);
+
+			// coordinate system must not change
+			Assert::IsNotNull(Parse("G92 X0"));
+
+			Assert::IsNull(Parse("G40"));
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(49900l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(50000l, long(Stepper.GetCurrentPosition(Y_AXIS)));
+		}
+
+		TEST_METHOD(CutterRadiusPlaneTest)
+		{
+			// G18 ends the held back segment, continue in the XZ plane
+
+			Init();
+
+			Assert::IsNull(Parse("G41 D1"));
+			Assert::IsNull(Parse("G1 X10 F600"));
+			Assert::IsNull(Parse("G18"));
+
+			Stepper.WaitBusy();
+			Assert::AreEqual(10000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(100l, long(Stepper.GetCurrentPosition(Y_AXIS)));
+
+			Assert::IsNull(Parse("G1 X20"));
+			Assert::IsNull(Parse("G40"));
+			Stepper.WaitBusy();
+
+			// plane X,Z: Y is programmed (no offset), offset in Z
+			Assert::AreEqual(20000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(0l, long(Stepper.GetCurrentPosition(Y_AXIS)));
+			Assert::AreEqual(100l, long(Stepper.GetCurrentPosition(Z_AXIS)));
+		}
+
+		TEST_METHOD(OWordCallArgumentTest)
+		{
+			// #1 of the caller is restored after a nested call
+
+			Init();
+
+			Assert::IsNull(Parse("o10 sub"));
+			Assert::IsNull(Parse("#10 = [#1]"));
+			Assert::IsNull(Parse("o10 endsub"));
+
+			Assert::IsNull(Parse("o20 sub"));
+			Assert::IsNull(Parse("o10 call [#1 + 1]"));
+			Assert::IsNull(Parse("#20 = [#1]"));
+			Assert::IsNull(Parse("o20 endsub"));
+
+			Assert::IsNull(Parse("#1 = 7"));
+			Assert::IsNull(Parse("o20 call [2]"));
+
+			Assert::IsNull(Parse("G0 X[#10] Y[#20] Z[#1]"));
+			Stepper.WaitBusy();
+
+			Assert::AreEqual(3000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+			Assert::AreEqual(2000l, long(Stepper.GetCurrentPosition(Y_AXIS)));
+			Assert::AreEqual(7000l, long(Stepper.GetCurrentPosition(Z_AXIS)));
+		}
+
+		TEST_METHOD(OWordErrorLineTest)
+		{
+			// the error is reported with the line of the condition, not with the line closing the block
+
+			Init();
+
+			Assert::IsNull(Parse("o100 while [#1 < ]"));
+			Assert::IsNull(Parse("#1 = [#1 + 1]"));
+			Assert::IsNotNull(Parse("o100 endwhile"));
+
+			Assert::IsNotNull(ErrorLine);
+			Assert::AreEqual("o100 while [#1 < ]", ErrorLine);
+		}
+	};
+}
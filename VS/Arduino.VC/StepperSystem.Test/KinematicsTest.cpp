@@ -0,0 +1,174 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	TEST_CLASS(CKinematicsTest)
+	{
+	public:
+		CMsvcStepper Stepper;
+
+		class CSplitMotionControl : public CMotionControlBase
+		{
+		public:
+			mutable uint16_t Segments = 0;
+
+		protected:
+			virtual steprate_t GetStepRate(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], feedrate_t feedrate) const override
+			{
+				Segments++;
+				return CMotionControlBase::GetStepRate(to, to_m, feedrate);
+			}
+		};
+
+		static void AssertRoundTrip(const CKinematics& kinematics, mm1000_t x, mm1000_t y, mm1000_t z, mm1000_t maxDiff)
+		{
+			mm1000_t pos[NUM_AXIS]   = { x, y, z };
+			mm1000_t joint[NUM_AXIS] = { 0 };
+			mm1000_t back[NUM_AXIS]  = { 0 };
+
+			Assert::IsTrue(kinematics.ToJoint(pos, joint));
+			kinematics.FromJoint(joint, back);
+
+			for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+			{
+				Assert::IsTrue(abs(pos[i] - back[i]) <= maxDiff);
+			}
+		}
+
+		TEST_METHOD(DeltaKinematicsTest)
+		{
+			CDeltaKinematics delta(250000, 120000);
+
+			mm1000_t pos[NUM_AXIS]   = { 0 };
+			mm1000_t joint[NUM_AXIS] = { 0 };
+
+			Assert::IsTrue(delta.ToJoint(pos, joint));
+			Assert::IsTrue(abs(joint[X_AXIS] - 219317) <= 1);		// sqrt(250^2 - 120^2)
+			Assert::IsTrue(abs(joint[Y_AXIS] - 219317) <= 1);
+			Assert::IsTrue(abs(joint[Z_AXIS] - 219317) <= 1);
+
+			AssertRoundTrip(delta, 0, 0, 0, 2);
+			AssertRoundTrip(delta, 50000, 30000, -20000, 2);
+			AssertRoundTrip(delta, -80000, 60000, 10000, 2);
+			AssertRoundTrip(delta, 10000, -90000, 100000, 2);
+
+			pos[X_AXIS] = 400000;
+			Assert::IsFalse(delta.ToJoint(pos, joint));
+		}
+
+		TEST_METHOD(ScaraKinematicsTest)
+		{
+			CScaraKinematics scara(200000, 150000);
+
+			mm1000_t pos[NUM_AXIS]   = { 200000, 150000, 5000 };
+			mm1000_t joint[NUM_AXIS] = { 0 };
+
+			Assert::IsTrue(scara.ToJoint(pos, joint));
+			Assert::IsTrue(abs(joint[X_AXIS] - 0) <= 1);			// arm 1 along X
+			Assert::IsTrue(abs(joint[Y_AXIS] - 90000) <= 1);		// arm 2 along Y
+			Assert::AreEqual(long(5000), long(joint[Z_AXIS]));
+
+			// resolution of joint is 1/1000 degree => 6 mm1000 at 350mm
+
+			AssertRoundTrip(scara, 200000, 150000, 0, 10);
+			AssertRoundTrip(scara, -100000, 250000, 0, 10);
+			AssertRoundTrip(scara, 60000, -120000, 1000, 10);
+
+			pos[X_AXIS] = 400000;
+			pos[Y_AXIS] = 0;
+			Assert::IsFalse(scara.ToJoint(pos, joint));
+		}
+
+		TEST_METHOD(KinematicsSplitTest)
+		{
+			Stepper.InitTest();
+			Stepper.UseSpeedSign = true;
+
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+			{
+				Stepper.SetLimitMax(x, 0x100000);
+			}
+
+			CDeltaKinematics    delta(250000, 120000);
+			CSplitMotionControl mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t  val) { return mm1000_t(val * 10); },
+				[](axis_t, mm1000_t val) { return sdist_t(val / 10); }
+			);
+			mc.SetKinematics(&delta);
+
+			mm1000_t pos[NUM_AXIS]   = { 0 };
+			mm1000_t joint[NUM_AXIS] = { 0 };
+
+			delta.ToJoint(pos, joint);
+			for (axis_t x = 0; x < NUM_AXISXYZ; x++)
+			{
+				Stepper.SetPosition(x, udist_t(joint[x] / 10));
+			}
+			mc.SetPositionFromMachine();
+
+			// split by tolerance
+
+			mm1000_t to1[NUM_AXIS] = { 100000, 50000, -20000 };
+			mc.MoveAbs(to1, 6000 * 60);
+
+			uint16_t segments = mc.Segments;
+			Assert::IsTrue(segments > 1);
+			Assert::IsTrue(segments < 64);
+
+			delta.ToJoint(to1, joint);
+			for (axis_t x = 0; x < NUM_AXISXYZ; x++)
+			{
+				Assert::AreEqual(long(to1[x]), long(mc.GetPosition(x)));
+				Assert::AreEqual(long(joint[x] / 10), long(Stepper.GetPosition(x)));
+			}
+
+			// split by time: 100mm/sec, 10 segments/sec => max 10mm
+
+			mm1000_t to2[NUM_AXIS] = { 0, 50000, -20000 };
+
+			mc.Segments = 0;
+			delta.SetSplit(KINEMATICS_SPLITTOLERANCE, KINEMATICS_SPLITMAXDIST, 10);
+			mc.MoveAbs(to2, 6000 * 1000);
+			Assert::IsTrue(mc.Segments >= 10);			// and split by tolerance
+			Assert::AreEqual(long(0), long(mc.GetPosition(X_AXIS)));
+
+			// 6mm/sec => max 0.6mm: 100mm/0.6mm = 167 segments (not limited by KINEMATICS_SPLITMAXDEPTH)
+
+			mc.Segments = 0;
+			mc.MoveAbs(to1, 6000 * 60);
+			Assert::AreEqual(167, int(mc.Segments));
+
+			delta.ToJoint(to1, joint);
+			for (axis_t x = 0; x < NUM_AXISXYZ; x++)
+			{
+				Assert::AreEqual(long(to1[x]), long(mc.GetPosition(x)));
+				Assert::AreEqual(long(joint[x] / 10), long(Stepper.GetPosition(x)));
+			}
+		}
+	};
+}
@@ -43,6 +43,7 @@ namespace StepperSystemTest
 			Stepper.SetWaitFinishMove(false);
 
 			FeedRateTest();
+			StepRateTest();
 		}
 
 		void FeedRateTest() const
@@ -65,6 +66,38 @@ namespace StepperSystemTest
 			Assert::AreEqual(long(59359), long(mc.CalcFeedRate(to3, feedrate)));
 		}
 
+		void StepRateTest()
+		{
+			CMotionControlBase mc;
+			mc.UnitTest();
+			mc.InitConversion(
+				[](axis_t axis, sdist_t  val) { return axis == Y_AXIS ? mm1000_t(val / 2) : mm1000_t(val); },
+				[](axis_t axis, mm1000_t val) { return axis == Y_AXIS ? sdist_t(val * 2) : sdist_t(val); }
+			);
+
+			mm1000_t to1[NUM_AXIS]   = { 1000, 0, 0 };
+			udist_t  to1_m[NUM_AXIS] = { 1000, 0, 0 };
+			mm1000_t to2[NUM_AXIS]   = { 1000, 1000, 0 };
+			udist_t  to2_m[NUM_AXIS] = { 1000, 2000, 0 };
+
+			Stepper.SetDefaultMaxSpeed(30000);
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+			{
+				Stepper.SetMaxSpeed(x, 30000);
+			}
+
+			feedrate_t feedrate = 1000 * 60;
+
+			Assert::AreEqual(long(1000), long(mc.CalcStepRate(to1, to1_m, feedrate)));
+			Assert::AreEqual(long(2000), long(mc.CalcStepRate(to2, to2_m, feedrate)));			// y is dominant axis (2 steps/mm1000)
+			Assert::AreEqual(long(2000), long(mc.CalcStepRate(to2, to2_m, -feedrate)));
+
+			Stepper.SetMaxSpeed(Y_AXIS, 1500);
+			Assert::AreEqual(long(Stepper.GetMaxSpeed(Y_AXIS)), long(mc.CalcStepRate(to2, to2_m, feedrate)));
+			Assert::AreEqual(long(1000), long(mc.CalcStepRate(to1, to1_m, feedrate)));
+			Stepper.SetMaxSpeed(Y_AXIS, 30000);
+		}
+
 		TEST_METHOD(FeedRateDistOverrunTest)
 		{
 			CMotionControlBase mc;
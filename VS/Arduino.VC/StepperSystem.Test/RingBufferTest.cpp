@@ -86,9 +86,113 @@ namespace StepperSystemTest
 			TestRingBufferInsert(128 - 10, 60, 30);	// buffer overrun
 		}
 
+		TEST_METHOD(RingBufferSPSCTest)
+		{
+			CRingBufferQueueSPSC<SRingBuffer, 8> buffer;
+
+			Assert::AreEqual(true, buffer.IsEmpty());
+
+			for (uint8_t i = 0; i < 8 + 3; i++)
+			{
+				buffer.NextTail().i = i;
+				buffer.Enqueue();
+				buffer.Dequeue();
+			}
+
+			Assert::AreEqual(true, buffer.IsEmpty());
+			Assert::AreEqual(uint8_t(3), buffer.GetHeadPos());
+
+			for (uint8_t i = 0; i < 8; i++)
+			{
+				buffer.NextTail().i = i;
+				buffer.Enqueue();
+			}
+
+			Assert::AreEqual(true, buffer.IsFull());
+			Assert::AreEqual(uint8_t(8), buffer.Count());
+			Assert::AreEqual(uint8_t(2), buffer.GetTailPos());
+			Assert::AreEqual(false, buffer.IsInQueue(RINGBUFFER_NOIDX));
+
+			int expect = 0;
+			for (uint8_t idx = buffer.H2TInit(); buffer.H2TTest(idx); idx = buffer.H2TInc(idx))
+			{
+				Assert::AreEqual(expect++, buffer.Buffer[idx].i);
+			}
+			Assert::AreEqual(8, expect);
+
+			buffer.RemoveTail(buffer.NextIndex(buffer.GetHeadPos(), 1));
+
+			Assert::AreEqual(uint8_t(2), buffer.Count());
+			Assert::AreEqual(false, buffer.IsInQueue(buffer.NextIndex(buffer.GetHeadPos(), 2)));
+
+			buffer.Dequeue();
+			buffer.Dequeue();
+
+			Assert::AreEqual(true, buffer.IsEmpty());
+		}
+
+		TEST_METHOD(RingBufferSPSCInsertTest)
+		{
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingBuffer, 128>>(10, 60, 0);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingBuffer, 128>>(10, 60, 60);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingBuffer, 128>>(10, 60, 59);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingBuffer, 128>>(128 - 10, 60, 30);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingBuffer, 128>>(250, 60, 30);	// counter overrun
+		}
+
+		TEST_METHOD(RingBuffer16BitIndexTest)
+		{
+			CRingBufferQueue<SRingBuffer, 1024, uint16_t>     buffer;
+			CRingBufferQueueSPSC<SRingBuffer, 1024, uint16_t> bufferSPSC;
+
+			for (uint16_t i = 0; i < 1000; i++)
+			{
+				buffer.Enqueue();
+				buffer.Dequeue();
+				bufferSPSC.Enqueue();
+				bufferSPSC.Dequeue();
+			}
+
+			for (uint16_t i = 0; i < 1024; i++)
+			{
+				buffer.NextTail().i = i;
+				buffer.Enqueue();
+				bufferSPSC.NextTail().i = i;
+				bufferSPSC.Enqueue();
+			}
+
+			Assert::AreEqual(true, buffer.IsFull());
+			Assert::AreEqual(uint16_t(1024), buffer.Count());
+			Assert::AreEqual(true, bufferSPSC.IsFull());
+			Assert::AreEqual(uint16_t(1024), bufferSPSC.Count());
+
+			int expect = 0;
+			for (uint16_t idx = buffer.H2TInit(); buffer.H2TTest(idx); idx = buffer.H2TInc(idx))
+			{
+				Assert::AreEqual(expect++, buffer.Buffer[idx].i);
+			}
+			Assert::AreEqual(1024, expect);
+
+			expect = 0;
+			for (uint16_t idx = bufferSPSC.H2TInit(); bufferSPSC.H2TTest(idx); idx = bufferSPSC.H2TInc(idx))
+			{
+				Assert::AreEqual(expect++, bufferSPSC.Buffer[idx].i);
+			}
+			Assert::AreEqual(1024, expect);
+
+			buffer.RemoveTail(buffer.NextIndex(buffer.GetHeadPos(), 299));
+			bufferSPSC.RemoveTail(bufferSPSC.NextIndex(bufferSPSC.GetHeadPos(), 299));
+
+			Assert::AreEqual(uint16_t(300), buffer.Count());
+			Assert::AreEqual(uint16_t(300), bufferSPSC.Count());
+			Assert::AreEqual(299, buffer.Tail().i);
+			Assert::AreEqual(299, bufferSPSC.Tail().i);
+		}
+
+		template <class TRingBuffer = CRingBufferQueue<SRingBuffer, 128>>
 		void TestRingBufferInsert(uint8_t startIdx, uint8_t bufferSize, uint8_t insertOffset) const
 		{
-			CRingBufferQueue<SRingBuffer, 128> buffer;
+			TRingBuffer buffer;
 
 			uint8_t i;
 
@@ -16,8 +16,10 @@
 
 #include "stdafx.h"
 #include "..\MsvcStepper\MsvcStepper.h"
+#include "TestSerial.h"
 
 #pragma warning(disable: 4127)
 
 CSerial         Serial;
-HardwareSerial& StepperSerial = Serial;
+CTestSerial     TestSerial;
+HardwareSerial& StepperSerial = TestSerial;
@@ -694,6 +694,286 @@ namespace StepperSystemTest
 			AssertFile("MergeRampWithIo.csv");
 		}
 
+		struct SMoveIoEvent
+		{
+			uint8_t  Tool;
+			uint16_t Level;
+			long     Position;
+		};
+
+		SMoveIoEvent MoveIoEvents[8];
+		int          MoveIoEventCount = 0;
+
+		static bool MoveIoEvent(CStepper* stepper, uintptr_t param, EnumAsByte(CStepper::EStepperEvent) eventType, uintptr_t addInfo)
+		{
+			auto test = reinterpret_cast<CStepperTest*>(param);
+			if (eventType == CStepper::OnIoEvent && test->MoveIoEventCount < 8)
+			{
+				auto io = reinterpret_cast<CStepper::SIoControl*>(addInfo);
+
+				test->MoveIoEvents[test->MoveIoEventCount++] = { io->_tool, io->_level, long(stepper->GetCurrentPosition(X_AXIS)) };
+			}
+			return true;
+		}
+
+		void AssertMoveIoEvent(int idx, uint8_t tool, uint16_t level, long position)
+		{
+			Assert::AreEqual(int(tool), int(MoveIoEvents[idx].Tool));
+			Assert::AreEqual(int(level), int(MoveIoEvents[idx].Level));
+
+			// called when the step buffer is synchronized (SYNC_STEPBUFFERCOUNT) before the first step of the move
+			Assert::IsTrue(MoveIoEvents[idx].Position <= position && MoveIoEvents[idx].Position >= position - SYNC_STEPBUFFERCOUNT);
+		}
+
+		TEST_METHOD(StepperMoveIo)
+		{
+			// io is part of the next move => no queue entry for io
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+
+			CStepper::SEvent oldEvent;
+			Stepper.AddEvent(MoveIoEvent, uintptr_t(this), oldEvent);
+
+			Stepper.CStepper::MoveIoControl(0, 1);
+			Stepper.CStepper::MoveRel(0, 1000, 1000);
+			Stepper.CStepper::MoveIoControl(0, 0);
+			Stepper.CStepper::MoveRel(0, 2000, 1000);
+			Stepper.CStepper::MoveIoControl(0, 1);
+			Stepper.CStepper::MoveRel(0, 1000, 1000);
+
+			Assert::AreEqual(3, int(Stepper.GetMovementCount()));
+
+			// two io without move => first one is queued as io entry, second one is set by WaitBusy
+			Stepper.CStepper::MoveIoControl(0, 0);
+			Stepper.CStepper::MoveIoControl(1, 0);
+
+			Assert::AreEqual(4, int(Stepper.GetMovementCount()));
+
+			AssertFile("MoveIo.csv");
+
+			Assert::AreEqual(4000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+
+			Assert::AreEqual(5, MoveIoEventCount);
+			AssertMoveIoEvent(0, 0, 1, 0);
+			AssertMoveIoEvent(1, 0, 0, 1000);
+			AssertMoveIoEvent(2, 0, 1, 3000);
+			AssertMoveIoEvent(3, 0, 0, 4000);
+			AssertMoveIoEvent(4, 1, 0, 4000);
+
+			// stepper is idle => no next move, the idle poll queues the io (without WaitBusy)
+			Stepper.CStepper::MoveIoControl(0, 1);
+			Assert::AreEqual(5, MoveIoEventCount);
+			Stepper.MoveIoPoll();
+
+			Assert::AreEqual(6, MoveIoEventCount);
+			AssertMoveIoEvent(5, 0, 1, 4000);
+		}
+
+		TEST_METHOD(StepperOptimizePlanned)
+		{
+			// junction with max speed => optimize touches only the new movement and the previous one
+			Stepper.InitTest();
+			Stepper.DelayOptimization = false;
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+
+			for (int i = 0; i < MOVEMENTBUFFERSIZE * 4; i++)
+			{
+				Stepper.MoveRel3(1000, 0, 0);
+				Assert::IsTrue(Stepper.OptimizeTouchedMovements() <= 3);
+			}
+
+			CreateTestFile("OptimizePlanned.csv");
+		}
+
+		uint32_t MaxStepRateDelta()
+		{
+			// max change of the step rate within 10ms (=> steps/sec^2), one timer tick is too coarse for a single step
+			const uint32_t window   = TIMER1FREQUENCE / 100;
+			int            count    = Stepper.GetTimerEventCount();
+			uint32_t       maxDelta = 0;
+
+			for (int i = 0; i < count; i++)
+			{
+				uint32_t time = 0;
+				int      j    = i;
+				while (time < window && j + 1 < count)
+				{
+					time += Stepper.GetTimerEvent(++j).TimerValues;
+				}
+				if (time < window)
+				{
+					break;
+				}
+
+				uint32_t rate0 = TIMER1FREQUENCE / Stepper.GetTimerEvent(i).TimerValues;
+				uint32_t rate1 = TIMER1FREQUENCE / Stepper.GetTimerEvent(j).TimerValues;
+				uint32_t delta = uint32_t(uint64_t(rate1 > rate0 ? rate1 - rate0 : rate0 - rate1) * TIMER1FREQUENCE / time);
+				maxDelta       = max(maxDelta, delta);
+			}
+			return maxDelta;
+		}
+
+		TEST_METHOD(StepperSCurve)
+		{
+			// S-curve ramp is longer by the jerk phase => acceleration is not above the trapezoid
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.MoveRel3(8000, 0, 0);
+			Stepper.MoveRel3(2000, 0, 0);
+			CreateTestFile("SCurveTrapezoid.csv");
+
+			uint32_t trapezoidDelta = MaxStepRateDelta();
+
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+			{
+				Stepper.SetRampJerk(x, 200000);
+			}
+			Stepper.MoveRel3(8000, 0, 0);
+			Stepper.MoveRel3(2000, 0, 0);
+			CreateTestFile("SCurve.csv");
+
+			uint32_t sCurveDelta = MaxStepRateDelta();
+
+			Assert::IsTrue(trapezoidDelta > 0);
+			Assert::IsTrue(sCurveDelta <= trapezoidDelta);
+			Assert::AreEqual(10000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+		}
+
+		TEST_METHOD(StepperStatus)
+		{
+			// snapshot of StepOut/GoIdle is the same as the current position
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.SetSpeedOverride(CStepper::PToSpeedOverride(50));
+
+			Stepper.MoveRel3(4000, 1000, 0);
+			Stepper.MoveRel3(-2000, 3000, 500);
+			CreateTestFile("Status.csv");
+
+			CStepper::SStatus status;
+			Stepper.GetStatus(status);
+
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+			{
+				Assert::AreEqual(long(Stepper.GetCurrentPosition(x)), long(status.Current[x]));
+			}
+
+			Assert::AreEqual(2000l, long(status.Current[X_AXIS]));
+			Assert::AreEqual(4000l, long(status.Current[Y_AXIS]));
+			Assert::AreEqual(500l, long(status.Current[Z_AXIS]));
+
+			Assert::AreEqual(int(CStepper::StatusIdle), int(status.State));
+			Assert::AreEqual(0l, long(status.GetStepRate()));
+			Assert::AreEqual(0, int(status.MovementCount));
+			Assert::AreEqual(50, int(CStepper::SpeedOverrideToP(status.SpeedOverride)));
+
+			Stepper.SetSpeedOverride(CStepper::SpeedOverride100P);
+		}
+
+		TEST_METHOD(StepperSpeedLevel)
+		{
+			// level of each emitted step: 255 * programmed timer / timer of the step (timer of "count" steps)
+			// set by StepOut => it must not be ahead by the steps in the step buffer
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.SetSpeedEvent(true);
+
+			Stepper.MoveRel3(8000, 0, 0);
+			Stepper.MoveRel3(8000, 8000, 0, 2500);
+			CreateTestFile("SpeedLevel.csv");
+
+			Stepper.SetSpeedEvent(false);
+
+			uint32_t timerRun[2] = { 0xfffffffful, 0xfffffffful };
+
+			for (int i = 0; i < Stepper.GetTimerEventCount(); i++)
+			{
+				const STimerEvent& ev      = Stepper.GetTimerEvent(i);
+				int                move    = ev.Axis[Y_AXIS].MoveAxis != 0 ? 1 : 0;
+				uint32_t           timer   = ev.TimerValues / ev.Axis[X_AXIS].Multiplier;
+				timerRun[move]             = min(timerRun[move], timer);
+			}
+
+			int fullSpeed[2] = { 0, 0 };
+
+			for (int i = 0; i < Stepper.GetTimerEventCount(); i++)
+			{
+				const STimerEvent& ev       = Stepper.GetTimerEvent(i);
+				int                move     = ev.Axis[Y_AXIS].MoveAxis != 0 ? 1 : 0;
+				uint32_t           expected = RoundMulDivU32(timerRun[move] * ev.Axis[X_AXIS].Multiplier, 255, ev.TimerValues);
+
+				Assert::AreEqual(int(min(expected, uint32_t(255))), int(ev.SpeedLevel));
+				if (ev.SpeedLevel == 255)
+				{
+					fullSpeed[move]++;
+				}
+			}
+
+			Assert::IsTrue(Stepper.GetTimerEvent(0).SpeedLevel < 255);
+			Assert::IsTrue(fullSpeed[0] > 0);
+			Assert::IsTrue(fullSpeed[1] > 0);
+			Assert::AreEqual(16000l, long(Stepper.GetCurrentPosition(X_AXIS)));
+		}
+
+		void StreamTraceMoves()
+		{
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.MoveRel3(4000, 1000, 0);
+			Stepper.MoveRel3(-2000, 3000, 500);
+			Stepper.MoveRel3(0, 0, 10);
+		}
+
+		TEST_METHOD(StepperStreamTrace)
+		{
+			// binary trace converted to csv must be the same as the csv written by WriteTestResults
+			char csvFile[_MAX_PATH];
+			char traceFile[_MAX_PATH];
+			char convertedFile[_MAX_PATH];
+
+			AddFileName(csvFile, TestResultDir, "StreamTrace.csv");
+			AddFileName(traceFile, TestResultDir, "StreamTrace.bin");
+			AddFileName(convertedFile, TestResultDir, "StreamTraceConverted.csv");
+
+			Stepper.InitTest(csvFile);
+			StreamTraceMoves();
+			Stepper.EndTest();
+
+			Stepper.StreamTrace = true;
+			Stepper.InitTest(traceFile);
+			StreamTraceMoves();
+			Stepper.EndTest();
+			Stepper.StreamTrace = false;
+
+			Assert::IsTrue(CMsvcStepper::ConvertTraceToCsv(traceFile, convertedFile, true));
+
+			FILE* fcsv;
+			FILE* fconverted;
+
+			fopen_s(&fcsv, csvFile, "rt");
+			fopen_s(&fconverted, convertedFile, "rt");
+
+			Assert::IsTrue(fcsv != nullptr);
+			Assert::IsTrue(fconverted != nullptr);
+
+			char linecsv[512];
+			char lineconverted[512];
+			int  lines = 0;
+
+			while (fgets(linecsv, sizeof(linecsv), fcsv))
+			{
+				Assert::IsTrue(fgets(lineconverted, sizeof(lineconverted), fconverted) != nullptr);
+				Assert::AreEqual(linecsv, lineconverted);
+				lines++;
+			}
+			Assert::IsTrue(fgets(lineconverted, sizeof(lineconverted), fconverted) == nullptr);
+			Assert::IsTrue(lines > 0);
+
+			fclose(fcsv);
+			fclose(fconverted);
+		}
+
 		void TestFile()
 		{
 			Stepper.InitTest();
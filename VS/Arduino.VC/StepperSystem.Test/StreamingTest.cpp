@@ -0,0 +1,245 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "stdafx.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <Control.h>
+#include <MotionControlBase.h>
+#include <GCodeParser.h>
+
+#include "TestSerial.h"
+
+#include "CppUnitTest.h"
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	////////////////////////////////////////////////////////
+	// CControl reads a simulated serial link (115200 baud), time unit is the transfer time of one char (87us)
+	// host: "M113 S0" and ping-pong (wait for "ok" after each line) or "M113 S1" and character counting (capacity is the "RX:n" of the M113 "ok")
+
+	class CStreamingControl : public CControl
+	{
+	private:
+
+		typedef CControl super;
+
+	public:
+
+		enum
+		{
+			CharTimeUs  = 87,
+			HostLatency = 12,		// ~1ms: "ok" received => next line sent by host
+			ExecuteTime = 3,		// ~250us: parse and queue one line
+			OkQueueSize = SERIALRXBUFFERSIZE		// max "ok" on the way
+		};
+
+		uint32_t Simulate(bool charCounting, const char* line, uint32_t lines)
+		{
+			const uint32_t lineLength = uint32_t(strlen(line));
+			char           m113[]     = "M113 S0\n";
+			m113[6]                   = charCounting ? '1' : '0';
+
+			TestSerial.SetReceive(true);
+
+			_time       = 0;
+			_txFreeTime = 0;
+			_okHead     = _okTail = 0;
+			_consumed   = 0;
+			_sent       = 0;
+			_errorCount = 0;
+
+			uint32_t    sentLines      = 0;		// lines sent by host (without M113)
+			uint32_t    acknowledged   = 0;		// "ok" received by host
+			uint32_t    unacknowledged = 0;		// chars sent by host without "ok" (character counting)
+			uint32_t    capacity       = 0;		// "RX:n" of M113
+			uint32_t    busyUntil      = 0;
+			const char* send           = m113;
+
+			while (acknowledged < lines + 1)
+			{
+				// host
+
+				while (_okHead != _okTail && _ok[_okHead % OkQueueSize].Arrive <= _time)
+				{
+					if (acknowledged == 0)
+					{
+						capacity = _ok[_okHead % OkQueueSize].RxFree;
+					}
+					else
+					{
+						unacknowledged -= lineLength;
+					}
+					_okHead++;
+					acknowledged++;
+				}
+
+				if (send == nullptr && acknowledged > 0 && sentLines < lines)
+				{
+					bool canSend = charCounting ? unacknowledged + lineLength <= capacity : sentLines + 1 == acknowledged;
+					if (canSend)
+					{
+						sentLines++;
+						send = line;
+						unacknowledged += lineLength;
+					}
+				}
+
+				if (send != nullptr)
+				{
+					// one char per time unit
+					Assert::IsTrue(TestSerial.Receive(*send));
+					_sent++;
+					if (*++send == 0)
+					{
+						send = nullptr;
+					}
+				}
+
+				// controller: received chars stay in the serial hardware buffer while a line is executed
+
+				if (_time >= busyUntil)
+				{
+					uint32_t okTail = _okTail;
+					SerialReadAndExecuteCommand();
+					if (okTail != _okTail)
+					{
+						busyUntil = _time + ExecuteTime;
+					}
+				}
+
+				_time++;
+			}
+
+			TestSerial.SetReceive(false);
+			SetCharCounting(false);
+
+			// M113 S1: the empty receive buffer without headroom
+			Assert::AreEqual(uint32_t(0), _errorCount);
+			Assert::AreEqual(charCounting ? uint32_t(SERIALRXBUFFERSIZE - SERIALRXHEADROOM) : uint32_t(0), capacity);
+
+			return _time;
+		}
+
+		static uint32_t LinesPerSec(uint32_t lines, uint32_t time)
+		{
+			return uint32_t(uint64_t(lines) * 1000000 / (uint64_t(time) * CharTimeUs));
+		}
+
+	protected:
+
+		virtual bool IsKill() override { return false; }
+
+		virtual bool Command(char* buffer, Stream* output) override
+		{
+			_consumed += uint32_t(strlen(buffer)) + 1;
+
+			if (!super::Command(buffer, output))
+			{
+				_errorCount++;
+			}
+
+			// super::Command printed "ok" or "ok RX:n" (see PrintRxFree), the free bytes are unchanged until the next FillRxBuffer
+			// all chars sent by the host and not executed are in the serial hardware buffer or in the receive buffer
+
+			uint16_t rxFree   = 0;
+			uint32_t okLength = 3;		// "ok\n"
+
+			if (IsCharCounting())
+			{
+				rxFree = GetRxFree();
+				Assert::AreEqual(uint32_t(SERIALRXBUFFERSIZE - SERIALRXHEADROOM), rxFree + _sent - _consumed);
+
+				char ok[16];
+				okLength = uint32_t(sprintf_s(ok, "ok RX:%u\n", unsigned(rxFree)));
+			}
+
+			// the "ok" is sent when the line is executed
+			uint32_t okStart = max(_time + ExecuteTime, _txFreeTime);
+			_txFreeTime      = okStart + okLength;
+
+			Assert::IsTrue(_okTail - _okHead < OkQueueSize);
+			_ok[_okTail++ % OkQueueSize] = { _txFreeTime + HostLatency, rxFree };
+
+			return true;
+		}
+
+	private:
+
+		struct SOk
+		{
+			uint32_t Arrive;		// at host (incl. latency)
+			uint16_t RxFree;
+		};
+
+		SOk      _ok[OkQueueSize];		// FIFO
+		uint32_t _okHead     = 0;
+		uint32_t _okTail     = 0;
+		uint32_t _time       = 0;
+		uint32_t _txFreeTime = 0;		// controller => host link is free
+		uint32_t _sent       = 0;		// chars sent by host
+		uint32_t _consumed   = 0;		// chars of executed lines
+		uint32_t _errorCount = 0;
+	};
+
+	////////////////////////////////////////////////////////
+
+	TEST_CLASS(CStreamingTest)
+	{
+	public:
+
+		CMsvcStepper       Stepper;
+		CStreamingControl  Control;
+		CMotionControlBase MotionControl;
+
+		void Init()
+		{
+			Stepper.InitTest();
+
+			MotionControl.InitConversion(
+				[](axis_t, sdist_t  val) { return mm1000_t(val); },
+				[](axis_t, mm1000_t val) { return sdist_t(val); }
+			);
+			MotionControl.SetPositionFromMachine();
+
+			CGCodeParser::Init();
+		}
+
+		TEST_METHOD(StreamingLinesPerSecTest)
+		{
+			Init();
+
+			const uint32_t lines = 1000;
+			const char*    line  = "G90 G21 G17 (plane)\n";		// 20 chars, parsed but no move
+
+			uint32_t pingPongLinesPerSec     = CStreamingControl::LinesPerSec(lines, Control.Simulate(false, line, lines));
+			uint32_t charCountingLinesPerSec = CStreamingControl::LinesPerSec(lines, Control.Simulate(true, line, lines));
+
+			char msg[128];
+			sprintf_s(msg, "lines/sec: ping-pong=%u, character counting=%u\n", pingPongLinesPerSec, charCountingLinesPerSec);
+			Logger::WriteMessage(msg);
+
+			// max is 11520/20 = 576 lines/sec (serial link is the limit)
+
+			Assert::IsTrue(charCountingLinesPerSec > 550);
+			Assert::IsTrue(charCountingLinesPerSec > pingPongLinesPerSec * 3 / 2);
+		}
+	};
+}
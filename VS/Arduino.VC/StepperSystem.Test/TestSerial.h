@@ -0,0 +1,79 @@
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) Herbert Aitenbichler
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+  to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+  and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <RingBuffer.h>
+
+////////////////////////////////////////////////////////////
+// StepperSerial of the tests
+// default: read from stdin (see Stream), after SetReceive(true) the chars are passed by the test (e.g. a simulated host, see StreamingTest)
+
+class CTestSerial : public HardwareSerial
+{
+private:
+
+	typedef HardwareSerial super;
+
+public:
+
+	enum
+	{
+		HardwareBufferSize = 64			// receive buffer of the serial hardware (AVR)
+	};
+
+	void SetReceive(bool receive)
+	{
+		_receive = receive;
+		_rxBuffer.Clear();
+	}
+
+	bool Receive(char ch)
+	{
+		if (_rxBuffer.IsFull())
+		{
+			return false;				// overrun, char is lost
+		}
+		_rxBuffer.Enqueue(ch);
+		return true;
+	}
+
+	virtual int available() override
+	{
+		return _receive ? int(_rxBuffer.Count()) : super::available();
+	}
+
+	virtual char read() override
+	{
+		if (!_receive)
+		{
+			return super::read();
+		}
+
+		char ch = _rxBuffer.Head();
+		_rxBuffer.Dequeue();
+		return ch;
+	}
+
+private:
+
+	bool _receive = false;
+
+	CRingBufferQueueSPSC<char, HardwareBufferSize, uint8_t> _rxBuffer;
+};
+
+extern CTestSerial TestSerial;